@@ -7,6 +7,9 @@ const terser = require('gulp-terser');
 const jsonminify = require('gulp-jsonminify');
 const htmlmin = require('gulp-html-minifier-terser');
 const replace = require('gulp-replace');
+const fs = require('fs');
+const path = require('path');
+const crypto = require('crypto');
 
 // Paths for tasks
 let paths = {
@@ -60,17 +63,53 @@ let paths = {
   pages: {
     src: 'src_data/pages/*.html',
     dest: 'data/pages/'
+  },
+  manifest: {
+    root: 'data/',
+    dest: 'data/manifest.json'
   }
 };
 
 
+// Helpers
+const streamsDone = (streams) => {
+  return Promise.all(streams.map((stream) => {
+    return new Promise((resolve, reject) => {
+      stream.on('finish', resolve).on('error', reject);
+    });
+  }));
+}
+
+const fileHash = (filePath) => {
+  return crypto.createHash('md5')
+    .update(fs.readFileSync(filePath))
+    .digest('hex')
+    .substring(0, 16);
+}
+
+// hash of the built asset by its url, null if not built
+const assetHash = (uri) => {
+  const filePath = path.join(paths.manifest.root, uri);
+
+  for (const item of [filePath + '.gz', filePath]) {
+    if (fs.existsSync(item)) {
+      return fileHash(item);
+    }
+  }
+
+  return null;
+}
+
+
 
 // Tasks
-const styles = (cb) => {
+const styles = () => {
+  let streams = [];
+
   for (let name in paths.styles.bundles) {
     const items = paths.styles.bundles[name];
 
-    src(items)
+    streams.push(src(items)
       .pipe(replace(
         "{BUILD_TIME}",
         Math.floor(Date.now() / 1000)
@@ -82,17 +121,19 @@ const styles = (cb) => {
       .pipe(gzip({
         append: true
       }))
-      .pipe(dest(paths.styles.dest));
+      .pipe(dest(paths.styles.dest)));
   }
 
-  cb();
+  return streamsDone(streams);
 }
 
-const scripts = (cb) => {
+const scripts = () => {
+  let streams = [];
+
   for (let name in paths.scripts.bundles) {
     const items = paths.scripts.bundles[name];
 
-    src(items)
+    streams.push(src(items)
       .pipe(replace(
         "{BUILD_TIME}",
         Math.floor(Date.now() / 1000)
@@ -102,17 +143,19 @@ const scripts = (cb) => {
       .pipe(gzip({
         append: true
       }))
-      .pipe(dest(paths.scripts.dest));
+      .pipe(dest(paths.scripts.dest)));
   }
 
-  cb();
+  return streamsDone(streams);
 }
 
-const jsonFiles = (cb) => {
+const jsonFiles = () => {
+  let streams = [];
+
   for (let i in paths.json) {
     const item = paths.json[i];
 
-    src(item.src)
+    streams.push(src(item.src)
       .pipe(replace(
         "{BUILD_TIME}",
         Math.floor(Date.now() / 1000)
@@ -121,28 +164,39 @@ const jsonFiles = (cb) => {
       .pipe(gzip({
         append: true
       }))
-      .pipe(dest(item.dest));
+      .pipe(dest(item.dest)));
   }
 
-  cb();
+  return streamsDone(streams);
 }
 
-const staticFiles = (cb) => {
+const staticFiles = () => {
+  let streams = [];
+
   for (let i in paths.static) {
     const item = paths.static[i];
 
-    src(item.src, { encoding: false })
+    streams.push(src(item.src, { encoding: false })
       .pipe(gzip({
         append: true
       }))
-      .pipe(dest(item.dest));
+      .pipe(dest(item.dest)));
   }
 
-  cb();
+  return streamsDone(streams);
 }
 
 const pages = () => {
   return src(paths.pages.src)
+    // versioned urls of the built assets, served with immutable caching
+    .pipe(replace(
+      /(\/static\/[\w.\/-]+)\?\{BUILD_TIME\}/g,
+      (match, uri) => {
+        const hash = assetHash(uri);
+
+        return hash ? `${uri}?v=${hash}` : match;
+      }
+    ))
     .pipe(replace(
       "{BUILD_TIME}",
       Math.floor(Date.now() / 1000)
@@ -162,9 +216,45 @@ const pages = () => {
     .pipe(dest(paths.pages.dest));
 }
 
+// content hashes of everything in data/, loaded by the firmware at startup
+const manifest = (cb) => {
+  let files = {};
+
+  const walk = (dir) => {
+    for (const entry of fs.readdirSync(dir, { withFileTypes: true })) {
+      const fullPath = path.join(dir, entry.name);
+
+      if (entry.isDirectory()) {
+        walk(fullPath);
+        continue;
+
+      } else if (entry.name.startsWith('.') || path.resolve(fullPath) === path.resolve(paths.manifest.dest)) {
+        continue;
+      }
+
+      const isGzip = entry.name.endsWith('.gz');
+      const uri = '/' + path.relative(paths.manifest.root, fullPath)
+        .split(path.sep)
+        .join('/')
+        .replace(/\.gz$/, '');
+
+      files[uri] = {
+        hash: fileHash(fullPath),
+        gzip: isGzip
+      };
+    }
+  }
+
+  walk(paths.manifest.root);
+  fs.writeFileSync(paths.manifest.dest, JSON.stringify(files));
+
+  cb();
+}
+
 exports.build_styles = styles;
 exports.build_scripts = scripts;
 exports.build_json = jsonFiles;
 exports.build_static = staticFiles;
 exports.build_pages = pages;
-exports.build_all = parallel(styles, scripts, jsonFiles, staticFiles, pages);
\ No newline at end of file
+exports.build_manifest = manifest;
+exports.build_all = series(parallel(styles, scripts, jsonFiles, staticFiles), pages, manifest);
\ No newline at end of file
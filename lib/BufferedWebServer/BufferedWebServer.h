@@ -1,6 +1,10 @@
-class BufferedWebServer {
+#include <lwip/opt.h>
+#include "GzipWriter.h"
+
+class BufferedWebServer : public Print {
 public:
-  BufferedWebServer(WebServer* webServer, size_t bufferSize = 64) {
+  // leaves room for the chunk header and trailer, so a full chunk fits into one segment
+  BufferedWebServer(WebServer* webServer, size_t bufferSize = TCP_MSS - 8) {
     this->webServer = webServer;
     this->bufferSize = bufferSize;
     this->buffer = (uint8_t*)malloc(bufferSize * sizeof(*this->buffer));
@@ -10,29 +14,69 @@ public:
     free(this->buffer);
   }
 
+  /**
+   * Serializes the document once, straight into chunked transfer encoding.
+   * With gzip enabled the response is compressed if the client accepts it,
+   * requires "Accept-Encoding" in the collected headers.
+   */
+  template <class T>
+  void send(int code, T contentType, const JsonVariantConst content, bool pretty = false, bool gzip = false) {
+    GzipWriter<BufferedWebServer>* gzipWriter = nullptr;
+    if (gzip && this->webServer->header(F("Accept-Encoding")).indexOf(F("gzip")) != -1) {
+      gzipWriter = new GzipWriter<BufferedWebServer>(this);
+
+      if (!gzipWriter->isValid()) {
+        delete gzipWriter;
+        gzipWriter = nullptr;
+      }
+    }
+
+    if (gzipWriter != nullptr) {
+      this->webServer->sendHeader(F("Content-Encoding"), F("gzip"));
+      this->webServer->sendHeader(F("Vary"), F("Accept-Encoding"));
+    }
+
+    if (!this->begin(code, contentType)) {
+      delete gzipWriter;
+      return;
+    }
+
+    if (gzipWriter != nullptr) {
+      gzipWriter->begin();
+      this->serialize(content, *gzipWriter, pretty);
+      gzipWriter->end();
+
+      delete gzipWriter;
+
+    } else {
+      this->serialize(content, *this, pretty);
+    }
+
+    this->end();
+  }
+
+  /**
+   * Starts a chunked response, the content is written through print()/write().
+   * Must be completed with end().
+   */
   template <class T>
-  void send(int code, T contentType, const JsonVariantConst content, bool pretty = false) {
-    auto contentLength = pretty ? measureJsonPretty(content) : measureJson(content);
+  bool begin(int code, T contentType) {
+    this->bufferPos = 0;
 
     #ifdef ARDUINO_ARCH_ESP8266
     if (!this->webServer->chunkedResponseModeStart(code, contentType)) {
       this->webServer->send(505, F("text/html"), F("HTTP1.1 required"));
-      return;
+      return false;
     }
-
-    this->webServer->setContentLength(contentLength);
     #else
-    this->webServer->setContentLength(contentLength);
+    this->webServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
     this->webServer->send(code, contentType, emptyString);
     #endif
 
-    if (pretty) {
-      serializeJsonPretty(content, *this);
-      
-    } else {
-      serializeJson(content, *this);
-    }
+    return true;
+  }
 
+  void end() {
     this->flush();
 
     #ifdef ARDUINO_ARCH_ESP8266
@@ -42,7 +86,7 @@ public:
     #endif
   }
 
-  size_t write(uint8_t c) {
+  size_t write(uint8_t c) override {
     this->buffer[this->bufferPos++] = c;
 
     if (this->bufferPos >= this->bufferSize) {
@@ -52,7 +96,7 @@ public:
     return 1;
   }
 
-  size_t write(const uint8_t* buffer, size_t length) {
+  size_t write(const uint8_t* buffer, size_t length) override {
     size_t written = 0;
     while (written < length) {
       size_t copySize = this->bufferSize - this->bufferPos;
@@ -73,7 +117,7 @@ public:
     return written;
   }
 
-  void flush() {
+  void flush() override {
     if (this->bufferPos == 0) {
       return;
     }
@@ -97,6 +141,16 @@ public:
 protected:
   WebServer* webServer = nullptr;
   uint8_t* buffer;
-  size_t bufferSize = 64;
+  size_t bufferSize = TCP_MSS - 8;
   size_t bufferPos = 0;
+
+  template <class W>
+  static void serialize(const JsonVariantConst content, W& writer, bool pretty) {
+    if (pretty) {
+      serializeJsonPretty(content, writer);
+
+    } else {
+      serializeJson(content, writer);
+    }
+  }
 };
\ No newline at end of file
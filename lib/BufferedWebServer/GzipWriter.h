@@ -0,0 +1,248 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Streaming gzip compressor with a small footprint (~3 kb of heap while alive).
+ * LZ77 over a 2 kb sliding window with a single-entry hash table,
+ * symbols are coded with the fixed deflate huffman tables in one final block.
+ * Good enough for json, where most of the gain comes from repeated keys.
+ */
+template <class Output>
+class GzipWriter {
+public:
+  static const uint16_t BLOCK_SIZE = 1024;
+  static const uint8_t HASH_BITS = 9;
+  static const uint16_t MIN_MATCH = 3;
+  static const uint16_t MAX_MATCH = 258;
+  static const uint16_t NONE = 0xFFFF;
+
+  GzipWriter(Output* output) {
+    this->output = output;
+    this->window = (uint8_t*) malloc(BLOCK_SIZE * 2);
+    this->head = (uint16_t*) malloc(sizeof(*this->head) << HASH_BITS);
+
+    if (this->isValid()) {
+      for (uint16_t i = 0; i < (1 << HASH_BITS); i++) {
+        this->head[i] = NONE;
+      }
+    }
+  }
+
+  ~GzipWriter() {
+    free(this->window);
+    free(this->head);
+  }
+
+  inline bool isValid() {
+    return this->window != nullptr && this->head != nullptr;
+  }
+
+  void begin() {
+    static const uint8_t header[] PROGMEM = {
+      0x1f, 0x8b,             // magic
+      0x08,                   // deflate
+      0x00,                   // flags
+      0x00, 0x00, 0x00, 0x00, // mtime
+      0x00,                   // extra flags
+      0xff                    // os: unknown
+    };
+
+    for (uint8_t i = 0; i < sizeof(header); i++) {
+      this->output->write(pgm_read_byte(&header[i]));
+    }
+
+    // the only block is also the last one: BFINAL = 1, BTYPE = 01 (fixed huffman)
+    this->writeBits(0b011, 3);
+  }
+
+  size_t write(uint8_t c) {
+    this->window[BLOCK_SIZE + this->length++] = c;
+    this->crc = this->crc32(this->crc, c);
+    this->size++;
+
+    if (this->length >= BLOCK_SIZE) {
+      this->compressBlock();
+    }
+
+    return 1;
+  }
+
+  size_t write(const uint8_t* buffer, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+      this->write(buffer[i]);
+    }
+
+    return length;
+  }
+
+  void end() {
+    if (this->length) {
+      this->compressBlock();
+    }
+
+    // end of block
+    this->writeSymbol(256);
+
+    // align to byte
+    if (this->bitCount) {
+      this->writeBits(0, 8 - this->bitCount);
+    }
+
+    this->writeLe32(~this->crc);
+    this->writeLe32(this->size);
+  }
+
+protected:
+  Output* output = nullptr;
+  uint8_t* window = nullptr;
+  uint16_t* head = nullptr;
+  uint16_t length = 0;
+  uint16_t validStart = BLOCK_SIZE;
+  uint32_t bitBuffer = 0;
+  uint8_t bitCount = 0;
+  uint32_t crc = 0xFFFFFFFF;
+  uint32_t size = 0;
+
+  inline uint16_t hash(uint16_t pos) {
+    uint32_t value = (this->window[pos] << 16) | (this->window[pos + 1] << 8) | this->window[pos + 2];
+
+    return (uint32_t) (value * 2654435761UL) >> (32 - HASH_BITS);
+  }
+
+  void compressBlock() {
+    const uint16_t end = BLOCK_SIZE + this->length;
+    uint16_t pos = BLOCK_SIZE;
+
+    while (pos < end) {
+      uint16_t matchLength = 0;
+      uint16_t matchPos = NONE;
+
+      if (pos + MIN_MATCH <= end) {
+        const uint16_t h = this->hash(pos);
+        matchPos = this->head[h];
+        this->head[h] = pos;
+      }
+
+      if (matchPos != NONE && matchPos >= this->validStart && matchPos < pos) {
+        const uint16_t maxLength = end - pos < MAX_MATCH ? end - pos : MAX_MATCH;
+
+        while (matchLength < maxLength && this->window[matchPos + matchLength] == this->window[pos + matchLength]) {
+          matchLength++;
+        }
+      }
+
+      if (matchLength >= MIN_MATCH) {
+        this->writeMatch(matchLength, pos - matchPos);
+
+        // index the skipped positions, keeps later matches close
+        for (uint16_t i = pos + 1; i < pos + matchLength && i + MIN_MATCH <= end; i++) {
+          this->head[this->hash(i)] = i;
+        }
+
+        pos += matchLength;
+
+      } else {
+        this->writeSymbol(this->window[pos]);
+        pos++;
+      }
+    }
+
+    // the current block becomes the history for the next one
+    memcpy(this->window, this->window + BLOCK_SIZE, BLOCK_SIZE);
+    for (uint16_t i = 0; i < (1 << HASH_BITS); i++) {
+      this->head[i] = this->head[i] != NONE && this->head[i] >= BLOCK_SIZE ? this->head[i] - BLOCK_SIZE : NONE;
+    }
+
+    this->validStart = BLOCK_SIZE - this->length;
+    this->length = 0;
+  }
+
+  void writeMatch(uint16_t length, uint16_t distance) {
+    static const uint16_t lengthBase[] PROGMEM = {
+      3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    static const uint8_t lengthExtra[] PROGMEM = {
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    static const uint16_t distanceBase[] PROGMEM = {
+      1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+      257, 385, 513, 769, 1025, 1537, 2049, 3073
+    };
+    static const uint8_t distanceExtra[] PROGMEM = {
+      0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+      7, 7, 8, 8, 9, 9, 10, 10
+    };
+
+    uint8_t code = sizeof(lengthBase) / sizeof(*lengthBase) - 1;
+    while (pgm_read_word(&lengthBase[code]) > length) {
+      code--;
+    }
+    this->writeSymbol(257 + code);
+    this->writeBits(length - pgm_read_word(&lengthBase[code]), pgm_read_byte(&lengthExtra[code]));
+
+    code = sizeof(distanceBase) / sizeof(*distanceBase) - 1;
+    while (pgm_read_word(&distanceBase[code]) > distance) {
+      code--;
+    }
+    this->writeCode(code, 5);
+    this->writeBits(distance - pgm_read_word(&distanceBase[code]), pgm_read_byte(&distanceExtra[code]));
+  }
+
+  // fixed huffman code of a literal/length symbol
+  void writeSymbol(uint16_t symbol) {
+    if (symbol < 144) {
+      this->writeCode(0x30 + symbol, 8);
+
+    } else if (symbol < 256) {
+      this->writeCode(0x190 + symbol - 144, 9);
+
+    } else if (symbol < 280) {
+      this->writeCode(symbol - 256, 7);
+
+    } else {
+      this->writeCode(0xC0 + symbol - 280, 8);
+    }
+  }
+
+  // huffman codes are packed starting from the most significant bit
+  void writeCode(uint16_t code, uint8_t bits) {
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < bits; i++) {
+      reversed = (reversed << 1) | (code & 1);
+      code >>= 1;
+    }
+
+    this->writeBits(reversed, bits);
+  }
+
+  void writeBits(uint32_t value, uint8_t bits) {
+    this->bitBuffer |= value << this->bitCount;
+    this->bitCount += bits;
+
+    while (this->bitCount >= 8) {
+      this->output->write((uint8_t) (this->bitBuffer & 0xFF));
+      this->bitBuffer >>= 8;
+      this->bitCount -= 8;
+    }
+  }
+
+  void writeLe32(uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+      this->output->write((uint8_t) (value >> (i * 8)));
+    }
+  }
+
+  static uint32_t crc32(uint32_t crc, uint8_t c) {
+    static const uint32_t table[] PROGMEM = {
+      0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+      0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = (crc >> 4) ^ pgm_read_dword(&table[(crc ^ c) & 0x0F]);
+    crc = (crc >> 4) ^ pgm_read_dword(&table[(crc ^ (c >> 4)) & 0x0F]);
+
+    return crc;
+  }
+};
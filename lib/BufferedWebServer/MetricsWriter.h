@@ -0,0 +1,142 @@
+#pragma once
+#include <Arduino.h>
+#include <type_traits>
+
+/**
+ * Prometheus text exposition format, written straight to the output.
+ * Usage: family() once, then begin()->label()->value() for each sample.
+ */
+class MetricsWriter {
+public:
+  enum class Type : uint8_t {
+    GAUGE,
+    COUNTER
+  };
+
+  MetricsWriter(Print* output, const char* prefix = nullptr) {
+    this->output = output;
+    this->prefix = prefix;
+  }
+
+  MetricsWriter* family(const __FlashStringHelper* name, const __FlashStringHelper* help, Type type = Type::GAUGE) {
+    this->name = name;
+
+    this->output->print(F("# HELP "));
+    this->printName();
+    this->output->print(' ');
+    this->output->print(help);
+
+    this->output->print(F("\n# TYPE "));
+    this->printName();
+    this->output->print(type == Type::COUNTER ? F(" counter\n") : F(" gauge\n"));
+
+    return this;
+  }
+
+  MetricsWriter* begin() {
+    this->printName();
+    this->labels = 0;
+
+    return this;
+  }
+
+  MetricsWriter* label(const __FlashStringHelper* key, const char* value) {
+    this->output->print(this->labels++ ? ',' : '{');
+    this->output->print(key);
+    this->output->print(F("=\""));
+
+    // escape \, " and new lines
+    for (const char* c = value; *c != '\0'; c++) {
+      if (*c == '\\' || *c == '"') {
+        this->output->print('\\');
+        this->output->print(*c);
+
+      } else if (*c == '\n') {
+        this->output->print(F("\\n"));
+
+      } else {
+        this->output->print(*c);
+      }
+    }
+
+    this->output->print('"');
+
+    return this;
+  }
+
+  // trusted value, written without escaping
+  MetricsWriter* label(const __FlashStringHelper* key, const __FlashStringHelper* value) {
+    this->output->print(this->labels++ ? ',' : '{');
+    this->output->print(key);
+    this->output->print(F("=\""));
+    this->output->print(value);
+    this->output->print('"');
+
+    return this;
+  }
+
+  MetricsWriter* label(const __FlashStringHelper* key, unsigned long value) {
+    char buffer[11];
+    ultoa(value, buffer, 10);
+
+    return this->label(key, buffer);
+  }
+
+  void value(float value, uint8_t digits = 3) {
+    this->endLabels();
+
+    if (isnan(value)) {
+      this->output->print(F("NaN"));
+
+    } else if (isinf(value)) {
+      this->output->print(value > 0 ? F("+Inf") : F("-Inf"));
+
+    } else {
+      this->output->print(value, digits);
+    }
+
+    this->output->print('\n');
+  }
+
+  template <class T>
+  void value(T value) {
+    static_assert(std::is_integral<T>::value, "integral or float value expected");
+    this->endLabels();
+
+    if (std::is_signed<T>::value) {
+      this->output->print(static_cast<long>(value));
+
+    } else {
+      this->output->print(static_cast<unsigned long>(value));
+    }
+
+    this->output->print('\n');
+  }
+
+  template <class T>
+  inline void sample(T value) {
+    this->begin()->value(value);
+  }
+
+protected:
+  Print* output = nullptr;
+  const char* prefix = nullptr;
+  const __FlashStringHelper* name = nullptr;
+  uint8_t labels = 0;
+
+  void printName() {
+    if (this->prefix != nullptr) {
+      this->output->print(this->prefix);
+    }
+
+    this->output->print(this->name);
+  }
+
+  void endLabels() {
+    if (this->labels) {
+      this->output->print('}');
+    }
+
+    this->output->print(' ');
+  }
+};
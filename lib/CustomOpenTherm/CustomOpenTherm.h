@@ -7,6 +7,15 @@ public:
   typedef std::function<void(unsigned long, uint8_t)> BeforeSendRequestCallback;
   typedef std::function<void(unsigned long, unsigned long, OpenThermResponseStatus, uint8_t)> AfterSendRequestCallback;
 
+  // bus counters, every attempt is counted
+  struct Stats {
+    unsigned long requests = 0;
+    unsigned long success = 0;
+    unsigned long invalid = 0;
+    unsigned long timeouts = 0;
+    unsigned long retries = 0;
+  };
+
   CustomOpenTherm(int inPin = 4, int outPin = 5, bool isSlave = false, bool alwaysReceive = false) : OpenTherm(inPin, outPin, isSlave, alwaysReceive) {}
   ~CustomOpenTherm() {}
 
@@ -28,6 +37,10 @@ public:
     return this;
   }
 
+  inline const Stats& getStats() {
+    return this->stats;
+  }
+
   unsigned long sendRequest(unsigned long request) override {
     this->sendRequestAttempt++;
 
@@ -53,6 +66,21 @@ public:
       } while (this->status != OpenThermStatus::READY && this->status != OpenThermStatus::DELAY);
     }
 
+    this->stats.requests++;
+    if (this->sendRequestAttempt > 1) {
+      this->stats.retries++;
+    }
+
+    if (this->responseStatus == OpenThermResponseStatus::SUCCESS) {
+      this->stats.success++;
+
+    } else if (this->responseStatus == OpenThermResponseStatus::INVALID) {
+      this->stats.invalid++;
+
+    } else {
+      this->stats.timeouts++;
+    }
+
     if (this->afterSendRequestCallback) {
       this->afterSendRequestCallback(request, this->response, this->responseStatus, this->sendRequestAttempt);
     }
@@ -189,6 +217,7 @@ public:
 protected:
   const uint8_t sendRequestMaxAttempts = 5;
   uint8_t sendRequestAttempt = 0;
+  Stats stats;
   DelayCallback delayCallback;
   BeforeSendRequestCallback beforeSendRequestCallback;
   AfterSendRequestCallback afterSendRequestCallback;
@@ -0,0 +1,146 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Burner cycle statistics from a ring buffer of flame edges.
+ * Only the edges of the last hour are used, the buffer holds up to MAX_EDGES / 2 cycles,
+ * more frequent cycling is counted as MAX_EDGES / 2 cycles per hour.
+ * Times are in seconds.
+ */
+class CycleMonitor {
+public:
+  static const uint8_t MAX_EDGES = 40;
+  static const unsigned long PERIOD = 3600;
+
+  void reset() {
+    this->head = 0;
+    this->count = 0;
+    this->flame = false;
+    this->lastOnTime = 0;
+    this->modulationSum = 0;
+    this->modulationSamples = 0;
+    this->lastModulation = 0;
+  }
+
+  /**
+   * Feeds the current flame state, returns true on an edge.
+   */
+  bool update(bool flame, uint8_t modulation) {
+    const unsigned long now = millis();
+
+    if (flame) {
+      this->modulationSum += modulation;
+      this->modulationSamples++;
+    }
+
+    if (flame == this->flame) {
+      return false;
+    }
+
+    if (!flame) {
+      const Edge* ignition = this->getLastEdge();
+      this->lastOnTime = ignition != nullptr ? (now - ignition->time) / 1000ul : 0;
+      this->lastModulation = this->modulationSamples > 0
+        ? this->modulationSum / this->modulationSamples
+        : 0;
+
+    } else {
+      this->modulationSum = modulation;
+      this->modulationSamples = 1;
+    }
+
+    this->flame = flame;
+    this->edges[this->head] = {now, flame};
+    this->head = (this->head + 1) % MAX_EDGES;
+    if (this->count < MAX_EDGES) {
+      this->count++;
+    }
+
+    return true;
+  }
+
+  inline bool isFlameOn() const {
+    return this->flame;
+  }
+
+  // ignitions in the last hour
+  uint8_t getCyclesPerHour() const {
+    const unsigned long now = millis();
+    uint8_t result = 0;
+
+    for (uint8_t i = 0; i < this->count; i++) {
+      const Edge& edge = this->getEdge(i);
+
+      if (edge.flame && now - edge.time <= PERIOD * 1000ul) {
+        result++;
+      }
+    }
+
+    return result;
+  }
+
+  // duration of the last completed burn
+  inline unsigned long getLastOnTime() const {
+    return this->lastOnTime;
+  }
+
+  // the shortest burn completed in the last hour, 0 if none
+  unsigned long getMinOnTime() const {
+    const unsigned long now = millis();
+    unsigned long result = 0;
+
+    for (uint8_t i = 1; i < this->count; i++) {
+      const Edge& ignition = this->getEdge(i - 1);
+      const Edge& extinction = this->getEdge(i);
+
+      if (!ignition.flame || extinction.flame || now - extinction.time > PERIOD * 1000ul) {
+        continue;
+      }
+
+      const unsigned long duration = (extinction.time - ignition.time) / 1000ul;
+      if (result == 0 || duration < result) {
+        result = duration;
+      }
+    }
+
+    return result;
+  }
+
+  // time since the flame went off, 0 while it is on or was never seen
+  unsigned long getOffTime() const {
+    const Edge* edge = this->getLastEdge();
+
+    return !this->flame && edge != nullptr
+      ? (millis() - edge->time) / 1000ul
+      : 0;
+  }
+
+  // average modulation of the last completed burn
+  inline uint8_t getLastModulation() const {
+    return this->lastModulation;
+  }
+
+protected:
+  struct Edge {
+    unsigned long time;
+    bool flame;
+  };
+
+  Edge edges[MAX_EDGES] = {};
+  uint8_t head = 0;
+  uint8_t count = 0;
+  bool flame = false;
+  unsigned long lastOnTime = 0;
+  uint32_t modulationSum = 0;
+  uint32_t modulationSamples = 0;
+  uint8_t lastModulation = 0;
+
+  // 0 is the oldest edge
+  inline const Edge& getEdge(uint8_t index) const {
+    return this->edges[(this->head + MAX_EDGES - this->count + index) % MAX_EDGES];
+  }
+
+  inline const Edge* getLastEdge() const {
+    return this->count > 0 ? &this->getEdge(this->count - 1) : nullptr;
+  }
+};
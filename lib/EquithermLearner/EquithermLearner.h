@@ -0,0 +1,149 @@
+#pragma once
+#include <Arduino.h>
+#include <RlsEstimator.h>
+
+/**
+ * Online fit of the equitherm slope and shift from the observed indoor response.
+ *
+ * The curve rise is range * (delta * slope / range) ^ (1 / exponent)
+ * = slope ^ (1 / exponent) * range ^ (1 - 1 / exponent) * delta ^ (1 / exponent),
+ * so with a fixed exponent it is linear in theta = [slope ^ (1 / exponent), shift]
+ * and can be fitted by recursive least squares.
+ *
+ * Samples are time-weighted over a window (an hour by default), so they may come at any rate.
+ * The setpoint that would have kept the indoor temp on target is estimated as
+ * setpoint + (1 + slope) * (target - indoor), the steady state gain of a house
+ * where the emitter output and the losses are balanced.
+ * Windows with a drifting indoor temp are dropped, they do not describe a steady state.
+ */
+class EquithermLearner {
+public:
+  EquithermLearner() {
+    this->estimator.setForgetting(0.98f);
+  }
+
+  EquithermLearner* setWindow(unsigned long value) {
+    this->window = value;
+
+    return this;
+  }
+
+  EquithermLearner* setForgetting(float value) {
+    this->estimator.setForgetting(value);
+
+    return this;
+  }
+
+  EquithermLearner* setMaxIndoorDrift(float value) {
+    this->maxIndoorDrift = value;
+
+    return this;
+  }
+
+  void reset(float slope, float shift, float exponent) {
+    // the slope of the initial curve is trusted more than its shift
+    const float theta[2] = {powf(slope, 1.0f / exponent), shift};
+    const float variance[2] = {0.01f, 4.0f};
+
+    this->exponent = exponent;
+    this->estimator.reset(theta, variance);
+    this->invalidate();
+  }
+
+  // drops the current window
+  inline void invalidate() {
+    this->count = 0;
+  }
+
+  /**
+   * Adds a sample, returns true when a window has been completed and fitted.
+   * maxTemp is the heating max temp the curve is built against.
+   */
+  bool sample(float target, float maxTemp, float outdoorTemp, float setpointTemp, float indoorTemp) {
+    if (this->count > 0 && fabsf(target - this->target) > 0.0001f) {
+      this->invalidate();
+    }
+
+    const unsigned long now = millis();
+
+    if (this->count == 0) {
+      this->startTime = now;
+      this->lastSampleTime = now;
+      this->target = target;
+      this->firstIndoorTemp = indoorTemp;
+      this->outdoorTemp = 0.0f;
+      this->setpointTemp = 0.0f;
+      this->indoorTemp = 0.0f;
+      this->weight = 0.0f;
+    }
+
+    // a sample holds since the previous one, the first one counts as a second
+    const float weight = this->count > 0 ? (now - this->lastSampleTime) / 1000.0f : 1.0f;
+    this->lastSampleTime = now;
+
+    this->outdoorTemp += outdoorTemp * weight;
+    this->setpointTemp += setpointTemp * weight;
+    this->indoorTemp += indoorTemp * weight;
+    this->weight += weight;
+    this->count++;
+
+    if (now - this->startTime < this->window * 1000ul) {
+      return false;
+    }
+
+    const float drift = indoorTemp - this->firstIndoorTemp;
+    const float avgOutdoorTemp = this->outdoorTemp / this->weight;
+    const float avgSetpointTemp = this->setpointTemp / this->weight;
+    const float avgIndoorTemp = this->indoorTemp / this->weight;
+    this->invalidate();
+
+    const float range = maxTemp - target;
+    const float delta = target - avgOutdoorTemp;
+    if (fabsf(drift) > this->maxIndoorDrift || range <= 0.0f || delta < 1.0f) {
+      return false;
+    }
+
+    const float neededTemp = avgSetpointTemp + (1.0f + this->getSlope()) * (target - avgIndoorTemp);
+    const float phi[2] = {
+      powf(range, 1.0f - 1.0f / this->exponent) * powf(delta, 1.0f / this->exponent),
+      1.0f
+    };
+    this->estimator.update(phi, neededTemp - target);
+
+    return true;
+  }
+
+  inline uint16_t getSamples() const {
+    return this->estimator.getSamples();
+  }
+
+  inline float getSlope() const {
+    const float theta = this->estimator.get(0);
+
+    return theta > 0.0f ? powf(theta, this->exponent) : 0.0f;
+  }
+
+  inline float getShift() const {
+    return this->estimator.get(1);
+  }
+
+  inline float getExponent() const {
+    return this->exponent;
+  }
+
+protected:
+  RlsEstimator<2> estimator;
+  unsigned long window = 3600;
+  float maxIndoorDrift = 0.3f;
+  float exponent = 1.0f;
+
+  unsigned long startTime = 0;
+  unsigned long lastSampleTime = 0;
+  uint16_t count = 0;
+  float weight = 0.0f;
+  float target = 0.0f;
+  float firstIndoorTemp = 0.0f;
+  float outdoorTemp = 0.0f;
+  float setpointTemp = 0.0f;
+  float indoorTemp = 0.0f;
+};
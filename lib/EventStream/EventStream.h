@@ -0,0 +1,166 @@
+class EventStream {
+public:
+  enum class Target : uint8_t {
+    ALL,
+    NEW,
+    ESTABLISHED
+  };
+
+  EventStream(WebServer* webServer, uint8_t maxClients = 2) {
+    this->webServer = webServer;
+    this->maxClients = maxClients;
+    this->clients = new WiFiClient[maxClients];
+    this->established = new bool[maxClients];
+
+    for (uint8_t i = 0; i < maxClients; i++) {
+      this->established[i] = false;
+    }
+  }
+
+  ~EventStream() {
+    this->stop();
+
+    delete[] this->clients;
+    delete[] this->established;
+  }
+
+  /**
+   * Takes over the current client of the web server.
+   * Must be called from a request handler, the web server must not send a response after it.
+   */
+  bool accept() {
+    this->cleanup();
+
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      if (this->clients[i].connected()) {
+        continue;
+      }
+
+      this->clients[i] = this->webServer->client();
+      this->clients[i].setNoDelay(true);
+      this->clients[i].print(F(
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+        "retry: 5000\n\n"
+      ));
+      this->established[i] = false;
+      this->lastSendTime = millis();
+
+      return true;
+    }
+
+    return false;
+  }
+
+  uint8_t count() {
+    this->cleanup();
+
+    uint8_t result = 0;
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      if (this->clients[i].connected()) {
+        result++;
+      }
+    }
+
+    return result;
+  }
+
+  bool hasNew() {
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      if (this->clients[i].connected() && !this->established[i]) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // all new clients have received the initial state
+  void establish() {
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      if (this->clients[i].connected()) {
+        this->established[i] = true;
+      }
+    }
+  }
+
+  template <class T>
+  void send(T event, const JsonVariantConst data, Target target = Target::ALL) {
+    String payload;
+    payload.reserve(measureJson(data) + 1);
+    serializeJson(data, payload);
+
+    this->send(event, payload.c_str(), payload.length(), target);
+  }
+
+  template <class T>
+  void send(T event, const char* data, size_t length, Target target = Target::ALL) {
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      auto& client = this->clients[i];
+      if (!client.connected()) {
+        continue;
+
+      } else if (target == Target::NEW && this->established[i]) {
+        continue;
+
+      } else if (target == Target::ESTABLISHED && !this->established[i]) {
+        continue;
+      }
+
+      bool result = client.print(F("event: ")) > 0
+        && client.print(event) > 0
+        && client.print(F("\ndata: ")) > 0
+        && client.write((const uint8_t*) data, length) == length
+        && client.print(F("\n\n")) > 0;
+
+      // slow or gone client
+      if (!result) {
+        client.stop();
+      }
+    }
+
+    this->lastSendTime = millis();
+  }
+
+  // keeps idle connections alive and detects closed ones
+  void ping(unsigned long interval) {
+    if (millis() - this->lastSendTime < interval) {
+      return;
+    }
+
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      if (this->clients[i].connected() && !this->clients[i].print(F(": ping\n\n"))) {
+        this->clients[i].stop();
+      }
+    }
+
+    this->lastSendTime = millis();
+  }
+
+  void stop() {
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      if (this->clients[i].connected()) {
+        this->clients[i].stop();
+      }
+    }
+  }
+
+protected:
+  WebServer* webServer = nullptr;
+  WiFiClient* clients = nullptr;
+  bool* established = nullptr;
+  uint8_t maxClients = 2;
+  unsigned long lastSendTime = 0;
+
+  void cleanup() {
+    for (uint8_t i = 0; i < this->maxClients; i++) {
+      if (!this->clients[i].connected()) {
+        this->clients[i] = WiFiClient();
+        this->established[i] = false;
+      }
+    }
+  }
+};
@@ -0,0 +1,130 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Q16.16 fixed-point helpers for chips without FPU (ESP8266, ESP32-C3).
+ * log2/exp2 use 32-segment tables with linear interpolation,
+ * the relative error of pow() is below 2e-4.
+ */
+namespace FixedMath {
+  typedef int32_t q16_t;
+
+  const uint8_t FRACTION_BITS = 16;
+  const q16_t ONE = 1l << FRACTION_BITS;
+  const q16_t LIMIT = INT32_MAX;
+
+  // log2(1 + i/32)
+  const uint32_t log2Table[33] PROGMEM = {
+    0, 2909, 5732, 8473, 11136, 13727, 16248, 18704,
+    21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+    52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+    65536
+  };
+
+  // 2^(i/32)
+  const uint32_t exp2Table[33] PROGMEM = {
+    65536, 66971, 68438, 69936, 71468, 73032, 74632, 76266,
+    77936, 79642, 81386, 83169, 84990, 86851, 88752, 90696,
+    92682, 94711, 96785, 98905, 101070, 103283, 105545, 107856,
+    110218, 112631, 115098, 117618, 120194, 122825, 125515, 128263,
+    131072
+  };
+
+  inline q16_t fromFloat(float value) {
+    return static_cast<q16_t>(value * ONE);
+  }
+
+  inline float toFloat(q16_t value) {
+    return static_cast<float>(value) / ONE;
+  }
+
+  inline q16_t saturate(int64_t value) {
+    return value > LIMIT ? LIMIT : (value < -LIMIT ? -LIMIT : static_cast<q16_t>(value));
+  }
+
+  inline q16_t mul(q16_t a, q16_t b) {
+    return saturate((static_cast<int64_t>(a) * b) >> FRACTION_BITS);
+  }
+
+  inline q16_t div(q16_t a, q16_t b) {
+    if (b == 0) {
+      return a >= 0 ? LIMIT : -LIMIT;
+    }
+
+    return saturate((static_cast<int64_t>(a) << FRACTION_BITS) / b);
+  }
+
+  // interpolates between the entries around a 16-bit fraction
+  inline uint32_t interpolate(const uint32_t* table, uint32_t fraction) {
+    const uint8_t index = fraction >> 11;
+    const uint32_t left = pgm_read_dword(&table[index]);
+    const uint32_t right = pgm_read_dword(&table[index + 1]);
+
+    return left + (((right - left) * (fraction & 0x7FF)) >> 11);
+  }
+
+  // x > 0
+  inline q16_t log2(uint32_t x) {
+    const int8_t msb = 31 - __builtin_clz(x);
+    const uint32_t normalized = msb >= FRACTION_BITS
+      ? x >> (msb - FRACTION_BITS)
+      : x << (FRACTION_BITS - msb);
+
+    return (msb - FRACTION_BITS) * ONE + static_cast<q16_t>(interpolate(log2Table, normalized - ONE));
+  }
+
+  inline q16_t exp2(q16_t y) {
+    const int32_t integer = y >> FRACTION_BITS;
+
+    if (integer >= 15) {
+      return LIMIT;
+
+    } else if (integer < -FRACTION_BITS) {
+      return 0;
+    }
+
+    const uint32_t mantissa = interpolate(exp2Table, y & (ONE - 1));
+
+    return integer >= 0 ? mantissa << integer : mantissa >> -integer;
+  }
+
+  // x >= 0
+  inline q16_t pow(q16_t x, q16_t power) {
+    if (x <= 0) {
+      return 0;
+    }
+
+    int64_t y = (static_cast<int64_t>(log2(x)) * power) >> FRACTION_BITS;
+    if (y > 15l * ONE) {
+      return LIMIT;
+
+    } else if (y < -17l * ONE) {
+      return 0;
+    }
+
+    return exp2(static_cast<q16_t>(y));
+  }
+
+  /**
+   * factor * (x / base)^power, x >= 0, factor > 0, base > 0.
+   * Evaluated as exp2(log2(factor) + (log2(x) - log2(base)) * power):
+   * a small ratio x / base has only a few significant bits in Q16.16.
+   */
+  inline q16_t mulPowRatio(q16_t factor, q16_t x, q16_t base, q16_t power) {
+    if (x <= 0 || factor <= 0 || base <= 0) {
+      return 0;
+    }
+
+    int64_t y = static_cast<int64_t>(log2(factor))
+      + ((static_cast<int64_t>(log2(x) - log2(base)) * power) >> FRACTION_BITS);
+    if (y > 15l * ONE) {
+      return LIMIT;
+
+    } else if (y < -17l * ONE) {
+      return 0;
+    }
+
+    return exp2(static_cast<q16_t>(y));
+  }
+}
@@ -31,6 +31,8 @@ const char HA_ENTITY_CATEGORY_CONFIG[]          PROGMEM = "config";
 const char HA_STATE_TOPIC[]                     PROGMEM = "stat_t";                   // "state_topic"
 const char HA_VALUE_TEMPLATE[]                  PROGMEM = "val_tpl";                  // "value_template"
 const char HA_OPTIONS[]                         PROGMEM = "ops";                      // "options"
+const char HA_JSON_ATTRIBUTES_TOPIC[]           PROGMEM = "json_attr_t";              // "json_attributes_topic"
+const char HA_JSON_ATTRIBUTES_TEMPLATE[]        PROGMEM = "json_attr_tpl";            // "json_attributes_template"
 const char HA_AVAILABILITY[]                    PROGMEM = "avty";                     // "availability"
 const char HA_AVAILABILITY_MODE[]               PROGMEM = "avty_mode";                // "availability_mode"
 const char HA_TOPIC[]                           PROGMEM = "t";                        // "topic"
@@ -0,0 +1,524 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+
+/**
+ * Crash-safe storage of a POD struct, a replacement for FileData.
+ * Two snapshot slots (A/B) hold full copies tagged with a generation, a journal
+ * holds CRC-protected records of the changed byte ranges on top of the newest snapshot.
+ * Changes are detected with per-block CRCs, so no shadow copy of the struct is kept.
+ * When the journal outgrows the struct, it is compacted into the other slot.
+ * A torn write leaves either the previous snapshot or an invalid journal tail,
+ * both are skipped on read, so the last complete state is always restored.
+ * Snapshots carry the layout version, older layouts are passed through the migrate callback.
+ */
+class JournalData {
+public:
+  enum class Status : uint8_t {
+    IDLE,
+    WAITING,
+    LOADED,
+    RESIZED,
+    MIGRATED,
+    NEWER_VERSION,
+    NOT_FOUND,
+    CORRUPTED,
+    FS_ERROR,
+    WRITTEN,
+    WRITE_ERROR
+  };
+
+  /**
+   * Converts the raw data of an older layout in place, up to the current one.
+   * Version 0 is a FileData file. The buffer holds at least max(size, current size) bytes.
+   */
+  typedef std::function<bool(uint16_t version, uint8_t* buffer, uint16_t& size, uint16_t capacity)> MigrateCallback;
+
+  static const uint8_t BLOCK_SIZE = 32;
+
+  JournalData(fs::FS* fs, const char* path, uint8_t key, void* data, uint16_t size, unsigned int timeout = 5000) {
+    this->fs = fs;
+    this->path = path;
+    this->key = key;
+    this->data = static_cast<uint8_t*>(data);
+    this->size = size;
+    this->timeout = timeout;
+    this->blocksAmount = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    this->blocksCrc = new uint32_t[this->blocksAmount]();
+  }
+
+  ~JournalData() {
+    delete[] this->blocksCrc;
+  }
+
+  JournalData* setVersion(uint16_t version) {
+    this->version = version;
+
+    return this;
+  }
+
+  JournalData* setMigrateCallback(MigrateCallback callback = nullptr) {
+    this->migrateCallback = callback;
+
+    return this;
+  }
+
+  inline uint16_t getLoadedVersion() {
+    return this->loadedVersion;
+  }
+
+  Status read() {
+    if (this->fs == nullptr) {
+      return Status::FS_ERROR;
+    }
+
+    // newest valid snapshot
+    int8_t slot = -1;
+    SnapshotHeader header;
+    for (uint8_t i = 0; i < 2; i++) {
+      SnapshotHeader slotHeader;
+
+      if (this->checkSnapshot(i, slotHeader) && (slot == -1 || slotHeader.generation > header.generation)) {
+        slot = i;
+        header = slotHeader;
+      }
+    }
+
+    Status status = Status::LOADED;
+    this->loadedVersion = this->version;
+
+    if (slot == -1) {
+      bool exists = this->fs->exists(this->getPath('a')) || this->fs->exists(this->getPath('b'));
+
+      if (this->readLegacy()) {
+        status = this->loadedVersion != this->version ? Status::MIGRATED : Status::LOADED;
+        this->needsCompaction = true;
+
+      } else if (exists) {
+        status = Status::CORRUPTED;
+
+      } else {
+        status = Status::NOT_FOUND;
+        this->needsCompaction = true;
+      }
+
+      this->generation = 0;
+
+    } else if (header.version > this->version) {
+      // written by a newer firmware, the layout is unknown
+      status = Status::NEWER_VERSION;
+      this->generation = header.generation;
+      this->slot = slot;
+      this->needsCompaction = true;
+
+    } else {
+      this->generation = header.generation;
+      this->slot = slot;
+      this->loadedVersion = header.version;
+
+      if (header.version == this->version) {
+        this->loadSnapshot(slot, this->data, header.size, this->size);
+
+        if (!this->replayJournal(this->data, this->size)) {
+          // records appended after a torn one would never be read
+          this->needsCompaction = true;
+        }
+
+        if (header.size != this->size) {
+          status = Status::RESIZED;
+          this->needsCompaction = true;
+        }
+
+      } else {
+        // the journal is replayed in the old layout, then the result is migrated
+        uint16_t capacity = max(header.size, this->size);
+        uint8_t* buffer = new uint8_t[capacity]();
+        this->loadSnapshot(slot, buffer, header.size, capacity);
+        this->replayJournal(buffer, header.size);
+
+        status = this->migrate(header.version, buffer, header.size, capacity)
+          ? Status::MIGRATED
+          : Status::CORRUPTED;
+        delete[] buffer;
+
+        this->needsCompaction = true;
+      }
+    }
+
+    this->updateBlocksCrc();
+    this->pending = false;
+
+    // data of a newer firmware is kept until the first change
+    if (this->needsCompaction && status != Status::NEWER_VERSION && !this->compact()) {
+      return Status::WRITE_ERROR;
+    }
+
+    return status;
+  }
+
+  void update() {
+    this->pending = true;
+    this->pendingTime = millis();
+  }
+
+  Status updateNow() {
+    this->pending = false;
+
+    return this->flush() ? Status::WRITTEN : Status::WRITE_ERROR;
+  }
+
+  Status tick() {
+    if (!this->pending) {
+      return Status::IDLE;
+    }
+
+    if (millis() - this->pendingTime < this->timeout) {
+      return Status::WAITING;
+    }
+
+    return this->updateNow();
+  }
+
+  // removes all copies, defaults are loaded on the next read()
+  void reset() {
+    this->pending = false;
+
+    const char suffixes[] = {'a', 'b', 'j'};
+    for (const char suffix : suffixes) {
+      String path = this->getPath(suffix);
+
+      if (this->fs->exists(path)) {
+        this->fs->remove(path);
+      }
+    }
+
+    if (this->fs->exists(this->path)) {
+      this->fs->remove(this->path);
+    }
+  }
+
+protected:
+  struct SnapshotHeader {
+    uint8_t key;
+    uint8_t format;
+    uint16_t size;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t generation;
+    uint32_t crc;
+  };
+
+  struct RecordHeader {
+    uint32_t generation;
+    uint16_t offset;
+    uint16_t length;
+    uint32_t crc;
+  };
+
+  static const uint8_t FORMAT = 1;
+
+  fs::FS* fs = nullptr;
+  const char* path = nullptr;
+  uint8_t key = 0;
+  uint8_t* data = nullptr;
+  uint16_t size = 0;
+  unsigned int timeout = 0;
+  uint16_t version = 0;
+  uint16_t loadedVersion = 0;
+  MigrateCallback migrateCallback;
+
+  uint16_t blocksAmount = 0;
+  uint32_t* blocksCrc = nullptr;
+  uint32_t generation = 0;
+  int8_t slot = -1;
+  size_t journalSize = 0;
+  bool needsCompaction = false;
+  bool pending = false;
+  unsigned long pendingTime = 0;
+
+  String getPath(char suffix) {
+    String result = this->path;
+    result += '.';
+    result += suffix;
+
+    return result;
+  }
+
+  static uint32_t crc32(const void* data, size_t length, uint32_t crc = 0) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+    while (length--) {
+      crc ^= *bytes++;
+
+      for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+      }
+    }
+
+    return ~crc;
+  }
+
+  inline uint16_t getBlockLength(uint16_t block) {
+    return min(static_cast<uint16_t>(this->size - block * BLOCK_SIZE), static_cast<uint16_t>(BLOCK_SIZE));
+  }
+
+  void updateBlocksCrc() {
+    for (uint16_t i = 0; i < this->blocksAmount; i++) {
+      this->blocksCrc[i] = crc32(this->data + i * BLOCK_SIZE, this->getBlockLength(i));
+    }
+  }
+
+  bool checkSnapshot(uint8_t slot, SnapshotHeader& header) {
+    String path = this->getPath(slot ? 'b' : 'a');
+    if (!this->fs->exists(path)) {
+      return false;
+    }
+
+    File file = this->fs->open(path, "r");
+    if (!file) {
+      return false;
+    }
+
+    bool valid = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header)
+      && header.key == this->key
+      && header.format == FORMAT
+      && file.size() == sizeof(header) + header.size;
+
+    if (valid) {
+      uint32_t crc = crc32(&header, offsetof(SnapshotHeader, crc));
+      uint8_t buffer[BLOCK_SIZE];
+      size_t length;
+
+      while ((length = file.read(buffer, sizeof(buffer))) > 0) {
+        crc = crc32(buffer, length, crc);
+      }
+
+      valid = crc == header.crc;
+    }
+
+    file.close();
+
+    return valid;
+  }
+
+  void loadSnapshot(uint8_t slot, uint8_t* dst, uint16_t size, uint16_t capacity) {
+    File file = this->fs->open(this->getPath(slot ? 'b' : 'a'), "r");
+    file.seek(sizeof(SnapshotHeader));
+    file.read(dst, min(size, capacity));
+    file.close();
+  }
+
+  bool migrate(uint16_t version, uint8_t* buffer, uint16_t size, uint16_t capacity) {
+    if (this->migrateCallback && !this->migrateCallback(version, buffer, size, capacity)) {
+      return false;
+    }
+
+    // fields missing at the end keep their defaults
+    memcpy(this->data, buffer, min(size, this->size));
+
+    return true;
+  }
+
+  // returns false if the journal ends with a torn record
+  bool replayJournal(uint8_t* dst, uint16_t size) {
+    this->journalSize = 0;
+
+    String path = this->getPath('j');
+    if (!this->fs->exists(path)) {
+      return true;
+    }
+
+    File file = this->fs->open(path, "r");
+    if (!file) {
+      return true;
+    }
+
+    bool complete = true;
+    RecordHeader header;
+    uint8_t buffer[BLOCK_SIZE];
+
+    while (file.available()) {
+      if (file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+        complete = false;
+        break;
+      }
+
+      // the record must be verified before anything is applied
+      size_t start = file.position();
+      uint32_t crc = crc32(&header, offsetof(RecordHeader, crc));
+      size_t left = header.length;
+
+      while (left > 0) {
+        size_t length = file.read(buffer, min(left, sizeof(buffer)));
+        if (length == 0) {
+          break;
+        }
+
+        crc = crc32(buffer, length, crc);
+        left -= length;
+      }
+
+      if (left > 0 || crc != header.crc) {
+        complete = false;
+        break;
+      }
+
+      // records left by an interrupted compaction are already in the snapshot
+      if (header.generation == this->generation && header.offset + header.length <= size) {
+        file.seek(start);
+        file.read(dst + header.offset, header.length);
+      }
+
+      this->journalSize = file.position();
+    }
+
+    file.close();
+
+    return complete;
+  }
+
+  // FileData layout: key byte and raw struct, migrated as version 0
+  bool readLegacy() {
+    if (!this->fs->exists(this->path)) {
+      return false;
+    }
+
+    File file = this->fs->open(this->path, "r");
+    if (!file) {
+      return false;
+    }
+
+    bool result = false;
+    if (file.size() > 1 && file.size() <= 0xFFFF && file.read() == this->key) {
+      uint16_t size = file.size() - 1;
+      uint16_t capacity = max(size, this->size);
+      uint8_t* buffer = new uint8_t[capacity]();
+      file.read(buffer, size);
+
+      result = this->migrate(0, buffer, size, capacity);
+      delete[] buffer;
+
+      if (result && this->migrateCallback) {
+        this->loadedVersion = 0;
+      }
+    }
+
+    file.close();
+
+    return result;
+  }
+
+  bool flush() {
+    if (this->needsCompaction || this->slot == -1) {
+      return this->compact();
+    }
+
+    File file;
+    RecordHeader header;
+    uint16_t block = 0;
+    uint16_t written = 0;
+
+    while (block < this->blocksAmount) {
+      if (crc32(this->data + block * BLOCK_SIZE, this->getBlockLength(block)) == this->blocksCrc[block]) {
+        block++;
+        continue;
+      }
+
+      // merge adjacent changed blocks into one record
+      uint16_t last = block + 1;
+      while (last < this->blocksAmount && crc32(this->data + last * BLOCK_SIZE, this->getBlockLength(last)) != this->blocksCrc[last]) {
+        last++;
+      }
+
+      header.generation = this->generation;
+      header.offset = block * BLOCK_SIZE;
+      header.length = min(static_cast<uint16_t>(last * BLOCK_SIZE), this->size) - header.offset;
+
+      if (this->journalSize + written + sizeof(header) + header.length > this->size) {
+        if (file) {
+          file.close();
+        }
+
+        return this->compact();
+      }
+
+      if (!file) {
+        file = this->fs->open(this->getPath('j'), "a");
+
+        if (!file) {
+          return false;
+        }
+      }
+
+      header.crc = crc32(this->data + header.offset, header.length, crc32(&header, offsetof(RecordHeader, crc)));
+
+      if (file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) != sizeof(header)
+        || file.write(this->data + header.offset, header.length) != header.length) {
+        file.close();
+        this->needsCompaction = true;
+
+        return false;
+      }
+
+      written += sizeof(header) + header.length;
+      for (uint16_t i = block; i < last; i++) {
+        this->blocksCrc[i] = crc32(this->data + i * BLOCK_SIZE, this->getBlockLength(i));
+      }
+
+      block = last;
+    }
+
+    if (file) {
+      file.close();
+      this->journalSize += written;
+    }
+
+    return true;
+  }
+
+  bool compact() {
+    SnapshotHeader header;
+    header.key = this->key;
+    header.format = FORMAT;
+    header.size = this->size;
+    header.version = this->version;
+    header.reserved = 0;
+    header.generation = this->generation + 1;
+    header.crc = crc32(this->data, this->size, crc32(&header, offsetof(SnapshotHeader, crc)));
+
+    // never overwrite the slot holding the current generation
+    uint8_t slot = this->slot == 0 ? 1 : 0;
+    this->needsCompaction = true;
+
+    File file = this->fs->open(this->getPath(slot ? 'b' : 'a'), "w");
+    if (!file) {
+      return false;
+    }
+
+    bool result = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header)
+      && file.write(this->data, this->size) == this->size;
+    file.close();
+
+    if (!result) {
+      return false;
+    }
+
+    this->generation = header.generation;
+    this->slot = slot;
+    this->needsCompaction = false;
+    this->updateBlocksCrc();
+
+    // the journal belongs to the previous generation now
+    if (this->journalSize > 0 || this->fs->exists(this->getPath('j'))) {
+      this->fs->remove(this->getPath('j'));
+    }
+    this->journalSize = 0;
+
+    if (this->fs->exists(this->path)) {
+      this->fs->remove(this->path);
+    }
+
+    return true;
+  }
+};
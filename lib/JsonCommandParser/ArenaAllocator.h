@@ -0,0 +1,90 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * ArduinoJson allocator over a preallocated buffer.
+ * Documents built with it never touch the heap and fail with NoMemory
+ * when the buffer is exhausted. Call reset() after the document is destroyed.
+ */
+class ArenaAllocator : public ArduinoJson::Allocator {
+public:
+  ArenaAllocator(uint8_t* buffer, size_t size) {
+    this->buffer = buffer;
+    this->size = size;
+  }
+
+  inline void reset() {
+    this->pos = 0;
+    this->last = nullptr;
+  }
+
+  inline size_t getUsed() {
+    return this->pos;
+  }
+
+  void* allocate(size_t size) override {
+    size_t blockSize = align(size) + sizeof(size_t);
+    if (this->buffer == nullptr || this->pos + blockSize > this->size) {
+      return nullptr;
+    }
+
+    uint8_t* block = this->buffer + this->pos;
+    *((size_t*) block) = align(size);
+    this->pos += blockSize;
+    this->last = block + sizeof(size_t);
+
+    return this->last;
+  }
+
+  void deallocate(void* ptr) override {
+    // only the last block can be returned to the arena
+    if (ptr != nullptr && ptr == this->last) {
+      this->pos = (uint8_t*) ptr - sizeof(size_t) - this->buffer;
+      this->last = nullptr;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (ptr == nullptr) {
+      return this->allocate(newSize);
+    }
+
+    size_t* header = (size_t*) ((uint8_t*) ptr - sizeof(size_t));
+    size_t oldSize = *header;
+    newSize = align(newSize);
+
+    if (ptr == this->last) {
+      // resize in place
+      size_t start = (uint8_t*) ptr - this->buffer;
+      if (start + newSize > this->size) {
+        return nullptr;
+      }
+
+      *header = newSize;
+      this->pos = start + newSize;
+
+      return ptr;
+
+    } else if (newSize <= oldSize) {
+      return ptr;
+    }
+
+    void* newPtr = this->allocate(newSize);
+    if (newPtr != nullptr) {
+      memcpy(newPtr, ptr, oldSize);
+    }
+
+    return newPtr;
+  }
+
+protected:
+  uint8_t* buffer = nullptr;
+  size_t size = 0;
+  size_t pos = 0;
+  void* last = nullptr;
+
+  static inline size_t align(size_t size) {
+    return (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+  }
+};
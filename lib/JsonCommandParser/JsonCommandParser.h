@@ -0,0 +1,341 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Streaming parser for small json commands.
+ * Walks the payload once, without building a document, and calls the handler
+ * for every scalar value whose path ("section.key") is found in the path table.
+ * Uses a fixed path buffer and a bounded recursion depth, no heap allocation.
+ */
+class JsonCommandParser {
+public:
+  static const uint8_t MAX_DEPTH = 4;
+  static const uint8_t MAX_PATH_LENGTH = 64;
+
+  struct Path {
+    const char* path;
+    uint8_t id;
+  };
+
+  enum class ValueType : uint8_t {
+    NUL,
+    BOOL,
+    NUMBER,
+    STRING
+  };
+
+  struct Value {
+    ValueType type = ValueType::NUL;
+    const char* raw = nullptr;
+    size_t length = 0;
+
+    inline bool isNull() const {
+      return this->type == ValueType::NUL;
+    }
+
+    inline bool isBool() const {
+      return this->type == ValueType::BOOL;
+    }
+
+    inline bool isNumber() const {
+      return this->type == ValueType::NUMBER;
+    }
+
+    inline bool isString() const {
+      return this->type == ValueType::STRING;
+    }
+
+    bool asBool() const {
+      if (this->type == ValueType::BOOL) {
+        return this->raw[0] == 't';
+
+      } else if (this->type == ValueType::NUMBER) {
+        return this->asFloat() != 0.0f;
+      }
+
+      return false;
+    }
+
+    float asFloat() const {
+      if (this->type != ValueType::NUMBER && this->type != ValueType::STRING) {
+        return 0.0f;
+      }
+
+      char buffer[24];
+      this->copyTo(buffer, sizeof(buffer));
+
+      return strtof(buffer, nullptr);
+    }
+
+    long asInt() const {
+      return (long) this->asFloat();
+    }
+
+    size_t copyTo(char* buffer, size_t size) const {
+      if (!size) {
+        return 0;
+      }
+
+      size_t length = this->length < size - 1 ? this->length : size - 1;
+      memcpy(buffer, this->raw, length);
+      buffer[length] = '\0';
+
+      return length;
+    }
+  };
+
+  typedef std::function<void(uint8_t, const Value&)> Handler;
+
+  JsonCommandParser(const Path* table, size_t tableSize) {
+    this->table = table;
+    this->tableSize = tableSize;
+  }
+
+  bool parse(const uint8_t* payload, size_t length, Handler handler) {
+    this->payload = (const char*) payload;
+    this->length = length;
+    this->pos = 0;
+    this->pathLength = 0;
+    this->path[0] = '\0';
+    this->handler = handler;
+
+    this->skipWhitespace();
+    if (this->peek() != '{') {
+      return false;
+    }
+
+    bool result = this->parseValue(0);
+    this->skipWhitespace();
+
+    return result && (this->pos >= this->length || this->peek() == '\0');
+  }
+
+protected:
+  const Path* table = nullptr;
+  size_t tableSize = 0;
+  const char* payload = nullptr;
+  size_t length = 0;
+  size_t pos = 0;
+  char path[MAX_PATH_LENGTH];
+  uint8_t pathLength = 0;
+  bool pathOverflow = false;
+  Handler handler;
+
+  inline char peek() {
+    return this->pos < this->length ? this->payload[this->pos] : '\0';
+  }
+
+  inline void skipWhitespace() {
+    while (this->pos < this->length && isspace(this->payload[this->pos])) {
+      this->pos++;
+    }
+  }
+
+  bool parseValue(uint8_t depth) {
+    this->skipWhitespace();
+
+    Value value;
+    char c = this->peek();
+    if (c == '{') {
+      return this->parseObject(depth + 1);
+
+    } else if (c == '[') {
+      return this->parseArray(depth + 1);
+
+    } else if (c == '"') {
+      if (!this->parseString(value.raw, value.length)) {
+        return false;
+      }
+      value.type = ValueType::STRING;
+
+    } else if (c == 't' || c == 'f' || c == 'n') {
+      size_t start = this->pos;
+      while (this->pos < this->length && isalpha(this->payload[this->pos])) {
+        this->pos++;
+      }
+
+      value.raw = this->payload + start;
+      value.length = this->pos - start;
+
+      if (value.length == 4 && strncmp_P(value.raw, PSTR("true"), 4) == 0) {
+        value.type = ValueType::BOOL;
+
+      } else if (value.length == 5 && strncmp_P(value.raw, PSTR("false"), 5) == 0) {
+        value.type = ValueType::BOOL;
+
+      } else if (value.length == 4 && strncmp_P(value.raw, PSTR("null"), 4) == 0) {
+        value.type = ValueType::NUL;
+
+      } else {
+        return false;
+      }
+
+    } else if (c == '-' || isdigit(c)) {
+      size_t start = this->pos++;
+      while (this->pos < this->length && strchr_P(PSTR("0123456789+-.eE"), this->payload[this->pos]) != nullptr) {
+        this->pos++;
+      }
+
+      value.raw = this->payload + start;
+      value.length = this->pos - start;
+      value.type = ValueType::NUMBER;
+
+    } else {
+      return false;
+    }
+
+    this->dispatch(value);
+
+    return true;
+  }
+
+  bool parseObject(uint8_t depth) {
+    if (depth > MAX_DEPTH) {
+      return false;
+    }
+
+    // skip '{'
+    this->pos++;
+    this->skipWhitespace();
+
+    if (this->peek() == '}') {
+      this->pos++;
+      return true;
+    }
+
+    const uint8_t prevPathLength = this->pathLength;
+    const bool prevPathOverflow = this->pathOverflow;
+
+    while (this->pos < this->length) {
+      const char* key = nullptr;
+      size_t keyLength = 0;
+
+      this->skipWhitespace();
+      if (this->peek() != '"' || !this->parseString(key, keyLength)) {
+        return false;
+      }
+
+      this->skipWhitespace();
+      if (this->peek() != ':') {
+        return false;
+      }
+      this->pos++;
+
+      // append key to path
+      size_t newLength = prevPathLength + (prevPathLength ? 1 : 0) + keyLength;
+      if (prevPathOverflow || newLength >= MAX_PATH_LENGTH) {
+        this->pathOverflow = true;
+
+      } else {
+        if (prevPathLength) {
+          this->path[prevPathLength] = '.';
+        }
+
+        memcpy(this->path + newLength - keyLength, key, keyLength);
+        this->path[newLength] = '\0';
+        this->pathLength = newLength;
+      }
+
+      bool result = this->parseValue(depth);
+
+      // restore path
+      this->pathLength = prevPathLength;
+      this->pathOverflow = prevPathOverflow;
+      this->path[prevPathLength] = '\0';
+
+      if (!result) {
+        return false;
+      }
+
+      this->skipWhitespace();
+      char c = this->peek();
+      this->pos++;
+
+      if (c == '}') {
+        return true;
+
+      } else if (c != ',') {
+        return false;
+      }
+    }
+
+    return false;
+  }
+
+  bool parseArray(uint8_t depth) {
+    if (depth > MAX_DEPTH) {
+      return false;
+    }
+
+    // skip '['
+    this->pos++;
+    this->skipWhitespace();
+
+    if (this->peek() == ']') {
+      this->pos++;
+      return true;
+    }
+
+    // array items are not addressable by the path table
+    const bool prevPathOverflow = this->pathOverflow;
+    this->pathOverflow = true;
+
+    while (this->pos < this->length) {
+      if (!this->parseValue(depth)) {
+        return false;
+      }
+
+      this->skipWhitespace();
+      char c = this->peek();
+      this->pos++;
+
+      if (c == ']') {
+        this->pathOverflow = prevPathOverflow;
+        return true;
+
+      } else if (c != ',') {
+        return false;
+      }
+    }
+
+    return false;
+  }
+
+  bool parseString(const char*& raw, size_t& length) {
+    // skip '"'
+    size_t start = ++this->pos;
+
+    while (this->pos < this->length) {
+      char c = this->payload[this->pos];
+
+      if (c == '\\') {
+        this->pos += 2;
+        continue;
+
+      } else if (c == '"') {
+        raw = this->payload + start;
+        length = this->pos - start;
+        this->pos++;
+
+        return true;
+      }
+
+      this->pos++;
+    }
+
+    return false;
+  }
+
+  void dispatch(const Value& value) {
+    if (this->pathOverflow || !this->pathLength || !this->handler) {
+      return;
+    }
+
+    for (size_t i = 0; i < this->tableSize; i++) {
+      if (strcmp_P(this->path, this->table[i].path) == 0) {
+        this->handler(this->table[i].id, value);
+        break;
+      }
+    }
+  }
+};
@@ -0,0 +1,301 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <deque>
+#include <MqttWriter.h>
+
+
+class MqttQueue {
+public:
+  struct Item {
+    String topic;
+    String payload;
+    unsigned long time = 0;
+    unsigned long sentTime = 0;
+    uint8_t qos = 0;
+    bool retained = false;
+    bool spillable = false;
+    bool sent = false;
+    bool dup = false;
+  };
+
+  MqttQueue(MqttWriter* writer, uint8_t maxItems = 16, size_t maxBytes = 8192) {
+    this->writer = writer;
+    this->maxItems = maxItems;
+    this->maxBytes = maxBytes;
+  }
+
+  MqttQueue* setFs(fs::FS* fs, const char* path, size_t maxSize) {
+    this->fs = fs;
+    this->spoolPath = path;
+    this->spoolMaxSize = maxSize;
+    this->spoolPos = 0;
+    this->hasSpool = fs != nullptr && fs->exists(path);
+
+    return this;
+  }
+
+  MqttQueue* setRetransmitWindow(unsigned long value) {
+    this->retransmitWindow = value;
+
+    return this;
+  }
+
+  inline size_t size() {
+    return this->items.size();
+  }
+
+  inline size_t getBytes() {
+    return this->bytes;
+  }
+
+  inline bool hasSpooled() {
+    return this->hasSpool;
+  }
+
+  void clear() {
+    this->items.clear();
+    this->bytes = 0;
+  }
+
+  bool push(const char* topic, const JsonVariantConst doc, bool retained = false, uint8_t qos = 0, bool spillable = false) {
+    String payload;
+    payload.reserve(measureJson(doc) + 1);
+    serializeJson(doc, payload);
+
+    return this->push(topic, payload, retained, qos, spillable);
+  }
+
+  bool push(const char* topic, const String& payload, bool retained = false, uint8_t qos = 0, bool spillable = false) {
+    if (topic == nullptr) {
+      return false;
+    }
+
+    const size_t length = strlen(topic) + payload.length();
+    if (length > this->maxBytes) {
+      return false;
+    }
+
+    // coalesce by topic, only the latest value is kept in ram
+    for (auto it = this->items.begin(); it != this->items.end(); ++it) {
+      if (!it->topic.equals(topic)) {
+        continue;
+      }
+
+      // offline: keep the history on fs
+      if (!this->online && it->spillable && !it->sent) {
+        this->spill(*it);
+      }
+
+      this->bytes -= it->topic.length() + it->payload.length();
+      this->items.erase(it);
+      break;
+    }
+
+    while (this->items.size() && (this->items.size() >= this->maxItems || this->bytes + length > this->maxBytes)) {
+      auto& item = this->items.front();
+      if (item.spillable) {
+        this->spill(item);
+      }
+
+      this->bytes -= item.topic.length() + item.payload.length();
+      this->items.pop_front();
+    }
+
+    Item item;
+    item.topic = topic;
+    item.payload = payload;
+    item.time = this->getTime();
+    item.qos = qos;
+    item.retained = retained;
+    item.spillable = spillable;
+    this->items.push_back(std::move(item));
+    this->bytes += length;
+
+    return true;
+  }
+
+  size_t process(bool connected, uint8_t maxMessages = 8) {
+    if (!connected) {
+      if (this->online) {
+        this->online = false;
+
+        // the connection was lost: qos 1 messages sent recently may not have reached the broker
+        for (auto& item : this->items) {
+          if (item.sent && millis() - item.sentTime < this->retransmitWindow) {
+            item.sent = false;
+            item.dup = true;
+          }
+        }
+      }
+
+      return 0;
+    }
+
+    this->online = true;
+
+    size_t published = 0;
+    if (this->hasSpool) {
+      published += this->replay(maxMessages);
+
+      // replay the spooled history before the latest values
+      if (this->hasSpool) {
+        return published;
+      }
+    }
+
+    for (auto it = this->items.begin(); it != this->items.end();) {
+      if (it->sent) {
+        if (millis() - it->sentTime >= this->retransmitWindow) {
+          this->bytes -= it->topic.length() + it->payload.length();
+          it = this->items.erase(it);
+
+        } else {
+          ++it;
+        }
+
+        continue;
+      }
+
+      if (published >= maxMessages) {
+        break;
+      }
+
+      bool result = this->writer->publish(
+        it->topic.c_str(),
+        (const uint8_t*) it->payload.c_str(),
+        it->payload.length(),
+        it->retained,
+        it->qos,
+        it->dup
+      );
+
+      if (!result) {
+        break;
+      }
+
+      published++;
+
+      if (it->qos > 0 && this->retransmitWindow > 0) {
+        it->sent = true;
+        it->sentTime = millis();
+        ++it;
+
+      } else {
+        this->bytes -= it->topic.length() + it->payload.length();
+        it = this->items.erase(it);
+      }
+    }
+
+    return published;
+  }
+
+protected:
+  MqttWriter* writer = nullptr;
+  fs::FS* fs = nullptr;
+  std::deque<Item> items;
+  const char* spoolPath = nullptr;
+  size_t spoolMaxSize = 0;
+  size_t spoolPos = 0;
+  size_t bytes = 0;
+  size_t maxBytes = 8192;
+  uint8_t maxItems = 16;
+  unsigned long retransmitWindow = 0;
+  bool hasSpool = false;
+  bool online = false;
+
+  unsigned long getTime() {
+    time_t now = time(nullptr);
+
+    // not synced
+    if (now < 1700000000) {
+      return 0;
+    }
+
+    return (unsigned long) now;
+  }
+
+  bool spill(const Item& item) {
+    if (this->fs == nullptr) {
+      return false;
+    }
+
+    File file = this->fs->open(this->spoolPath, "a");
+    if (!file) {
+      return false;
+    }
+
+    const size_t length = item.topic.length() + item.payload.length() + 20;
+    if (file.size() + length > this->spoolMaxSize) {
+      file.close();
+      return false;
+    }
+
+    // record format: "<topic>\t<payload>\n", the capture time is added to json objects
+    file.print(item.topic);
+    file.print('\t');
+
+    if (item.time && item.payload.length() > 2 && item.payload[0] == '{') {
+      file.print(F("{\"ts\":"));
+      file.print(item.time);
+      file.print(',');
+      file.print(item.payload.c_str() + 1);
+
+    } else {
+      file.print(item.payload);
+    }
+
+    file.print('\n');
+    file.close();
+
+    this->hasSpool = true;
+
+    return true;
+  }
+
+  size_t replay(uint8_t maxMessages) {
+    File file = this->fs->open(this->spoolPath, "r");
+    if (!file) {
+      this->hasSpool = false;
+      this->spoolPos = 0;
+
+      return 0;
+    }
+
+    size_t published = 0;
+    file.seek(this->spoolPos);
+    while (published < maxMessages && file.available()) {
+      String topic = file.readStringUntil('\t');
+      String payload = file.readStringUntil('\n');
+
+      if (topic.length() && payload.length()) {
+        // history is never retained, the latest value is published from ram
+        bool result = this->writer->publish(
+          topic.c_str(),
+          (const uint8_t*) payload.c_str(),
+          payload.length(),
+          false
+        );
+
+        if (!result) {
+          break;
+        }
+
+        published++;
+      }
+
+      this->spoolPos = file.position();
+    }
+
+    bool eof = !file.available();
+    file.close();
+
+    if (eof) {
+      this->fs->remove(this->spoolPath);
+      this->hasSpool = false;
+      this->spoolPos = 0;
+    }
+
+    return published;
+  }
+};
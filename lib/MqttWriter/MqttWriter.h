@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include <MqttClient.h>
+#include <lwip/opt.h>
 #ifdef ARDUINO_ARCH_ESP32
 #include <mutex>
 #endif
@@ -12,7 +13,7 @@ public:
   typedef std::function<void(const char*, size_t, size_t, bool)> PublishEventCallback;
   typedef std::function<void(size_t, size_t)> FlushEventCallback;
 
-  MqttWriter(MqttClient* client, size_t bufferSize = 64) {
+  MqttWriter(MqttClient* client, size_t bufferSize = TCP_MSS) {
     this->client = client;
     this->bufferSize = bufferSize;
     this->buffer = (uint8_t*) malloc(bufferSize * sizeof(*this->buffer));
@@ -77,7 +78,7 @@ public:
 #endif
   }
 
-  bool publish(const char* topic, const JsonVariantConst doc, bool retained = false) {
+  bool publish(const char* topic, const JsonVariantConst doc, bool retained = false, uint8_t qos = 0, bool dup = false) {
     if (!this->client->connected()) {
       this->bufferPos = 0;
       return false;
@@ -92,7 +93,8 @@ public:
     this->bufferPos = 0;
     size_t docSize = measureJson(doc);
     size_t written = 0;
-    if (this->client->beginMessage(topic, docSize, retained)) {
+    if (this->client->beginMessage(topic, docSize, retained, qos, dup)) {
+      // the payload goes out in mss sized segments, flushed once at the end of the message
       serializeJson(doc, *this);
       this->flush();
       this->client->endMessage();
@@ -112,7 +114,7 @@ public:
     return this->publish(topic, (const uint8_t*) buffer, strlen(buffer), retained);
   }
 
-  bool publish(const char* topic, const uint8_t* buffer, size_t length, bool retained = false) {
+  bool publish(const char* topic, const uint8_t* buffer, size_t length, bool retained = false, uint8_t qos = 0, bool dup = false) {
     if (!this->client->connected()) {
       this->bufferPos = 0;
       return false;
@@ -128,9 +130,9 @@ public:
     size_t written = 0;
     bool result = false;
     if (!length || buffer == nullptr) {
-      result = this->client->beginMessage(topic, retained) && this->client->endMessage();
+      result = this->client->beginMessage(topic, retained, qos, dup) && this->client->endMessage();
 
-    } else if (this->client->beginMessage(topic, length, retained)) {
+    } else if (this->client->beginMessage(topic, length, retained, qos, dup)) {
       this->write(buffer, length);
       this->flush();
       this->client->endMessage();
@@ -151,7 +153,7 @@ public:
     this->buffer[this->bufferPos++] = c;
 
     if (this->bufferPos >= this->bufferSize) {
-      this->flush();
+      this->send();
     }
 
     return 1;
@@ -160,6 +162,16 @@ public:
   size_t write(const uint8_t* buffer, size_t length) {
     size_t written = 0;
     while (written < length) {
+      // large blocks are written directly, without copying into the buffer
+      if (this->bufferPos == 0 && length - written >= this->bufferSize) {
+        if (!this->send(buffer + written, length - written)) {
+          break;
+        }
+
+        written = length;
+        break;
+      }
+
       size_t copySize = this->bufferSize - this->bufferPos;
       if (written + copySize > length) {
         copySize = length - written;
@@ -169,7 +181,7 @@ public:
       this->bufferPos += copySize;
 
       if (this->bufferPos >= this->bufferSize) {
-        this->flush();
+        this->send();
       }
 
       written += copySize;
@@ -179,28 +191,14 @@ public:
   }
 
   bool flush() {
-    if (this->bufferPos == 0) {
-      return false;
-    }
-
-    if (!this->client->connected()) {
-      this->bufferPos = 0;
-    }
-
-    size_t length = this->bufferPos;
-    size_t written = this->client->write(this->buffer, length);
+    bool result = this->send();
     this->client->flush();
-    this->bufferPos = 0;
-
-    if (this->isLocked()) {
-      this->writeAfterLock += written;
-    }
 
     if (this->flushEventCallback) {
-      this->flushEventCallback(written, length);
+      this->flushEventCallback(this->writeAfterLock, this->writeAfterLock);
     }
 
-    return written == length;
+    return result;
   }
 
 protected:
@@ -217,4 +215,28 @@ protected:
 #endif
   unsigned long lockedTime = 0;
   size_t writeAfterLock = 0;
+
+  bool send() {
+    if (this->bufferPos == 0) {
+      return true;
+    }
+
+    size_t length = this->bufferPos;
+    this->bufferPos = 0;
+
+    return this->send(this->buffer, length);
+  }
+
+  bool send(const uint8_t* buffer, size_t length) {
+    if (!this->client->connected()) {
+      return false;
+    }
+
+    size_t written = this->client->write(buffer, length);
+    if (this->isLocked()) {
+      this->writeAfterLock += written;
+    }
+
+    return written == length;
+  }
 };
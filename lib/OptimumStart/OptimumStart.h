@@ -0,0 +1,128 @@
+#pragma once
+#include <Arduino.h>
+#include <RlsEstimator.h>
+
+/**
+ * Optimum start: predicts how long the room takes to reach a higher target.
+ *
+ * The heat-up rate is modelled as rate = base - loss * (indoor - outdoor) in degrees per hour,
+ * the more heat is lost to the outside, the slower the room warms up. Both coefficients
+ * are fitted by recursive least squares from observed heat-ups: the time from a target
+ * increase to the indoor temp reaching it. Temps are in celsius.
+ */
+class OptimumStart {
+public:
+  static constexpr float MIN_RATE = 0.2f;
+  static constexpr float MIN_RISE = 0.5f;
+  static const unsigned long MIN_DURATION = 900;
+  static const unsigned long MAX_DURATION = 43200;
+
+  OptimumStart() {
+    this->estimator.setForgetting(0.95f);
+  }
+
+  void reset(float base, float loss) {
+    const float theta[2] = {base, loss};
+    const float variance[2] = {1.0f, 0.001f};
+
+    this->estimator.reset(theta, variance);
+    this->abort();
+  }
+
+  // degrees per hour
+  float getRate(float indoorTemp, float outdoorTemp) const {
+    // a negative loss is a fit artefact, a colder outside never speeds up the heat-up
+    const float loss = this->getLoss() > 0.0f ? this->getLoss() : 0.0f;
+    const float rate = this->getBase() - loss * (indoorTemp - outdoorTemp);
+
+    return rate > MIN_RATE ? rate : MIN_RATE;
+  }
+
+  // seconds, 0 if the target has been reached
+  unsigned long getPreheatTime(float indoorTemp, float target, float outdoorTemp) const {
+    const float rise = target - indoorTemp;
+    if (rise <= 0.0f) {
+      return 0;
+    }
+
+    // the rate at the middle of the heat-up
+    return rise / this->getRate(indoorTemp + rise / 2.0f, outdoorTemp) * 3600.0f;
+  }
+
+  /**
+   * Starts observing a heat-up towards the target.
+   */
+  void start(float target, float indoorTemp, float outdoorTemp) {
+    this->observing = target - indoorTemp >= MIN_RISE;
+    this->target = target;
+    this->startTime = millis();
+    this->startIndoorTemp = indoorTemp;
+    this->outdoorTemp = outdoorTemp;
+    this->samples = 1;
+  }
+
+  inline void abort() {
+    this->observing = false;
+  }
+
+  inline bool isObserving() const {
+    return this->observing;
+  }
+
+  /**
+   * Returns true when the observed heat-up has finished and the model has been updated.
+   */
+  bool update(float target, float indoorTemp, float outdoorTemp) {
+    if (!this->observing) {
+      return false;
+    }
+
+    const unsigned long duration = (millis() - this->startTime) / 1000ul;
+    if (fabsf(target - this->target) > 0.0001f || duration > MAX_DURATION) {
+      this->abort();
+      return false;
+    }
+
+    this->outdoorTemp += outdoorTemp;
+    this->samples++;
+
+    if (indoorTemp < this->target - 0.1f) {
+      return false;
+    }
+
+    this->abort();
+
+    const float rise = indoorTemp - this->startIndoorTemp;
+    if (duration < MIN_DURATION || rise < MIN_RISE) {
+      return false;
+    }
+
+    const float avgIndoorTemp = (this->startIndoorTemp + indoorTemp) / 2.0f;
+    const float avgOutdoorTemp = this->outdoorTemp / this->samples;
+    const float phi[2] = {1.0f, -(avgIndoorTemp - avgOutdoorTemp)};
+    this->estimator.update(phi, rise / (duration / 3600.0f));
+
+    return true;
+  }
+
+  inline float getBase() const {
+    return this->estimator.get(0);
+  }
+
+  inline float getLoss() const {
+    return this->estimator.get(1);
+  }
+
+  inline uint16_t getSamples() const {
+    return this->estimator.getSamples();
+  }
+
+protected:
+  RlsEstimator<2> estimator;
+  bool observing = false;
+  float target = 0.0f;
+  unsigned long startTime = 0;
+  float startIndoorTemp = 0.0f;
+  float outdoorTemp = 0.0f;
+  uint16_t samples = 0;
+};
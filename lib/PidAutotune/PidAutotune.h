@@ -0,0 +1,260 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Relay feedback (Astrom-Hagglund) experiment.
+ * The output is switched between base + step and base - step every time the input crosses
+ * the setpoint (with hysteresis), the loop settles into a limit cycle with the ultimate period Tu
+ * and amplitude a, that gives the ultimate gain Ku = 4 * step / (pi * sqrt(a^2 - hysteresis^2)).
+ *
+ * Gains are proposed by the Tyreus-Luyben PI rule: Kp = Ku / 3.2, Ti = 2.2 * Tu.
+ * It is much less aggressive than Ziegler-Nichols, which suits slow rooms with a long dead time,
+ * the derivative is not used because the indoor temp is too coarse for it.
+ * Ki and Kd are returned in GyverPID units (per second and seconds).
+ */
+class PidAutotune {
+public:
+  enum class State : uint8_t {
+    IDLE      = 0,
+    RUNNING   = 1,
+    DONE      = 2,
+    ABORTED   = 3,
+    FAILED    = 4
+  };
+
+  static const uint8_t MEASURED_CYCLES = 3;
+
+  PidAutotune* setHysteresis(float value) {
+    this->hysteresis = value;
+
+    return this;
+  }
+
+  PidAutotune* setMaxCycles(uint8_t value) {
+    this->maxCycles = value;
+
+    return this;
+  }
+
+  PidAutotune* setTimeout(unsigned long value) {
+    this->timeout = value;
+
+    return this;
+  }
+
+  PidAutotune* setTolerance(float value) {
+    this->tolerance = value;
+
+    return this;
+  }
+
+  void start(float setpoint, float base, float step) {
+    this->setpoint = setpoint;
+    this->highOutput = base + step;
+    this->lowOutput = base - step;
+    this->output = this->highOutput;
+    this->relayHigh = true;
+
+    this->state = State::RUNNING;
+    this->startTime = millis();
+    this->cycleStartTime = 0;
+    this->cycles = 0;
+    this->measured = 0;
+    this->cycleMax = -1000.0f;
+    this->cycleMin = 1000.0f;
+    this->ultimateGain = 0.0f;
+    this->ultimatePeriod = 0.0f;
+  }
+
+  void abort() {
+    if (this->state == State::RUNNING) {
+      this->state = State::ABORTED;
+    }
+  }
+
+  void reset() {
+    this->state = State::IDLE;
+    this->cycles = 0;
+    this->measured = 0;
+  }
+
+  /**
+   * Feeds a new input sample, returns the relay output.
+   */
+  float update(float input) {
+    if (this->state != State::RUNNING) {
+      return this->output;
+    }
+
+    if (millis() - this->startTime > this->timeout * 1000ul) {
+      this->state = State::FAILED;
+
+      return this->output;
+    }
+
+    if (input > this->cycleMax) {
+      this->cycleMax = input;
+    }
+
+    if (input < this->cycleMin) {
+      this->cycleMin = input;
+    }
+
+    if (this->relayHigh && input > this->setpoint + this->hysteresis) {
+      this->relayHigh = false;
+      this->output = this->lowOutput;
+
+    } else if (!this->relayHigh && input < this->setpoint - this->hysteresis) {
+      // a full cycle ends on every switch to the high output
+      this->relayHigh = true;
+      this->output = this->highOutput;
+      this->onCycle();
+    }
+
+    return this->output;
+  }
+
+  inline State getState() const {
+    return this->state;
+  }
+
+  inline bool isRunning() const {
+    return this->state == State::RUNNING;
+  }
+
+  inline float getSetpoint() const {
+    return this->setpoint;
+  }
+
+  inline uint8_t getCycles() const {
+    return this->cycles;
+  }
+
+  uint8_t getProgress() const {
+    if (this->state == State::DONE) {
+      return 100;
+
+    } else if (this->state != State::RUNNING) {
+      return 0;
+    }
+
+    // the first cycle is the transient from the start point
+    const uint8_t total = MEASURED_CYCLES + 1;
+
+    return (this->cycles < total ? this->cycles : total) * 99 / total;
+  }
+
+  inline float getUltimateGain() const {
+    return this->ultimateGain;
+  }
+
+  // in seconds
+  inline float getUltimatePeriod() const {
+    return this->ultimatePeriod;
+  }
+
+  inline float getKp() const {
+    return this->ultimateGain / 3.2f;
+  }
+
+  inline float getKi() const {
+    return this->ultimatePeriod > 0.0f
+      ? this->getKp() / (2.2f * this->ultimatePeriod)
+      : 0.0f;
+  }
+
+  inline float getKd() const {
+    return 0.0f;
+  }
+
+protected:
+  State state = State::IDLE;
+  float hysteresis = 0.1f;
+  float tolerance = 0.2f;
+  uint8_t maxCycles = 10;
+  unsigned long timeout = 43200;
+
+  float setpoint = 0.0f;
+  float highOutput = 0.0f;
+  float lowOutput = 0.0f;
+  float output = 0.0f;
+  bool relayHigh = true;
+
+  unsigned long startTime = 0;
+  unsigned long cycleStartTime = 0;
+  uint8_t cycles = 0;
+  uint8_t measured = 0;
+  float cycleMax = 0.0f;
+  float cycleMin = 0.0f;
+  float amplitudes[MEASURED_CYCLES] = {};
+  float periods[MEASURED_CYCLES] = {};
+
+  float ultimateGain = 0.0f;
+  float ultimatePeriod = 0.0f;
+
+  void onCycle() {
+    const unsigned long now = millis();
+
+    if (this->cycleStartTime != 0) {
+      this->cycles++;
+
+      // skip the transient cycle
+      if (this->cycles > 1) {
+        const uint8_t index = this->measured++ % MEASURED_CYCLES;
+        this->amplitudes[index] = (this->cycleMax - this->cycleMin) / 2.0f;
+        this->periods[index] = (now - this->cycleStartTime) / 1000.0f;
+
+        if (this->measured >= MEASURED_CYCLES && this->isConverged()) {
+          this->finish();
+
+        } else if (this->cycles >= this->maxCycles) {
+          this->state = State::FAILED;
+        }
+      }
+    }
+
+    this->cycleStartTime = now;
+    this->cycleMax = this->setpoint;
+    this->cycleMin = this->setpoint;
+  }
+
+  bool isConverged() const {
+    return this->getSpread(this->amplitudes) <= this->tolerance
+      && this->getSpread(this->periods) <= this->tolerance;
+  }
+
+  // (max - min) / mean
+  static float getSpread(const float* values) {
+    float lowest = values[0], highest = values[0], sum = 0.0f;
+
+    for (uint8_t i = 0; i < MEASURED_CYCLES; i++) {
+      lowest = values[i] < lowest ? values[i] : lowest;
+      highest = values[i] > highest ? values[i] : highest;
+      sum += values[i];
+    }
+
+    return sum > 0.0f ? (highest - lowest) / (sum / MEASURED_CYCLES) : 1.0f;
+  }
+
+  void finish() {
+    float amplitude = 0.0f, period = 0.0f;
+    for (uint8_t i = 0; i < MEASURED_CYCLES; i++) {
+      amplitude += this->amplitudes[i];
+      period += this->periods[i];
+    }
+
+    amplitude /= MEASURED_CYCLES;
+    period /= MEASURED_CYCLES;
+
+    // the oscillation must be clearly larger than the relay hysteresis
+    if (amplitude <= this->hysteresis * 1.1f) {
+      this->state = State::FAILED;
+      return;
+    }
+
+    const float step = (this->highOutput - this->lowOutput) / 2.0f;
+    this->ultimateGain = 4.0f * step / (PI * sqrtf(amplitude * amplitude - this->hysteresis * this->hysteresis));
+    this->ultimatePeriod = period;
+    this->state = State::DONE;
+  }
+};
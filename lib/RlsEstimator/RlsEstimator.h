@@ -0,0 +1,105 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Recursive least squares for y = theta * phi with exponential forgetting.
+ * The forgetting is suspended while the trace of P is above its initial value,
+ * so the covariance does not wind up while the input is not exciting
+ * (e.g. days with a constant outdoor temp).
+ */
+template <uint8_t N>
+class RlsEstimator {
+public:
+  RlsEstimator* setForgetting(float value) {
+    this->forgetting = value;
+
+    return this;
+  }
+
+  void reset(const float* theta, const float* variance) {
+    this->maxTrace = 0.0f;
+
+    for (uint8_t i = 0; i < N; i++) {
+      this->theta[i] = theta[i];
+
+      for (uint8_t j = 0; j < N; j++) {
+        this->p[i][j] = i == j ? variance[i] : 0.0f;
+      }
+
+      this->maxTrace += variance[i];
+    }
+
+    this->samples = 0;
+  }
+
+  // returns the a priori error
+  float update(const float* phi, float y) {
+    float pPhi[N];
+    const float lambda = this->getTrace() < this->maxTrace ? this->forgetting : 1.0f;
+    float denominator = lambda;
+
+    for (uint8_t i = 0; i < N; i++) {
+      pPhi[i] = 0.0f;
+
+      for (uint8_t j = 0; j < N; j++) {
+        pPhi[i] += this->p[i][j] * phi[j];
+      }
+
+      denominator += phi[i] * pPhi[i];
+    }
+
+    float error = y;
+    for (uint8_t i = 0; i < N; i++) {
+      error -= this->theta[i] * phi[i];
+    }
+
+    for (uint8_t i = 0; i < N; i++) {
+      this->theta[i] += pPhi[i] / denominator * error;
+    }
+
+    // P = (P - P*phi*phi'*P / denominator) / lambda, P is symmetric
+    for (uint8_t i = 0; i < N; i++) {
+      for (uint8_t j = 0; j < N; j++) {
+        this->p[i][j] = (this->p[i][j] - pPhi[i] * pPhi[j] / denominator) / lambda;
+      }
+    }
+
+    if (this->samples < UINT16_MAX) {
+      this->samples++;
+    }
+
+    return error;
+  }
+
+  inline float get(uint8_t index) const {
+    return this->theta[index];
+  }
+
+  inline void set(uint8_t index, float value) {
+    this->theta[index] = value;
+  }
+
+  inline float getVariance(uint8_t index) const {
+    return this->p[index][index];
+  }
+
+  inline uint16_t getSamples() const {
+    return this->samples;
+  }
+
+protected:
+  float forgetting = 0.98f;
+  float maxTrace = 0.0f;
+  float theta[N] = {};
+  float p[N][N] = {};
+  uint16_t samples = 0;
+
+  float getTrace() const {
+    float result = 0.0f;
+    for (uint8_t i = 0; i < N; i++) {
+      result += this->p[i][i];
+    }
+
+    return result;
+  }
+};
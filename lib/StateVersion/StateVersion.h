@@ -0,0 +1,106 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Monotonic version of a piece of state, bumped whenever the content hash changes.
+ * Hashing the raw state is much cheaper than serializing it, so the version
+ * can be used as an ETag and checked before any json is built.
+ */
+class StateVersion {
+public:
+  StateVersion(const char* salt = nullptr) {
+    if (salt != nullptr) {
+      this->basis = this->hashBytes(this->basis, salt, strlen(salt));
+    }
+  }
+
+  StateVersion* begin() {
+    this->pendingHash = this->basis;
+
+    return this;
+  }
+
+  /**
+   * Puts a boot epoch into the high half of the version, so a version
+   * remembered by a client before a reboot is not mistaken for a current one.
+   */
+  StateVersion* setEpoch(uint16_t epoch) {
+    this->version = (uint32_t) epoch << 16;
+    this->committed = false;
+
+    return this;
+  }
+
+  inline uint16_t getEpoch() {
+    return this->epochOf(this->version);
+  }
+
+  static inline uint16_t epochOf(uint32_t version) {
+    return version >> 16;
+  }
+
+  StateVersion* add(const void* data, size_t length) {
+    this->pendingHash = this->hashBytes(this->pendingHash, data, length);
+
+    return this;
+  }
+
+  StateVersion* add(const String& value) {
+    return this->add(value.c_str(), value.length());
+  }
+
+  template <class T>
+  StateVersion* add(const T& value) {
+    return this->add(&value, sizeof(T));
+  }
+
+  uint32_t commit() {
+    if (!this->committed || this->pendingHash != this->hash) {
+      this->hash = this->pendingHash;
+      this->version++;
+      this->committed = true;
+    }
+
+    return this->version;
+  }
+
+  template <class T>
+  uint32_t update(const T& value) {
+    return this->begin()->add(value)->commit();
+  }
+
+  inline uint32_t get() {
+    return this->version;
+  }
+
+  // hash of the content added since begin(), before it is committed
+  inline uint32_t getPendingHash() {
+    return this->pendingHash;
+  }
+
+  String getETag() {
+    char buffer[20];
+    snprintf_P(buffer, sizeof(buffer), PSTR("\"%lx-%08lx\""), (unsigned long) this->version, (unsigned long) this->hash);
+
+    return String(buffer);
+  }
+
+protected:
+  uint32_t basis = 2166136261UL;
+  uint32_t hash = 0;
+  uint32_t pendingHash = 0;
+  uint32_t version = 0;
+  bool committed = false;
+
+  // FNV-1a
+  static uint32_t hashBytes(uint32_t hash, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*) data;
+
+    for (size_t i = 0; i < length; i++) {
+      hash ^= bytes[i];
+      hash *= 16777619UL;
+    }
+
+    return hash;
+  }
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <FS.h>
+#include <vector>
+
+
+/**
+ * Content hashes of the built web assets, generated by gulp (data/manifest.json).
+ * Loaded once, turns ETag and gzip variant selection into a table lookup.
+ */
+class AssetsManifest {
+public:
+  static const uint8_t HASH_LENGTH = 16;
+
+  struct Asset {
+    String uri;
+    char hash[HASH_LENGTH + 1];
+    bool gzip;
+  };
+
+  AssetsManifest(FS* fs, const char* path) {
+    this->fs = fs;
+    this->path = path;
+  }
+
+  bool load() {
+    this->assets.clear();
+
+    File file = this->fs->open(this->path, "r");
+    if (!file) {
+      return false;
+    }
+
+    JsonDocument doc;
+    DeserializationError dErr = deserializeJson(doc, file);
+    file.close();
+
+    if (dErr != DeserializationError::Ok || !doc.is<JsonObject>()) {
+      return false;
+    }
+
+    for (JsonPairConst item : doc.as<JsonObjectConst>()) {
+      const char* hash = item.value()["hash"];
+      if (hash == nullptr || strlen(hash) != HASH_LENGTH) {
+        continue;
+      }
+
+      Asset asset;
+      asset.uri = item.key().c_str();
+      strcpy(asset.hash, hash);
+      asset.gzip = item.value()["gzip"] | false;
+
+      this->assets.push_back(std::move(asset));
+    }
+
+    this->assets.shrink_to_fit();
+
+    return true;
+  }
+
+  inline size_t size() {
+    return this->assets.size();
+  }
+
+  const Asset* find(const String& uri) {
+    for (auto& asset : this->assets) {
+      if (asset.uri.equals(uri)) {
+        return &asset;
+      }
+    }
+
+    return nullptr;
+  }
+
+  static String getETag(const Asset* asset) {
+    String eTag;
+    eTag.reserve(HASH_LENGTH + 2);
+    eTag += '\"';
+    eTag += asset->hash;
+    eTag += '\"';
+
+    return eTag;
+  }
+
+  static String getFilePath(const Asset* asset) {
+    if (!asset->gzip) {
+      return asset->uri;
+    }
+
+    String filePath;
+    filePath.reserve(asset->uri.length() + 3);
+    filePath += asset->uri;
+    filePath += F(".gz");
+
+    return filePath;
+  }
+
+protected:
+  FS* fs = nullptr;
+  const char* path = nullptr;
+  std::vector<Asset> assets;
+};
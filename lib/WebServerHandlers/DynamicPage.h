@@ -1,4 +1,6 @@
 #include <FS.h>
+#include <vector>
+#include <lwip/opt.h>
 
 
 class DynamicPage : public RequestHandler {
@@ -6,6 +8,14 @@ public:
   typedef std::function<bool(HTTPMethod, const String&)> CanHandleCallback;
   typedef std::function<bool()> BeforeSendCallback;
   typedef std::function<String(const char*)> TemplateCallback;
+
+  static const uint8_t MAX_NAME_LENGTH = 15;
+
+  struct Placeholder {
+    size_t offset;
+    uint8_t length;
+    uint8_t id;
+  };
   
   DynamicPage(const char* uri, FS* fs, const char* path, const char* cacheHeader = nullptr) {
     this->uri = uri;
@@ -60,12 +70,29 @@ public:
       return false;
     }
 
+    if (this->compiledSize != file.size() || this->compiledTime != file.getLastWrite()) {
+      this->compile(file);
+    }
+
+    this->bufferSize = TCP_MSS - 8;
+    this->bufferPos = 0;
+    this->buffer = (uint8_t*) malloc(this->bufferSize);
+    if (this->buffer == nullptr) {
+      file.close();
+      server.send(503);
+      return true;
+    }
+
     if (this->cacheHeader != nullptr) {
       server.sendHeader(F("Cache-Control"), this->cacheHeader);
     }
 
     #ifdef ARDUINO_ARCH_ESP8266
     if (!server.chunkedResponseModeStart(200, F("text/html"))) {
+      free(this->buffer);
+      this->buffer = nullptr;
+      file.close();
+
       server.send(505, F("text/html"), F("HTTP1.1 required"));
       return true;
     }
@@ -74,134 +101,36 @@ public:
     server.send(200, "text/html", emptyString);
     #endif
 
-    uint8_t* argStartPos = nullptr;
-    uint8_t* argEndPos = nullptr;
-    uint8_t argName[16];
-    size_t sizeArgName = 0;
-    bool argNameProcess = false;
-    while (file.available()) {
-      uint8_t buf[64];
-      size_t length = file.read(buf, sizeof(buf));
-      size_t offset = 0;
-
-      if (argNameProcess) {
-        argEndPos = (uint8_t*) memchr(buf, '}', length);
-        
-        if (argEndPos != nullptr) {
-          size_t fullSizeArgName = sizeArgName + (argEndPos - buf);
-          if (fullSizeArgName < sizeof(argName)) {
-            // copy full arg name
-            if (argEndPos - buf > 0) {
-              memcpy(argName + sizeArgName, buf, argEndPos - buf);
-            }
-            argName[fullSizeArgName] = '\0';
-
-            // send arg value
-            String argValue = this->templateCallback((const char*) argName);
-            if (argValue.length()) {
-              server.sendContent(argValue.c_str());
-
-            } else if (fullSizeArgName > 0) {
-              server.sendContent("{");
-              server.sendContent((const char*) argName);
-              server.sendContent("}");
-            }
-
-            offset = size_t(argEndPos - buf + 1);
-            sizeArgName = 0;
-            argNameProcess = false;
-          }
-        }
-
-        if (argNameProcess) {
-          server.sendContent("{");
-
-          if (sizeArgName > 0) {
-            argName[sizeArgName] = '\0';
-            server.sendContent((const char*) argName);
-          }
-
-          argNameProcess = false;
-        }
+    // values are resolved once per request, a name can be used many times
+    std::vector<String> values(this->names.size());
+    if (this->templateCallback) {
+      for (size_t i = 0; i < this->names.size(); i++) {
+        values[i] = this->templateCallback(this->names[i].c_str());
       }
+    }
 
-      do {
-        uint8_t* currentBuf = buf + offset;
-        size_t currentLength = length - offset;
-
-        argStartPos = (uint8_t*) memchr(currentBuf, '{', currentLength);
-
-        // send all content
-        if (argStartPos == nullptr) {
-          if (currentLength > 0) {
-            server.sendContent((const char*) currentBuf, currentLength);
-          }
-
-          break;
-        }
-        
-        argEndPos = (uint8_t*) memchr(argStartPos, '}', length - (argStartPos - buf));
-        if (argEndPos != nullptr) {
-          sizeArgName = argEndPos - argStartPos - 1;
-
-          // send all content if arg len > space
-          if (sizeArgName >= sizeof(argName)) {
-            if (currentLength > 0) {
-              server.sendContent((const char*) currentBuf, currentLength);
-            }
-
-            break;
-          }
-          
-          // arg name
-          memcpy(argName, argStartPos + 1, sizeArgName);
-          argName[sizeArgName] = '\0';
-
-          // send arg value
-          String argValue = this->templateCallback((const char*) argName);
-          if (argValue.length()) {
-            // send content before var
-            if (argStartPos - buf > 0) {
-              server.sendContent((const char*) currentBuf, argStartPos - buf);
-            }
-
-            server.sendContent(argValue.c_str());
-            
-          } else {
-            server.sendContent((const char*) currentBuf, argEndPos - currentBuf + 1);
-          }
-
-          offset = size_t(argEndPos - currentBuf + 1);
-
-        } else {
-          sizeArgName = length - size_t(argStartPos - currentBuf) - 1;
-
-          // send all content if arg len > space
-          if (sizeArgName >= sizeof(argName)) {
-            if (currentLength) {
-              server.sendContent((const char*) currentBuf, currentLength);
-            }
+    // literal spans are streamed from the file into the output buffer,
+    // placeholders without a value stay in the literal as is
+    size_t pos = 0;
+    for (auto& placeholder : this->placeholders) {
+      const String& value = values[placeholder.id];
+      if (!value.length()) {
+        continue;
+      }
 
-            break;
-          }
+      this->writeFromFile(server, file, placeholder.offset - pos);
+      this->write(server, (const uint8_t*) value.c_str(), value.length());
 
-          // send content before var
-          if (argStartPos - buf > 0) {
-            server.sendContent((const char*) currentBuf, argStartPos - buf);
-          }
+      pos = placeholder.offset + placeholder.length;
+      file.seek(pos);
+    }
 
-          // copy arg name chunk
-          if (sizeArgName > 0) {
-            memcpy(argName, argStartPos + 1, sizeArgName);
-          }
+    this->writeFromFile(server, file, file.size() - pos);
+    this->flush(server);
 
-          argNameProcess = true;
+    free(this->buffer);
+    this->buffer = nullptr;
 
-          break;
-        }
-      } while(true);
-    }
-    
     file.close();
 
     #ifdef ARDUINO_ARCH_ESP8266
@@ -221,4 +150,134 @@ protected:
   const char* uri = nullptr;
   const char* path = nullptr;
   const char* cacheHeader = nullptr;
+
+  std::vector<Placeholder> placeholders;
+  std::vector<String> names;
+  size_t compiledSize = 0;
+  time_t compiledTime = 0;
+
+  uint8_t* buffer = nullptr;
+  size_t bufferSize = 0;
+  size_t bufferPos = 0;
+
+  static inline bool isNameChar(char c) {
+    return isAlphaNumeric(c) || c == '_' || c == '-' || c == '.';
+  }
+
+  /**
+   * Builds the placeholder index: offsets of every "{name}" in the file.
+   * Done once, the template is rebuilt only when the file changes.
+   */
+  void compile(File& file) {
+    this->placeholders.clear();
+    this->names.clear();
+
+    char name[MAX_NAME_LENGTH + 1];
+    int8_t nameLength = -1;
+    size_t startPos = 0;
+    size_t pos = 0;
+
+    while (file.available()) {
+      uint8_t buf[128];
+      size_t length = file.read(buf, sizeof(buf));
+
+      for (size_t i = 0; i < length; i++, pos++) {
+        const char c = buf[i];
+
+        if (c == '{') {
+          startPos = pos;
+          nameLength = 0;
+
+        } else if (nameLength < 0) {
+          continue;
+
+        } else if (c == '}' && nameLength > 0) {
+          name[nameLength] = '\0';
+          this->addPlaceholder(startPos, pos - startPos + 1, name);
+          nameLength = -1;
+
+        } else if (isNameChar(c) && nameLength < MAX_NAME_LENGTH) {
+          name[nameLength++] = c;
+
+        } else {
+          nameLength = -1;
+        }
+      }
+    }
+
+    this->placeholders.shrink_to_fit();
+    this->names.shrink_to_fit();
+    this->compiledSize = file.size();
+    this->compiledTime = file.getLastWrite();
+
+    file.seek(0);
+  }
+
+  void addPlaceholder(size_t offset, uint8_t length, const char* name) {
+    size_t id = 0;
+    while (id < this->names.size() && !this->names[id].equals(name)) {
+      id++;
+    }
+
+    if (id >= UINT8_MAX) {
+      return;
+
+    } else if (id == this->names.size()) {
+      this->names.push_back(name);
+    }
+
+    Placeholder placeholder;
+    placeholder.offset = offset;
+    placeholder.length = length;
+    placeholder.id = id;
+    this->placeholders.push_back(placeholder);
+  }
+
+  void writeFromFile(WebServer& server, File& file, size_t length) {
+    while (length > 0) {
+      size_t size = this->bufferSize - this->bufferPos;
+      if (size > length) {
+        size = length;
+      }
+
+      size = file.read(this->buffer + this->bufferPos, size);
+      if (!size) {
+        break;
+      }
+
+      this->bufferPos += size;
+      length -= size;
+
+      if (this->bufferPos >= this->bufferSize) {
+        this->flush(server);
+      }
+    }
+  }
+
+  void write(WebServer& server, const uint8_t* data, size_t length) {
+    while (length > 0) {
+      size_t size = this->bufferSize - this->bufferPos;
+      if (size > length) {
+        size = length;
+      }
+
+      memcpy(this->buffer + this->bufferPos, data, size);
+      this->bufferPos += size;
+      data += size;
+      length -= size;
+
+      if (this->bufferPos >= this->bufferSize) {
+        this->flush(server);
+      }
+    }
+  }
+
+  void flush(WebServer& server) {
+    if (this->bufferPos == 0) {
+      return;
+    }
+
+    server.sendContent((const char*) this->buffer, this->bufferPos);
+    this->bufferPos = 0;
+  }
 };
\ No newline at end of file
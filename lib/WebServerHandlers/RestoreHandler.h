@@ -0,0 +1,361 @@
+#include <Arduino.h>
+
+/**
+ * Receives a backup as a raw request body and splits it into sections on the fly.
+ * Every top-level value is deserialized and passed to the callback as soon as it is complete,
+ * sections marked by the split callback are delivered one member at a time (e.g. sensors).
+ * Only one section is held in memory, the body itself is never buffered.
+ * Sections arrive before the end of the body is seen, so the callback must only stage them
+ * and commit in the after restore callback on RestoreStatus::SUCCESS.
+ */
+class RestoreHandler : public RequestHandler {
+public:
+  enum class RestoreStatus {
+    NONE,
+    SUCCESS,
+    PROHIBITED,
+    NO_DATA,
+    INVALID,
+    TOO_LARGE,
+    ABORTED
+  };
+
+  typedef struct {
+    RestoreStatus status;
+    bool changed;
+    size_t size;
+  } RestoreResult;
+
+  typedef std::function<bool()> BeforeRestoreCallback;
+  typedef std::function<bool(const String&)> SplitCallback;
+  typedef std::function<bool(const String&, const String&, const JsonVariantConst)> SectionCallback;
+  typedef std::function<void(const RestoreResult&)> AfterRestoreCallback;
+
+  RestoreHandler(const char* uri, size_t maxSectionSize) {
+    this->uri = uri;
+    this->maxSectionSize = maxSectionSize;
+  }
+
+  RestoreHandler* setBeforeRestoreCallback(BeforeRestoreCallback callback = nullptr) {
+    this->beforeRestoreCallback = callback;
+
+    return this;
+  }
+
+  RestoreHandler* setSplitCallback(SplitCallback callback = nullptr) {
+    this->splitCallback = callback;
+
+    return this;
+  }
+
+  RestoreHandler* setSectionCallback(SectionCallback callback = nullptr) {
+    this->sectionCallback = callback;
+
+    return this;
+  }
+
+  RestoreHandler* setAfterRestoreCallback(AfterRestoreCallback callback = nullptr) {
+    this->afterRestoreCallback = callback;
+
+    return this;
+  }
+
+  #if defined(ARDUINO_ARCH_ESP32)
+  bool canHandle(WebServer &server, HTTPMethod method, const String &uri) override {
+    return this->canHandle(method, uri);
+  }
+
+  bool canRaw(WebServer &server, const String &uri) override {
+    return this->canRaw(uri);
+  }
+  #endif
+
+  bool canHandle(HTTPMethod method, const String& uri) override {
+    return method == HTTP_POST && uri.equals(this->uri);
+  }
+
+  bool canRaw(const String& uri) override {
+    return uri.equals(this->uri);
+  }
+
+  bool handle(WebServer& server, HTTPMethod method, const String& uri) override {
+    if (this->result.status == RestoreStatus::NONE) {
+      // the body was not passed through raw(), e.g. a form was submitted
+      this->result.status = RestoreStatus::NO_DATA;
+    }
+
+    if (this->afterRestoreCallback) {
+      this->afterRestoreCallback(this->result);
+    }
+
+    this->reset();
+
+    return true;
+  }
+
+  void raw(WebServer& server, const String& uri, HTTPRaw& raw) override {
+    if (raw.status == RAW_START) {
+      this->reset();
+
+      if (this->beforeRestoreCallback && !this->beforeRestoreCallback()) {
+        this->result.status = RestoreStatus::PROHIBITED;
+      }
+
+    } else if (raw.status == RAW_WRITE) {
+      if (this->result.status != RestoreStatus::NONE) {
+        return;
+      }
+
+      this->result.size = raw.totalSize;
+      for (size_t i = 0; i < raw.currentSize && this->result.status == RestoreStatus::NONE; i++) {
+        this->parse((char) raw.buf[i]);
+      }
+
+    } else if (raw.status == RAW_END) {
+      if (this->result.status != RestoreStatus::NONE) {
+        return;
+      }
+
+      if (this->state == State::DONE) {
+        this->result.status = RestoreStatus::SUCCESS;
+
+      } else if (this->state == State::ROOT) {
+        this->result.status = RestoreStatus::NO_DATA;
+
+      } else {
+        this->result.status = RestoreStatus::INVALID;
+      }
+
+    } else if (raw.status == RAW_ABORTED) {
+      this->result.status = RestoreStatus::ABORTED;
+    }
+
+    if (this->result.status != RestoreStatus::NONE) {
+      this->section.clear();
+      this->key.clear();
+      this->value = String();
+    }
+  }
+
+protected:
+  enum class State : uint8_t {
+    ROOT,
+    KEY,
+    KEY_STRING,
+    COLON,
+    VALUE,
+    CAPTURE,
+    AFTER_VALUE,
+    DONE
+  };
+
+  BeforeRestoreCallback beforeRestoreCallback;
+  SplitCallback splitCallback;
+  SectionCallback sectionCallback;
+  AfterRestoreCallback afterRestoreCallback;
+  const char* uri = nullptr;
+  size_t maxSectionSize = 0;
+
+  RestoreResult result{RestoreStatus::NONE, false, 0};
+  State state = State::ROOT;
+  // 1 - root object, 2 - members of a split section
+  uint8_t level = 0;
+  bool splitArray = false;
+  uint8_t index = 0;
+  // nesting inside the captured value
+  uint8_t depth = 0;
+  bool inString = false;
+  bool escaped = false;
+  String section;
+  String key;
+  String value;
+
+  void reset() {
+    this->result = {RestoreStatus::NONE, false, 0};
+    this->state = State::ROOT;
+    this->level = 0;
+    this->depth = 0;
+    this->inString = false;
+    this->escaped = false;
+    this->section.clear();
+    this->key.clear();
+    this->value = String();
+  }
+
+  void parse(char c) {
+    if (this->state == State::CAPTURE) {
+      this->capture(c);
+      return;
+    }
+
+    if (this->state == State::KEY_STRING) {
+      if (this->escaped) {
+        this->escaped = false;
+
+      } else if (c == '\\') {
+        this->escaped = true;
+        return;
+
+      } else if (c == '"') {
+        this->state = State::COLON;
+        return;
+      }
+
+      String& dst = this->level == 1 ? this->section : this->key;
+      if (dst.length() >= 32) {
+        this->result.status = RestoreStatus::INVALID;
+        return;
+      }
+
+      dst += c;
+      return;
+    }
+
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      return;
+    }
+
+    switch (this->state) {
+      case State::ROOT:
+        if (c != '{') {
+          this->result.status = RestoreStatus::INVALID;
+          break;
+        }
+
+        this->level = 1;
+        this->state = State::KEY;
+        break;
+
+      case State::KEY:
+        if (c == '"') {
+          (this->level == 1 ? this->section : this->key).clear();
+          this->state = State::KEY_STRING;
+
+        } else if (c == '}') {
+          this->close();
+
+        } else {
+          this->result.status = RestoreStatus::INVALID;
+        }
+        break;
+
+      case State::COLON:
+        if (c != ':') {
+          this->result.status = RestoreStatus::INVALID;
+          break;
+        }
+
+        this->state = State::VALUE;
+        break;
+
+      case State::VALUE:
+        if (this->level == 1 && (c == '{' || c == '[') && this->splitCallback && this->splitCallback(this->section)) {
+          this->level = 2;
+          this->splitArray = c == '[';
+          this->index = 0;
+          this->state = this->splitArray ? State::VALUE : State::KEY;
+
+        } else if (this->level == 2 && this->splitArray && c == ']') {
+          this->close();
+
+        } else {
+          if (this->level == 2 && this->splitArray) {
+            this->key = String(this->index);
+          }
+
+          this->value.clear();
+          this->depth = 0;
+          this->inString = false;
+          this->escaped = false;
+          this->state = State::CAPTURE;
+          this->capture(c);
+        }
+        break;
+
+      case State::AFTER_VALUE:
+        this->next(c);
+        break;
+
+      default:
+        this->result.status = RestoreStatus::INVALID;
+    }
+  }
+
+  void capture(char c) {
+    if (this->inString) {
+      if (this->escaped) {
+        this->escaped = false;
+
+      } else if (c == '\\') {
+        this->escaped = true;
+
+      } else if (c == '"') {
+        this->inString = false;
+      }
+
+    } else if (c == '"') {
+      this->inString = true;
+
+    } else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      // a pretty printed backup takes no more room than a compact one
+      return;
+
+    } else if (c == '{' || c == '[') {
+      this->depth++;
+
+    } else if (this->depth == 0 && (c == ',' || c == '}' || c == ']')) {
+      // the value is complete, the char belongs to the parent
+      this->deliver();
+      this->next(c);
+      return;
+
+    } else if (c == '}' || c == ']') {
+      this->depth--;
+    }
+
+    if (this->value.length() >= this->maxSectionSize) {
+      this->result.status = RestoreStatus::TOO_LARGE;
+      return;
+    }
+
+    this->value += c;
+  }
+
+  void next(char c) {
+    if (c == ',') {
+      if (this->level == 2 && this->splitArray) {
+        this->index++;
+        this->state = State::VALUE;
+
+      } else {
+        this->state = State::KEY;
+      }
+
+    } else if (c == (this->level == 2 && this->splitArray ? ']' : '}')) {
+      this->close();
+
+    } else {
+      this->result.status = RestoreStatus::INVALID;
+    }
+  }
+
+  void close() {
+    this->level--;
+    this->state = this->level ? State::AFTER_VALUE : State::DONE;
+  }
+
+  void deliver() {
+    JsonDocument doc;
+    DeserializationError dErr = deserializeJson(doc, this->value);
+    this->value.clear();
+
+    if (dErr != DeserializationError::Ok) {
+      this->result.status = RestoreStatus::INVALID;
+      return;
+    }
+
+    if (this->sectionCallback && this->sectionCallback(this->section, this->level == 2 ? this->key : emptyString, doc)) {
+      this->result.changed = true;
+    }
+  }
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#ifdef ARDUINO_ARCH_ESP8266
+#include <bearssl/bearssl_hash.h>
+#else
+#include <mbedtls/sha256.h>
+#endif
+
+/**
+ * Incremental SHA-256 on top of the hash implementation bundled with the core
+ * (BearSSL on ESP8266, mbedTLS on ESP32).
+ */
+class Sha256 {
+public:
+  static const uint8_t HASH_SIZE = 32;
+
+  Sha256() {
+    #ifdef ARDUINO_ARCH_ESP32
+    mbedtls_sha256_init(&this->context);
+    #endif
+  }
+
+  ~Sha256() {
+    #ifdef ARDUINO_ARCH_ESP32
+    mbedtls_sha256_free(&this->context);
+    #endif
+  }
+
+  void begin() {
+    #ifdef ARDUINO_ARCH_ESP8266
+    br_sha256_init(&this->context);
+    #else
+    mbedtls_sha256_starts(&this->context, 0);
+    #endif
+  }
+
+  void update(const uint8_t* data, size_t length) {
+    #ifdef ARDUINO_ARCH_ESP8266
+    br_sha256_update(&this->context, data, length);
+    #else
+    mbedtls_sha256_update(&this->context, data, length);
+    #endif
+  }
+
+  void end(uint8_t* hash) {
+    #ifdef ARDUINO_ARCH_ESP8266
+    br_sha256_out(&this->context, hash);
+    #else
+    mbedtls_sha256_finish(&this->context, hash);
+    #endif
+  }
+
+  // compares with a hex encoded digest, case insensitive
+  bool equals(const String& expected) {
+    if (expected.length() != HASH_SIZE * 2) {
+      return false;
+    }
+
+    uint8_t hash[HASH_SIZE];
+    this->end(hash);
+
+    char hex[3];
+    for (uint8_t i = 0; i < HASH_SIZE; i++) {
+      snprintf_P(hex, sizeof(hex), PSTR("%02x"), hash[i]);
+
+      if (tolower(expected[i * 2]) != hex[0] || tolower(expected[i * 2 + 1]) != hex[1]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+protected:
+  #ifdef ARDUINO_ARCH_ESP8266
+  br_sha256_context context;
+  #else
+  mbedtls_sha256_context context;
+  #endif
+};
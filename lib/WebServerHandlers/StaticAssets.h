@@ -0,0 +1,87 @@
+#include <FS.h>
+#include <detail/mimetable.h>
+#include "AssetsManifest.h"
+
+using namespace mime;
+
+/**
+ * Serves the assets listed in the manifest.
+ * Urls versioned with the content hash (?v=<hash>) are cached by clients forever,
+ * other requests are revalidated with the hash based ETag.
+ */
+class StaticAssets : public RequestHandler {
+public:
+  StaticAssets(const char* uri, FS* fs, AssetsManifest* manifest) {
+    this->uri = uri;
+    this->fs = fs;
+    this->manifest = manifest;
+  }
+
+  #if defined(ARDUINO_ARCH_ESP32)
+  bool canHandle(WebServer &server, HTTPMethod method, const String &uri) override {
+    return this->canHandle(method, uri);
+  }
+  #endif
+
+  bool canHandle(HTTPMethod method, const String& uri) override {
+    return method == HTTP_GET && uri.startsWith(this->uri) && this->manifest->find(uri) != nullptr;
+  }
+
+  bool handle(WebServer& server, HTTPMethod method, const String& uri) override {
+    if (method != HTTP_GET) {
+      return false;
+    }
+
+    auto asset = this->manifest->find(uri);
+    if (asset == nullptr) {
+      return false;
+    }
+
+    const String eTag = AssetsManifest::getETag(asset);
+    if (server.arg(F("v")).equals(asset->hash)) {
+      server.sendHeader(F("Cache-Control"), F("public, max-age=31536000, immutable"));
+
+    } else {
+      server.sendHeader(F("Cache-Control"), F("no-cache"));
+    }
+    server.sendHeader(F("ETag"), eTag);
+
+    if (server.header(F("If-None-Match")).equals(eTag)) {
+      server.send(304);
+      return true;
+    }
+
+    File file = this->fs->open(AssetsManifest::getFilePath(asset), "r");
+    if (!file) {
+      return false;
+
+    } else if (file.isDirectory()) {
+      file.close();
+      return false;
+    }
+
+    #if defined(ARDUINO_ARCH_ESP8266)
+    server.streamFile(file, getContentType(uri), method);
+    #else
+    server.streamFile(file, getContentType(uri), 200);
+    #endif
+    file.close();
+
+    return true;
+  }
+
+protected:
+  FS* fs = nullptr;
+  AssetsManifest* manifest = nullptr;
+  const char* uri = nullptr;
+
+  static String getContentType(const String& uri) {
+    for (size_t i = 0; i < maxType - 1; i++) {
+      if (uri.endsWith(FPSTR(mimeTable[i].endsWith))) {
+        return String(FPSTR(mimeTable[i].mimeType));
+      }
+    }
+
+    return String(FPSTR(mimeTable[none].mimeType));
+  }
+};
@@ -1,5 +1,6 @@
 #include <FS.h>
 #include <detail/mimetable.h>
+#include "AssetsManifest.h"
 
 using namespace mime;
 
@@ -28,6 +29,12 @@ public:
     return this;
   }
 
+  StaticPage* setManifest(AssetsManifest* manifest = nullptr) {
+    this->manifest = manifest;
+
+    return this;
+  }
+
   #if defined(ARDUINO_ARCH_ESP32)
   bool canHandle(WebServer &server, HTTPMethod method, const String &uri) override {
     return this->canHandle(method, uri);
@@ -47,8 +54,19 @@ public:
       return true;
     }
 
-    if (server._eTagEnabled) {
-      if (this->eTag.isEmpty()) {
+    // known asset: the hash and the gz variant come from the manifest, no fs probing
+    if (this->eTag.isEmpty() && this->manifest != nullptr) {
+      auto asset = this->manifest->find(this->path);
+
+      if (asset != nullptr) {
+        this->eTag = AssetsManifest::getETag(asset);
+        this->path = AssetsManifest::getFilePath(asset);
+        this->resolved = true;
+      }
+    }
+
+    if (server._eTagEnabled || this->manifest != nullptr) {
+      if (this->eTag.isEmpty() && server._eTagEnabled) {
         if (server._eTagFunction) {
           this->eTag = (server._eTagFunction)(*this->fs, this->path);
         }
@@ -60,7 +78,7 @@ public:
       }
     }
 
-    if (!this->path.endsWith(FPSTR(mimeTable[gz].endsWith)) && !this->fs->exists(path))  {
+    if (!this->resolved && !this->path.endsWith(FPSTR(mimeTable[gz].endsWith)) && !this->fs->exists(path))  {
       String pathWithGz = this->path + FPSTR(mimeTable[gz].endsWith);
 
       if (this->fs->exists(pathWithGz)) {
@@ -81,7 +99,7 @@ public:
       server.sendHeader(F("Cache-Control"), this->cacheHeader);
     }
 
-    if (server._eTagEnabled && !this->eTag.isEmpty()) {
+    if (!this->eTag.isEmpty()) {
       server.sendHeader(F("ETag"), this->eTag);
     }
     
@@ -98,8 +116,10 @@ protected:
   FS* fs = nullptr;
   CanHandleCallback canHandleCallback;
   BeforeSendCallback beforeSendCallback;
+  AssetsManifest* manifest = nullptr;
   String eTag;
   const char* uri = nullptr;
   String path;
+  bool resolved = false;
   const char* cacheHeader = nullptr;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <Arduino.h>
+#include "Sha256.h"
 
 class UpgradeHandler : public RequestHandler {
 public:
@@ -15,15 +16,27 @@ public:
     ABORTED,
     ERROR_ON_START,
     ERROR_ON_WRITE,
-    ERROR_ON_FINISH
+    ERROR_ON_FINISH,
+    ERROR_ON_VERIFY
   };
 
   typedef struct {
     UpgradeType type;
     UpgradeStatus status;
     String error;
+    size_t written;
+    uint16_t chunks;
   } UpgradeResult;
 
+  // state of the current Update session, survives an interrupted upload so it can be resumed
+  typedef struct {
+    bool running;
+    UpgradeType type;
+    // bytes accepted by Update.write(), Update.progress() lags behind by the sector buffered in RAM
+    size_t written;
+    uint16_t chunks;
+  } UpgradeProgress;
+
   typedef std::function<bool(HTTPMethod, const String&)> CanHandleCallback;
   typedef std::function<bool(const String&)> CanUploadCallback;
   typedef std::function<bool(UpgradeType)> BeforeUpgradeCallback;
@@ -77,6 +90,39 @@ public:
     return uri.equals(this->uri) && (!this->canUploadCallback || this->canUploadCallback(uri));
   }
 
+  const UpgradeProgress& getProgress() {
+    this->progress.running = Update.isRunning();
+    if (!this->progress.running) {
+      this->progress.written = 0;
+    }
+
+    return this->progress;
+  }
+
+  /**
+   * Closes the Update session of an aborted upload that was not resumed within the timeout.
+   * Returns true if the session was closed.
+   */
+  bool expireAborted(unsigned long timeout) {
+    if (!this->aborted || millis() - this->abortedTime < timeout) {
+      return false;
+    }
+
+    this->aborted = false;
+    if (!Update.isRunning()) {
+      return false;
+    }
+
+    Update.end(false);
+    Update.clearError();
+    this->progress.written = 0;
+    this->progress.chunks = 0;
+    this->expectedSha256.clear();
+
+    Log.swarningln(FPSTR(L_PORTAL_OTA), F("Aborted upload not resumed in %lu ms, session closed"), timeout);
+    return true;
+  }
+
   bool handle(WebServer& server, HTTPMethod method, const String& uri) override {
     if (this->afterUpgradeCallback) {
       this->afterUpgradeCallback(this->firmwareResult, this->filesystemResult);
@@ -84,9 +130,13 @@ public:
 
     this->firmwareResult.status = UpgradeStatus::NONE;
     this->firmwareResult.error.clear();
+    this->firmwareResult.written = 0;
+    this->firmwareResult.chunks = 0;
 
     this->filesystemResult.status = UpgradeStatus::NONE;
     this->filesystemResult.error.clear();
+    this->filesystemResult.written = 0;
+    this->filesystemResult.chunks = 0;
 
     return true;
   }
@@ -103,6 +153,14 @@ public:
       return;
     }
 
+    // the request of an aborted upload has no handle() call, its result is reset by the next upload
+    if (upload.status == UPLOAD_FILE_START && result->status == UpgradeStatus::ABORTED) {
+      result->status = UpgradeStatus::NONE;
+      result->error.clear();
+      result->written = 0;
+      result->chunks = 0;
+    }
+
     if (result->status != UpgradeStatus::NONE) {
       return;
     }
@@ -118,12 +176,44 @@ public:
     }
 
     if (upload.status == UPLOAD_FILE_START) {
+      // optional query args: <name>_offset to resume, <name>_sha256 or <name>_md5 to verify
+      const size_t offset = server.arg(upload.name + F("_offset")).toInt();
+      this->aborted = false;
+
+      if (offset > 0) {
+        if (!Update.isRunning() || this->progress.type != result->type || this->progress.written != offset) {
+          result->status = UpgradeStatus::ERROR_ON_START;
+          result->error = F("Unable to resume, written: ");
+          result->error += Update.isRunning() && this->progress.type == result->type ? this->progress.written : 0;
+
+          // the stale session can not be continued anymore, the client has to start over
+          if (Update.isRunning()) {
+            Update.end(false);
+            Update.clearError();
+          }
+
+          Log.serrorln(FPSTR(L_PORTAL_OTA), F("File '%s', on resume from %u: %s"), upload.filename.c_str(), offset, result->error.c_str());
+          return;
+        }
+
+        result->written = offset;
+        result->chunks = this->progress.chunks;
+        Log.sinfoln(FPSTR(L_PORTAL_OTA), F("File '%s', resumed from %u bytes"), upload.filename.c_str(), offset);
+        return;
+      }
+
       // reset
       if (Update.isRunning()) {
         Update.end(false);
         Update.clearError();
       }
 
+      this->progress.type = result->type;
+      this->progress.written = 0;
+      this->progress.chunks = 0;
+      this->expectedSha256 = server.arg(upload.name + F("_sha256"));
+      this->sha256.begin();
+
       bool begin = false;
       #ifdef ARDUINO_ARCH_ESP8266
       Update.runAsync(true);
@@ -144,6 +234,17 @@ public:
       }
       #endif
 
+      // the md5 is computed by Update while writing and checked in Update.end()
+      const String& md5 = server.arg(upload.name + F("_md5"));
+      if (begin && md5.length() && !Update.setMD5(md5.c_str())) {
+        Update.end(false);
+        result->status = UpgradeStatus::ERROR_ON_START;
+        result->error = F("Invalid MD5");
+
+        Log.serrorln(FPSTR(L_PORTAL_OTA), F("File '%s', on start: %s"), upload.filename.c_str(), result->error.c_str());
+        return;
+      }
+
       if (!begin || Update.hasError()) {
         result->status = UpgradeStatus::ERROR_ON_START;
         #ifdef ARDUINO_ARCH_ESP8266
@@ -176,14 +277,30 @@ public:
         );
 
       } else {
-        Log.sinfoln(FPSTR(L_PORTAL_OTA), F("File '%s', writed %d bytes"), upload.filename.c_str(), upload.totalSize);
+        this->sha256.update(upload.buf, upload.currentSize);
+        this->progress.written += upload.currentSize;
+        result->written = this->progress.written;
+        result->chunks = ++this->progress.chunks;
+
+        Log.straceln(
+          FPSTR(L_PORTAL_OTA),
+          F("File '%s', chunk #%u, written %u bytes"),
+          upload.filename.c_str(), result->chunks, result->written
+        );
       }
 
     } else if (upload.status == UPLOAD_FILE_END) {
-      if (Update.end(true)) {
+      if (this->expectedSha256.length() && !this->sha256.equals(this->expectedSha256)) {
+        Update.end(false);
+        result->status = UpgradeStatus::ERROR_ON_VERIFY;
+        result->error = F("SHA-256 mismatch");
+
+        Log.serrorln(FPSTR(L_PORTAL_OTA), F("File '%s', on verify: %s"), upload.filename.c_str(), result->error.c_str());
+
+      } else if (Update.end(true)) {
         result->status = UpgradeStatus::SUCCESS;
 
-        Log.sinfoln(FPSTR(L_PORTAL_OTA), F("File '%s': finish"), upload.filename.c_str());
+        Log.sinfoln(FPSTR(L_PORTAL_OTA), F("File '%s': finish, %u bytes"), upload.filename.c_str(), result->written);
 
       } else {
         result->status = UpgradeStatus::ERROR_ON_FINISH;
@@ -193,14 +310,19 @@ public:
         result->error = Update.errorString();
         #endif
 
-        Log.serrorln(FPSTR(L_PORTAL_OTA), F("File '%s', on finish: %s"), upload.filename.c_str(), result->error);
+        Log.serrorln(FPSTR(L_PORTAL_OTA), F("File '%s', on finish: %s"), upload.filename.c_str(), result->error.c_str());
       }
 
+      this->expectedSha256.clear();
+
     } else if (upload.status == UPLOAD_FILE_ABORTED) {
-      Update.end(false);
+      // the session is kept open until expireAborted(), the upload can be continued with <name>_offset
       result->status = UpgradeStatus::ABORTED;
+      result->written = this->progress.written;
+      this->aborted = true;
+      this->abortedTime = millis();
 
-      Log.serrorln(FPSTR(L_PORTAL_OTA), F("File '%s': aborted"), upload.filename.c_str());
+      Log.serrorln(FPSTR(L_PORTAL_OTA), F("File '%s': aborted, written %u bytes"), upload.filename.c_str(), result->written);
     }
   }
 
@@ -211,6 +333,11 @@ protected:
   AfterUpgradeCallback afterUpgradeCallback;
   const char* uri = nullptr;
 
-  UpgradeResult firmwareResult{UpgradeType::FIRMWARE, UpgradeStatus::NONE};
-  UpgradeResult filesystemResult{UpgradeType::FILESYSTEM, UpgradeStatus::NONE};
+  UpgradeResult firmwareResult{UpgradeType::FIRMWARE, UpgradeStatus::NONE, String(), 0, 0};
+  UpgradeResult filesystemResult{UpgradeType::FILESYSTEM, UpgradeStatus::NONE, String(), 0, 0};
+  UpgradeProgress progress{false, UpgradeType::FIRMWARE, 0, 0};
+  Sha256 sha256;
+  String expectedSha256;
+  bool aborted = false;
+  unsigned long abortedTime = 0;
 };
\ No newline at end of file
@@ -1371,6 +1371,206 @@ public:
     return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_BUTTON), F("reset_diagnostic")).c_str(), doc);
   }
 
+  bool publishPidAutotuneState(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("pid_autotune"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_SENSOR), F("pid_autotune"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_DIAGNOSTIC);
+    doc[FPSTR(HA_DEVICE_CLASS)] = F("enum");
+
+    JsonArray options = doc[FPSTR(HA_OPTIONS)].to<JsonArray>();
+    options.add(F("idle"));
+    options.add(F("running"));
+    options.add(F("done"));
+    options.add(F("aborted"));
+    options.add(F("failed"));
+
+    doc[FPSTR(HA_NAME)] = F("PID auto-tune");
+    doc[FPSTR(HA_ICON)] = F("mdi:tune-variant");
+    doc[FPSTR(HA_STATE_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_VALUE_TEMPLATE)] = F("{{ ['idle', 'running', 'done', 'aborted', 'failed'][value_json.master.pidAutotune.state|int(0)] }}");
+    doc[FPSTR(HA_JSON_ATTRIBUTES_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_JSON_ATTRIBUTES_TEMPLATE)] = F("{{ value_json.master.pidAutotune|tojson }}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_SENSOR), F("pid_autotune")).c_str(), doc);
+  }
+
+  bool publishPidAutotuneProgress(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("pid_autotune_progress"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_SENSOR), F("pid_autotune_progress"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_DIAGNOSTIC);
+    doc[FPSTR(HA_STATE_CLASS)] = FPSTR(HA_STATE_CLASS_MEASUREMENT);
+    doc[FPSTR(HA_UNIT_OF_MEASUREMENT)] = FPSTR(HA_UNIT_OF_MEASUREMENT_PERCENT);
+    doc[FPSTR(HA_NAME)] = F("PID auto-tune progress");
+    doc[FPSTR(HA_ICON)] = F("mdi:progress-clock");
+    doc[FPSTR(HA_STATE_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_VALUE_TEMPLATE)] = F("{{ value_json.master.pidAutotune.progress|int(0) }}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_SENSOR), F("pid_autotune_progress")).c_str(), doc);
+  }
+
+  bool publishStartPidAutotuneButton(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("start_pid_autotune"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_BUTTON), F("start_pid_autotune"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_CONFIG);
+    doc[FPSTR(HA_NAME)] = F("Start PID auto-tune");
+    doc[FPSTR(HA_ICON)] = F("mdi:play");
+    doc[FPSTR(HA_COMMAND_TOPIC)] = this->setStateTopic.c_str();
+    doc[FPSTR(HA_COMMAND_TEMPLATE)] = F("{\"actions\": {\"startPidAutotune\": true}}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_BUTTON), F("start_pid_autotune")).c_str(), doc);
+  }
+
+  bool publishStopPidAutotuneButton(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][0][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_VALUE_TEMPLATE)] = F("{{ iif(value_json.master.pidAutotune.state == 1, 'online', 'offline') }}");
+    doc[FPSTR(HA_AVAILABILITY_MODE)] = F("all");
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("stop_pid_autotune"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_BUTTON), F("stop_pid_autotune"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_CONFIG);
+    doc[FPSTR(HA_NAME)] = F("Stop PID auto-tune");
+    doc[FPSTR(HA_ICON)] = F("mdi:stop");
+    doc[FPSTR(HA_COMMAND_TOPIC)] = this->setStateTopic.c_str();
+    doc[FPSTR(HA_COMMAND_TEMPLATE)] = F("{\"actions\": {\"stopPidAutotune\": true}}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_BUTTON), F("stop_pid_autotune")).c_str(), doc);
+  }
+
+  bool publishApplyPidAutotuneButton(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][0][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_VALUE_TEMPLATE)] = F("{{ iif(value_json.master.pidAutotune.state == 2, 'online', 'offline') }}");
+    doc[FPSTR(HA_AVAILABILITY_MODE)] = F("all");
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("apply_pid_autotune"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_BUTTON), F("apply_pid_autotune"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_CONFIG);
+    doc[FPSTR(HA_NAME)] = F("Apply PID auto-tune");
+    doc[FPSTR(HA_ICON)] = F("mdi:check");
+    doc[FPSTR(HA_COMMAND_TOPIC)] = this->setStateTopic.c_str();
+    doc[FPSTR(HA_COMMAND_TEMPLATE)] = F("{\"actions\": {\"applyPidAutotune\": true}}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_BUTTON), F("apply_pid_autotune")).c_str(), doc);
+  }
+
+  bool publishBurnerCycles(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][0][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_VALUE_TEMPLATE)] = JsonString(AVAILABILITY_OT_CONN, true);
+    doc[FPSTR(HA_AVAILABILITY_MODE)] = F("all");
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("burner_cycles"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_SENSOR), F("burner_cycles"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_DIAGNOSTIC);
+    doc[FPSTR(HA_STATE_CLASS)] = FPSTR(HA_STATE_CLASS_MEASUREMENT);
+    doc[FPSTR(HA_UNIT_OF_MEASUREMENT)] = F("cycles/h");
+    doc[FPSTR(HA_NAME)] = F("Burner cycles per hour");
+    doc[FPSTR(HA_ICON)] = F("mdi:fire-circle");
+    doc[FPSTR(HA_STATE_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_VALUE_TEMPLATE)] = F("{{ value_json.master.antiCycling.cycles|int(0) }}");
+    doc[FPSTR(HA_JSON_ATTRIBUTES_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_JSON_ATTRIBUTES_TEMPLATE)] = F("{{ value_json.master.antiCycling|tojson }}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_SENSOR), F("burner_cycles")).c_str(), doc);
+  }
+
+  bool publishAntiCyclingLockout(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("anti_cycling_lockout"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_BINARY_SENSOR), F("anti_cycling_lockout"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_DIAGNOSTIC);
+    doc[FPSTR(HA_DEVICE_CLASS)] = F("running");
+    doc[FPSTR(HA_NAME)] = F("Short cycling lockout");
+    doc[FPSTR(HA_ICON)] = F("mdi:timer-lock-outline");
+    doc[FPSTR(HA_STATE_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_VALUE_TEMPLATE)] = F("{{ iif(value_json.master.antiCycling.lockout, 'ON', 'OFF') }}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_BINARY_SENSOR), F("anti_cycling_lockout")).c_str(), doc);
+  }
+
+  bool publishSwitchHeatingSchedule(bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("heating_schedule"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_SWITCH), F("heating_schedule"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_CONFIG);
+    doc[FPSTR(HA_NAME)] = F("Heating schedule");
+    doc[FPSTR(HA_ICON)] = F("mdi:calendar-clock");
+    doc[FPSTR(HA_STATE_TOPIC)] = this->settingsTopic.c_str();
+    doc[FPSTR(HA_STATE_ON)] = true;
+    doc[FPSTR(HA_STATE_OFF)] = false;
+    doc[FPSTR(HA_VALUE_TEMPLATE)] = F("{{ value_json.heating.schedule.enabled }}");
+    doc[FPSTR(HA_COMMAND_TOPIC)] = this->setSettingsTopic.c_str();
+    doc[FPSTR(HA_PAYLOAD_ON)] = F("{\"heating\": {\"schedule\" : {\"enabled\" : true}}}");
+    doc[FPSTR(HA_PAYLOAD_OFF)] = F("{\"heating\": {\"schedule\" : {\"enabled\" : false}}}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_SWITCH), F("heating_schedule")).c_str(), doc);
+  }
+
+  bool publishScheduleTarget(UnitSystem unit = UnitSystem::METRIC, bool enabledByDefault = true) {
+    JsonDocument doc;
+    doc[FPSTR(HA_AVAILABILITY)][0][FPSTR(HA_TOPIC)] = this->statusTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_AVAILABILITY)][1][FPSTR(HA_VALUE_TEMPLATE)] = F("{{ iif(value_json.master.schedule.active, 'online', 'offline') }}");
+    doc[FPSTR(HA_AVAILABILITY_MODE)] = F("all");
+    doc[FPSTR(HA_ENABLED_BY_DEFAULT)] = enabledByDefault;
+    doc[FPSTR(HA_UNIQUE_ID)] = this->getUniqueIdWithPrefix(F("schedule_target"));
+    doc[FPSTR(HA_DEFAULT_ENTITY_ID)] = this->getEntityIdWithPrefix(FPSTR(HA_ENTITY_SENSOR), F("schedule_target"));
+    doc[FPSTR(HA_ENTITY_CATEGORY)] = FPSTR(HA_ENTITY_CATEGORY_DIAGNOSTIC);
+    doc[FPSTR(HA_DEVICE_CLASS)] = FPSTR(S_TEMPERATURE);
+    doc[FPSTR(HA_STATE_CLASS)] = FPSTR(HA_STATE_CLASS_MEASUREMENT);
+
+    if (unit == UnitSystem::METRIC) {
+      doc[FPSTR(HA_UNIT_OF_MEASUREMENT)] = FPSTR(HA_UNIT_OF_MEASUREMENT_C);
+
+    } else if (unit == UnitSystem::IMPERIAL) {
+      doc[FPSTR(HA_UNIT_OF_MEASUREMENT)] = FPSTR(HA_UNIT_OF_MEASUREMENT_F);
+    }
+
+    doc[FPSTR(HA_NAME)] = F("Scheduled target");
+    doc[FPSTR(HA_ICON)] = F("mdi:calendar-clock");
+    doc[FPSTR(HA_STATE_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_VALUE_TEMPLATE)] = F("{{ value_json.master.schedule.target|float(0)|round(1) }}");
+    doc[FPSTR(HA_JSON_ATTRIBUTES_TOPIC)] = this->stateTopic.c_str();
+    doc[FPSTR(HA_JSON_ATTRIBUTES_TEMPLATE)] = F("{{ value_json.master.schedule|tojson }}");
+    doc[FPSTR(HA_EXPIRE_AFTER)] = this->expireAfter;
+    doc.shrinkToFit();
+
+    return this->publish(this->makeConfigTopic(FPSTR(HA_ENTITY_SENSOR), F("schedule_target")).c_str(), doc);
+  }
+
 
   template <class CT>
   bool deleteEntities(CT category) {
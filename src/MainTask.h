@@ -5,7 +5,8 @@ using namespace NetworkUtils;
 extern NetworkMgr* network;
 extern MqttTask* tMqtt;
 extern OpenThermTask* tOt;
-extern FileData fsNetworkSettings, fsSettings, fsSensorsSettings;
+extern FileData fsNetworkSettings;
+extern JournalData fsSettings, fsSensorsSettings, fsScheduleSettings;
 extern ESPTelnetStream* telnetStream;
 
 
@@ -26,6 +27,8 @@ public:
   }
 
 protected:
+  LoopStats loopStats{"main"};
+
   enum class PumpStartReason {NONE, HEATING, ANTISTUCK};
 
   Blinker* blinker = nullptr;
@@ -61,20 +64,26 @@ protected:
   void setup() {}
 
   void loop() {
+    LoopStats::Guard loopGuard(this->loopStats);
+
     network->loop();
 
     if (fsNetworkSettings.tick() == FD_WRITE) {
       Log.sinfoln(FPSTR(L_NETWORK_SETTINGS), F("Updated"));
     }
 
-    if (fsSettings.tick() == FD_WRITE) {
+    if (fsSettings.tick() == JournalData::Status::WRITTEN) {
       Log.sinfoln(FPSTR(L_SETTINGS), F("Updated"));
     }
 
-    if (fsSensorsSettings.tick() == FD_WRITE) {
+    if (fsSensorsSettings.tick() == JournalData::Status::WRITTEN) {
       Log.sinfoln(FPSTR(L_SENSORS_SETTINGS), F("Updated"));
     }
 
+    if (fsScheduleSettings.tick() == JournalData::Status::WRITTEN) {
+      Log.sinfoln(FPSTR(L_SCHEDULE_SETTINGS), F("Updated"));
+    }
+
     if (vars.actions.restart) {
       this->restartSignalReceivedTime = millis();
       this->restartSignalReceived = true;
@@ -92,6 +101,9 @@ protected:
       // save sensors settings
       fsSensorsSettings.updateNow();
 
+      // save schedule settings
+      fsScheduleSettings.updateNow();
+
       // force save network settings
       if (fsNetworkSettings.updateNow() == FD_FILE_ERR && LittleFS.begin()) {
         fsNetworkSettings.write();
@@ -101,15 +113,23 @@ protected:
     }
 
     vars.mqtt.connected = tMqtt->isConnected();
+    vars.mqtt.discoveryProgress = tMqtt->getHaDiscoveryProgress();
     vars.network.connected = network->isConnected();
     vars.network.rssi = network->isConnected() ? WiFi.RSSI() : 0;
 
-    if (settings.system.logLevel >= TinyLogger::Level::SILENT && settings.system.logLevel <= TinyLogger::Level::VERBOSE) {
-      if (Log.getLevel() != settings.system.logLevel) {
+    const uint32_t settingsChanges = takeSettingsChanges(SettingsSubscriber::MAIN);
+
+    if (settingsChanges & SETTINGS_CHANGE_SYSTEM) {
+      if (settings.system.logLevel >= TinyLogger::Level::SILENT && settings.system.logLevel <= TinyLogger::Level::VERBOSE) {
         Log.setLevel(static_cast<TinyLogger::Level>(settings.system.logLevel));
       }
     }
 
+    // applied again once the network is connected
+    if (settingsChanges & SETTINGS_CHANGE_NTP) {
+      this->ntpStarted = false;
+    }
+
     if (network->isConnected()) {
       if (!this->ntpStarted) {
         if (strlen(settings.system.ntp.server)) {
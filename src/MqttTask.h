@@ -2,21 +2,67 @@
 #include <MqttClient.h>
 #include <MqttWiFiClient.h>
 #include <MqttWriter.h>
+#include <MqttQueue.h>
+#include <JsonCommandParser.h>
+#include <ArenaAllocator.h>
 #include "HaHelper.h"
-
-extern FileData fsSettings;
+#include "MqttTopics.h"
+
+extern JournalData fsSettings;
+
+enum class VarsCommand : uint8_t {
+  RESTART,
+  RESET_FAULT,
+  RESET_DIAGNOSTIC,
+  START_PID_AUTOTUNE,
+  STOP_PID_AUTOTUNE,
+  APPLY_PID_AUTOTUNE,
+  APPLY_EQUITHERM_LEARNING
+};
+
+enum class SensorCommand : uint8_t {
+  VALUE
+};
+
+const char MQTT_CMD_ACTIONS_RESTART[] PROGMEM = "actions.restart";
+const char MQTT_CMD_ACTIONS_RESET_FAULT[] PROGMEM = "actions.resetFault";
+const char MQTT_CMD_ACTIONS_RESET_DIAGNOSTIC[] PROGMEM = "actions.resetDiagnostic";
+const char MQTT_CMD_ACTIONS_START_PID_AUTOTUNE[] PROGMEM = "actions.startPidAutotune";
+const char MQTT_CMD_ACTIONS_STOP_PID_AUTOTUNE[] PROGMEM = "actions.stopPidAutotune";
+const char MQTT_CMD_ACTIONS_APPLY_PID_AUTOTUNE[] PROGMEM = "actions.applyPidAutotune";
+const char MQTT_CMD_ACTIONS_APPLY_EQUITHERM_LEARNING[] PROGMEM = "actions.applyEquithermLearning";
+const char MQTT_CMD_VALUE[] PROGMEM = "value";
+
+const JsonCommandParser::Path varsCommandPaths[] = {
+  {MQTT_CMD_ACTIONS_RESTART, static_cast<uint8_t>(VarsCommand::RESTART)},
+  {MQTT_CMD_ACTIONS_RESET_FAULT, static_cast<uint8_t>(VarsCommand::RESET_FAULT)},
+  {MQTT_CMD_ACTIONS_RESET_DIAGNOSTIC, static_cast<uint8_t>(VarsCommand::RESET_DIAGNOSTIC)},
+  {MQTT_CMD_ACTIONS_START_PID_AUTOTUNE, static_cast<uint8_t>(VarsCommand::START_PID_AUTOTUNE)},
+  {MQTT_CMD_ACTIONS_STOP_PID_AUTOTUNE, static_cast<uint8_t>(VarsCommand::STOP_PID_AUTOTUNE)},
+  {MQTT_CMD_ACTIONS_APPLY_PID_AUTOTUNE, static_cast<uint8_t>(VarsCommand::APPLY_PID_AUTOTUNE)},
+  {MQTT_CMD_ACTIONS_APPLY_EQUITHERM_LEARNING, static_cast<uint8_t>(VarsCommand::APPLY_EQUITHERM_LEARNING)}
+};
+
+const JsonCommandParser::Path sensorCommandPaths[] = {
+  {MQTT_CMD_VALUE, static_cast<uint8_t>(SensorCommand::VALUE)}
+};
 
 class MqttTask : public Task {
 public:
   MqttTask(bool _enabled = false, unsigned long _interval = 0) : Task(_enabled, _interval) {
     this->wifiClient = new MqttWiFiClient();
     this->client = new MqttClient(this->wifiClient);
-    this->writer = new MqttWriter(this->client, 256);
+    this->writer = new MqttWriter(this->client);
+    this->queue = new MqttQueue(this->writer, MQTT_QUEUE_MAX_ITEMS, MQTT_QUEUE_MAX_BYTES);
     this->haHelper = new HaHelper();
+    this->topics = new MqttTopics();
+    this->commandBuffer = (uint8_t*) malloc(MQTT_COMMAND_BUFFER_SIZE);
   }
 
   ~MqttTask() {
     delete this->haHelper;
+    delete this->topics;
+    free(this->commandBuffer);
 
     if (this->client != nullptr) {
       if (this->client->connected()) {
@@ -31,6 +77,7 @@ public:
       delete this->client;
     }
 
+    delete this->queue;
     delete this->writer;
     delete this->wifiClient;
   }
@@ -72,14 +119,47 @@ public:
 
   inline void reconfigureSensor(uint8_t sensorId, Sensors::Settings& prevSettings) {
     this->queueReconfigureSensors[sensorId] = prevSettings;
+    this->topicsChanged = true;
+  }
+
+  inline unsigned long getPublishedMessages() {
+    return this->publishedMessages;
+  }
+
+  inline unsigned long getPublishedBytes() {
+    return this->publishedBytes;
+  }
+
+  inline unsigned long getPublishFailures() {
+    return this->publishFailures;
+  }
+
+  inline unsigned long getFlushes() {
+    return this->flushes;
+  }
+
+  inline bool isHaDiscoveryRunning() {
+    return this->haDiscoveryRunning;
+  }
+
+  uint8_t getHaDiscoveryProgress() {
+    if (!this->haDiscoveryRunning) {
+      return this->currentHomeAssistantDiscovery ? 100 : 0;
+    }
+
+    return (uint8_t) min(this->haDiscoveryStep * 100u / this->getHaDiscoveryTotalSteps(), 99u);
   }
 
 protected:
+  LoopStats loopStats{"mqtt"};
+
   MqttWiFiClient* wifiClient = nullptr;
   MqttClient* client = nullptr;
   HaHelper* haHelper = nullptr;
+  MqttTopics* topics = nullptr;
+  uint8_t* commandBuffer = nullptr;
   MqttWriter* writer = nullptr;
-  UnitSystem currentUnitSystem = UnitSystem::METRIC;
+  MqttQueue* queue = nullptr;
   bool currentHomeAssistantDiscovery = false;
   std::unordered_map<uint8_t, Sensors::Settings> queueReconfigureSensors;
   unsigned short readyForSendTime = 30000;
@@ -89,8 +169,18 @@ protected:
   unsigned long prevPubVarsTime = 0;
   unsigned long prevPubSettingsTime = 0;
   std::unordered_map<uint8_t, unsigned long> prevPubSensorTime;
+  unsigned long publishedMessages = 0;
+  unsigned long publishedBytes = 0;
+  unsigned long publishFailures = 0;
+  unsigned long flushes = 0;
   bool connected = false;
   bool newConnection = false;
+  bool topicsChanged = false;
+  bool haDiscoveryRunning = false;
+  uint16_t haDiscoveryStep = 0;
+  unsigned long haDiscoveryStartTime = 0;
+
+  static const uint8_t haDiscoveryStaticSteps = 42;
 
   #if defined(ARDUINO_ARCH_ESP32)
   const char* getTaskName() override {
@@ -151,16 +241,27 @@ protected:
     this->writer->setPublishEventCallback([this] (const char* topic, size_t written, size_t length, bool result) {
       Log.straceln(FPSTR(L_MQTT), F("%s publish %u of %u bytes to topic: %s"), result ? F("Successfully") : F("Failed"), written, length, topic);
 
+      this->publishedMessages++;
+      this->publishedBytes += written;
+      if (!result) {
+        this->publishFailures++;
+      }
+
       #ifdef ARDUINO_ARCH_ESP8266
       ::optimistic_yield(1000);
       #endif
 
-      //this->client->poll();
-      this->delay(250);
+      // discovery is paced by its per loop budgets, see continueHaDiscovery()
+      if (!this->haDiscoveryRunning) {
+        //this->client->poll();
+        this->delay(250);
+      }
     });
 
-    #ifdef ARDUINO_ARCH_ESP8266
     this->writer->setFlushEventCallback([this] (size_t, size_t) {
+      this->flushes++;
+
+      #ifdef ARDUINO_ARCH_ESP8266
       ::optimistic_yield(1000);
 
       if (this->wifiClient->connected()) {
@@ -168,8 +269,12 @@ protected:
       }
 
       ::optimistic_yield(1000);
+      #endif
     });
-    #endif
+
+    // queue settings
+    this->queue->setFs(&LittleFS, MQTT_SPOOL_PATH, MQTT_SPOOL_MAX_SIZE);
+    this->queue->setRetransmitWindow(MQTT_RETRANSMIT_WINDOW);
 
     // ha helper settings
     this->haHelper->setDevicePrefix(settings.mqtt.prefix);
@@ -183,10 +288,34 @@ protected:
   }
 
   void loop() {
+    LoopStats::Guard loopGuard(this->loopStats);
+
     if (vars.states.restarting || vars.states.upgrading) {
       return;
     }
 
+    const uint32_t settingsChanges = takeSettingsChanges(SettingsSubscriber::MQTT);
+    if (settingsChanges) {
+      this->resetPublishedSettingsTime();
+
+      // reconnect with the new server, credentials and prefix
+      if ((settingsChanges & SETTINGS_CHANGE_MQTT_CONNECTION) && this->connected) {
+        Log.sinfoln(FPSTR(L_MQTT), F("Connection settings changed, reconnecting"));
+        this->client->stop();
+        this->lastReconnectTime = 0;
+      }
+
+      // entities depend on the unit system
+      if (settingsChanges & SETTINGS_CHANGE_UNIT_SYSTEM) {
+        this->currentHomeAssistantDiscovery = false;
+      }
+    }
+
+    if (this->topicsChanged) {
+      this->topicsChanged = false;
+      this->topics->rebuild(settings.mqtt.prefix);
+    }
+
     if (this->connected && !this->client->connected()) {
       this->connected = false;
       this->onDisconnect();
@@ -196,12 +325,13 @@ protected:
 
       this->haHelper->setDevicePrefix(settings.mqtt.prefix);
       this->haHelper->updateCachedTopics();
+      this->topics->rebuild(settings.mqtt.prefix);
 
       this->client->stop();
       this->client->setKeepAliveInterval(settings.mqtt.interval * 10000);
       this->client->setId(networkSettings.hostname);
       this->client->setUsernamePassword(settings.mqtt.user, settings.mqtt.password);
-      this->client->beginWill(this->haHelper->getDeviceTopic(F("status")).c_str(), 7, true, 1);
+      this->client->beginWill(this->topics->get(MqttTopics::Type::STATUS), 7, true, 1);
       this->client->print(F("offline"));
       this->client->endWill();
       this->client->connect(settings.mqtt.server, settings.mqtt.port);
@@ -214,6 +344,13 @@ protected:
     }
 
     if (!this->connected) {
+      this->queue->process(false);
+
+      // keep collecting samples while offline, they are replayed after reconnect
+      if (this->connectedTime > 0) {
+        this->publishSamples();
+      }
+
       return;
     }
 
@@ -228,48 +365,33 @@ protected:
     ::optimistic_yield(1000);
     #endif
 
-    // publish variables and status
+    // publish status
     if (this->newConnection || millis() - this->prevPubVarsTime > (settings.mqtt.interval * 1000u)) {
-      this->writer->publish(this->haHelper->getDeviceTopic(F("status")).c_str(), "online", false);
-      this->publishVariables(this->haHelper->getDeviceTopic(F("state")).c_str());
-      this->prevPubVarsTime = millis();
+      this->writer->publish(this->topics->get(MqttTopics::Type::STATUS), "online", false);
     }
 
+    // publish variables and sensors
+    this->publishSamples();
+
     // publish settings
     if (this->newConnection || millis() - this->prevPubSettingsTime > (settings.mqtt.interval * 10000u)) {
-      this->publishSettings(this->haHelper->getDeviceTopic(F("settings")).c_str());
+      this->publishSettings(this->topics->get(MqttTopics::Type::SETTINGS));
       this->prevPubSettingsTime = millis();
     }
 
-    // publish sensors
-    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
-      if (!Sensors::hasEnabledAndValid(sensorId)) {
-        continue;
-      }
-
-      auto& rSensor = Sensors::results[sensorId];
-      bool needUpdate = false;
-      if (millis() - this->prevPubSensorTime[sensorId] > ((this->haHelper->getExpireAfter() - 10) * 1000u)) {
-        needUpdate = true;
-
-      } else if (rSensor.activityTime >= this->prevPubSensorTime[sensorId]) {
-        auto estimated = rSensor.activityTime - this->prevPubSensorTime[sensorId];
-        needUpdate = estimated > 1000u;
-      }
-
-      if (this->newConnection || needUpdate) {
-        this->publishSensor(sensorId);
-        this->prevPubSensorTime[sensorId] = millis();
-      }
-    }
+    // send queued messages
+    this->queue->process(true, MQTT_QUEUE_MAX_MESSAGES);
 
     // publish ha entities if not published
     if (settings.mqtt.homeAssistantDiscovery) {
-      if (this->newConnection || !this->currentHomeAssistantDiscovery || this->currentUnitSystem != settings.system.unitSystem) {
-        this->publishHaEntities();
-        this->publishNonStaticHaEntities(true);
+      if (this->newConnection || !this->currentHomeAssistantDiscovery) {
+        this->beginHaDiscovery();
         this->currentHomeAssistantDiscovery = true;
-        this->currentUnitSystem = settings.system.unitSystem;
+      }
+
+      if (this->haDiscoveryRunning) {
+        // continue publishing ha entities, a few per loop
+        this->continueHaDiscovery();
 
       } else {
         // publish non static ha entities
@@ -303,35 +425,13 @@ protected:
           }
         }
 
-        if (!Sensors::hasEnabledAndValid(sensorId)) {
-          continue;
-        }
-
         // make new config
-        auto& sSettings = Sensors::settings[sensorId];
-        switch (sSettings.type) {
-          case Sensors::Type::BLUETOOTH:
-            this->haHelper->publishConnectionDynamicSensor(sSettings);
-            this->haHelper->publishSignalQualityDynamicSensor(sSettings, false);
-            this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::TEMPERATURE, settings.system.unitSystem);
-            this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::HUMIDITY, settings.system.unitSystem);
-            this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::BATTERY, settings.system.unitSystem);
-            this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::RSSI, settings.system.unitSystem, false);
-            break;
-
-          case Sensors::Type::DALLAS_TEMP:
-            this->haHelper->publishConnectionDynamicSensor(sSettings);
-            this->haHelper->publishSignalQualityDynamicSensor(sSettings, false);
-            this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::TEMPERATURE, settings.system.unitSystem);
-            break;
-          
-          default:
-            this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::PRIMARY, settings.system.unitSystem);
-        }
+        this->publishHaDynamicSensor(sensorId);
       }
 
     } else if (this->currentHomeAssistantDiscovery) {
       this->currentHomeAssistantDiscovery = false;
+      this->haDiscoveryRunning = false;
     }
 
     // reconfigure manual sensors
@@ -354,15 +454,9 @@ protected:
       }
 
       // subscribe to new topic
-      auto& sSettings = Sensors::settings[sensorId];
-      if (sSettings.type == Sensors::Type::MANUAL) {
-        this->client->subscribe(
-          this->haHelper->getDeviceTopic(
-            F("sensors"),
-            Sensors::makeObjectId(sSettings.name).c_str(),
-            F("set")
-          ).c_str()
-        );
+      const char* setTopic = this->topics->get(MqttTopics::Type::SENSOR_SET, sensorId);
+      if (setTopic != nullptr) {
+        this->client->subscribe(setTopic);
       }
     }
 
@@ -380,33 +474,28 @@ protected:
     unsigned long downtime = (millis() - this->disconnectedTime) / 1000;
     Log.sinfoln(FPSTR(L_MQTT), F("Connected (downtime: %u s.)"), downtime);
 
-    this->client->subscribe(this->haHelper->getDeviceTopic(F("settings/set")).c_str());
-    this->client->subscribe(this->haHelper->getDeviceTopic(F("state/set")).c_str());
+    this->client->subscribe(this->topics->get(MqttTopics::Type::SETTINGS_SET));
+    this->client->subscribe(this->topics->get(MqttTopics::Type::STATE_SET));
 
     // subscribe to manual sensors
     for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
-      if (!Sensors::hasEnabledAndValid(sensorId)) {
+      const char* setTopic = this->topics->get(MqttTopics::Type::SENSOR_SET, sensorId);
+      if (setTopic == nullptr) {
         continue;
       }
 
-      auto& sSettings = Sensors::settings[sensorId];
-      if (sSettings.type != Sensors::Type::MANUAL) {
-        continue;
-      }
-
-      this->client->subscribe(
-        this->haHelper->getDeviceTopic(
-          F("sensors"),
-          Sensors::makeObjectId(sSettings.name).c_str(),
-          F("set")
-        ).c_str()
-      );
+      this->client->subscribe(setTopic);
     }
   }
 
   void onDisconnect() {
     this->disconnectedTime = millis();
 
+    if (this->haDiscoveryRunning) {
+      this->haDiscoveryRunning = false;
+      Log.swarningln(FPSTR(L_MQTT_HA), F("Discovery interrupted at step %hu of %hu"), this->haDiscoveryStep, this->getHaDiscoveryTotalSteps());
+    }
+
     unsigned long uptime = (millis() - this->connectedTime) / 1000;
     Log.swarningln(FPSTR(L_MQTT), F("Disconnected (reason: %d uptime: %lu s.)"), this->client->connectError(), uptime);
   }
@@ -436,125 +525,370 @@ protected:
       }
     }
 
-    JsonDocument doc;
-    DeserializationError dErr = deserializeJson(doc, payload, length);
-    if (dErr != DeserializationError::Ok) {
-      Log.swarningln(FPSTR(L_MQTT_MSG), F("Error on deserialization: %s"), dErr.f_str());
+    auto match = this->topics->match(topic.c_str(), topic.length());
+    if (match.type == MqttTopics::Type::UNKNOWN) {
       return;
+    }
+
+    bool valid = false;
+    switch (match.type) {
+      case MqttTopics::Type::STATE_SET: {
+        JsonCommandParser parser(varsCommandPaths, sizeof(varsCommandPaths) / sizeof(*varsCommandPaths));
+        valid = parser.parse(payload, length, nullptr);
+
+        if (valid) {
+          parser.parse(payload, length, [] (uint8_t id, const JsonCommandParser::Value& value) {
+            if (!value.isBool() || !value.asBool()) {
+              return;
+            }
+
+            switch (static_cast<VarsCommand>(id)) {
+              case VarsCommand::RESTART:
+                vars.actions.restart = true;
+                break;
+
+              case VarsCommand::RESET_FAULT:
+                vars.actions.resetFault = true;
+                break;
+
+              case VarsCommand::RESET_DIAGNOSTIC:
+                vars.actions.resetDiagnostic = true;
+                break;
+
+              case VarsCommand::START_PID_AUTOTUNE:
+                vars.actions.startPidAutotune = true;
+                break;
+
+              case VarsCommand::STOP_PID_AUTOTUNE:
+                vars.actions.stopPidAutotune = true;
+                break;
+
+              case VarsCommand::APPLY_PID_AUTOTUNE:
+                vars.actions.applyPidAutotune = true;
+                break;
+
+              case VarsCommand::APPLY_EQUITHERM_LEARNING:
+                vars.actions.applyEquithermLearning = true;
+                break;
+            }
+          });
+        }
+        break;
+      }
+
+      case MqttTopics::Type::SETTINGS_SET: {
+        // settings are parsed into a preallocated buffer, the heap is used
+        // only for payloads that do not fit it (e.g. a full settings object)
+        ArenaAllocator allocator(this->commandBuffer, this->commandBuffer != nullptr ? MQTT_COMMAND_BUFFER_SIZE : 0);
+        JsonDocument arenaDoc(&allocator);
+        JsonDocument heapDoc;
+        JsonDocument* doc = &arenaDoc;
+
+        DeserializationError dErr = deserializeJson(
+          *doc, payload, length,
+          DeserializationOption::NestingLimit(JsonCommandParser::MAX_DEPTH)
+        );
+
+        if (dErr == DeserializationError::NoMemory) {
+          Log.straceln(FPSTR(L_MQTT_MSG), F("Settings payload (%u bytes) does not fit the command buffer, using heap"), length);
+
+          arenaDoc.clear();
+          doc = &heapDoc;
+          dErr = deserializeJson(
+            *doc, payload, length,
+            DeserializationOption::NestingLimit(JsonCommandParser::MAX_DEPTH)
+          );
+        }
 
-    } else if (doc.isNull() || !doc.size()) {
+        if (dErr != DeserializationError::Ok) {
+          Log.swarningln(FPSTR(L_MQTT_MSG), F("Error on deserialization: %s"), dErr.f_str());
+          return;
+        }
+
+        valid = !doc->isNull() && doc->size();
+
+        SettingsChanges changes;
+        if (valid && safeJsonToSettings(*doc, settings, &changes)) {
+          fsSettings.update();
+          publishSettingsChanges(changes.groups);
+        }
+        break;
+      }
+
+      case MqttTopics::Type::SENSOR_SET: {
+        JsonCommandParser parser(sensorCommandPaths, sizeof(sensorCommandPaths) / sizeof(*sensorCommandPaths));
+        valid = parser.parse(payload, length, nullptr);
+
+        auto& sSettings = Sensors::settings[match.sensorId];
+        if (!valid || !sSettings.enabled || sSettings.type != Sensors::Type::MANUAL) {
+          break;
+        }
+
+        bool changed = false;
+        parser.parse(payload, length, [&match, &changed] (uint8_t, const JsonCommandParser::Value& value) {
+          if (!value.isNumber()) {
+            return;
+          }
+
+          changed = Sensors::setValueById(match.sensorId, value.asFloat(), Sensors::ValueType::PRIMARY, true, true);
+        });
+
+        if (changed) {
+          this->resetPublishedSensorTime(match.sensorId);
+        }
+        break;
+      }
+
+      default:
+        break;
+    }
+
+    if (!valid) {
       Log.swarningln(FPSTR(L_MQTT_MSG), F("Not valid json"));
       return;
     }
-    doc.shrinkToFit();
 
     // delete topic
     this->writer->publish(topic.c_str(), nullptr, 0, true);
+  }
 
-    if (this->haHelper->getDeviceTopic(F("state/set")).equals(topic)) {
-      if (jsonToVars(doc, vars)) {
-        this->resetPublishedVarsTime();
+  void beginHaDiscovery() {
+    if (this->haDiscoveryRunning) {
+      Log.sinfoln(FPSTR(L_MQTT_HA), F("Discovery restarted at step %hu"), this->haDiscoveryStep);
+
+    } else {
+      Log.sinfoln(FPSTR(L_MQTT_HA), F("Discovery started"));
+    }
+
+    this->haDiscoveryRunning = true;
+    this->haDiscoveryStep = 0;
+    this->haDiscoveryStartTime = millis();
+  }
+
+  void continueHaDiscovery() {
+    const unsigned long startMessages = this->publishedMessages;
+    const unsigned long startBytes = this->publishedBytes;
+
+    while (this->haDiscoveryRunning) {
+      if (this->publishedMessages - startMessages >= MQTT_HA_DISCOVERY_MAX_MESSAGES) {
+        break;
+
+      } else if (this->publishedBytes - startBytes >= MQTT_HA_DISCOVERY_MAX_BYTES) {
+        break;
+
+      } else if (!this->client->connected()) {
+        break;
       }
 
-    } else if (this->haHelper->getDeviceTopic(F("settings/set")).equals(topic)) {
-      if (safeJsonToSettings(doc, settings)) {
-        this->resetPublishedSettingsTime();
-        fsSettings.update();
+      #ifdef ARDUINO_ARCH_ESP8266
+      // wait until the tcp send buffer is drained
+      if (this->wifiClient->availableForWrite() < MQTT_HA_DISCOVERY_MIN_TX_SPACE) {
+        break;
       }
+      #endif
 
-    } else {
-      const String& sensorsTopic = this->haHelper->getDeviceTopic(F("sensors/"));
-      auto stLength = sensorsTopic.length();
+      if (this->haDiscoveryStep >= this->getHaDiscoveryTotalSteps()) {
+        this->haDiscoveryRunning = false;
 
-      if (topic.startsWith(sensorsTopic) && topic.endsWith(F("/set"))) {
-        if (topic.length() > stLength + 4) {
-          const String& name = topic.substring(stLength, topic.indexOf('/', stLength));
-          int16_t id = Sensors::getIdByObjectId(name.c_str());
+        Log.sinfoln(
+          FPSTR(L_MQTT_HA), F("Discovery completed in %lu ms"),
+          millis() - this->haDiscoveryStartTime
+        );
+        break;
+      }
 
-          if (id == -1) {
-            return;
-          }
+      this->publishHaEntitiesStep(this->haDiscoveryStep++);
 
-          if (jsonToSensorResult(id, doc)) {
-            this->resetPublishedSensorTime(id);
-          }
-        }
-      }
+      // process incoming commands between steps
+      this->client->poll();
     }
   }
 
-  void publishHaEntities() {
-    // heating
-    this->haHelper->publishSwitchHeatingTurbo(false);
-    this->haHelper->publishSwitchHeatingHysteresis();
-    this->haHelper->publishInputHeatingHysteresis(settings.system.unitSystem);
-    this->haHelper->publishInputHeatingTurboFactor(false);
-    this->haHelper->publishInputHeatingMinTemp(settings.system.unitSystem);
-    this->haHelper->publishInputHeatingMaxTemp(settings.system.unitSystem);
-
-    // pid
-    this->haHelper->publishSwitchPid();
-    this->haHelper->publishInputPidFactorP(false);
-    this->haHelper->publishInputPidFactorI(false);
-    this->haHelper->publishInputPidFactorD(false);
-    this->haHelper->publishInputPidDt(false);
-    this->haHelper->publishInputPidMinTemp(settings.system.unitSystem, false);
-    this->haHelper->publishInputPidMaxTemp(settings.system.unitSystem, false);
-
-    // equitherm
-    this->haHelper->publishSwitchEquitherm();
-    this->haHelper->publishInputEquithermSlope(false);
-    this->haHelper->publishInputEquithermExponent(false);
-    this->haHelper->publishInputEquithermShift(false);
-    this->haHelper->publishInputEquithermTargetDiffFactor(false);
-
-    // states
-    this->haHelper->publishStatusState();
-    this->haHelper->publishEmergencyState();
-    this->haHelper->publishOpenthermConnectedState();
-    this->haHelper->publishHeatingState();
-    this->haHelper->publishFlameState();
-    this->haHelper->publishFaultState();
-    this->haHelper->publishDiagState();
-    this->haHelper->publishExternalPumpState(false);
-
-    // sensors
-    this->haHelper->publishFaultCode();
-    this->haHelper->publishDiagCode();
-    this->haHelper->publishNetworkRssi(false);
-    this->haHelper->publishUptime(false);
-
-    // buttons
-    this->haHelper->publishRestartButton(false);
-    this->haHelper->publishResetFaultButton();
-    this->haHelper->publishResetDiagButton();
-
-    // dynamic sensors
-    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
-      if (!Sensors::hasEnabledAndValid(sensorId)) {
-        continue;
-      }
+  void publishHaEntitiesStep(uint16_t step) {
+    if (step >= haDiscoveryStaticSteps) {
+      uint16_t sensorId = step - haDiscoveryStaticSteps;
 
-      auto& sSettings = Sensors::settings[sensorId];
-      switch (sSettings.type) {
-        case Sensors::Type::BLUETOOTH:
-          this->haHelper->publishConnectionDynamicSensor(sSettings);
-          this->haHelper->publishSignalQualityDynamicSensor(sSettings, false);
-          this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::TEMPERATURE, settings.system.unitSystem);
-          this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::HUMIDITY, settings.system.unitSystem);
-          this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::BATTERY, settings.system.unitSystem);
-          this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::RSSI, settings.system.unitSystem, false);
-          break;
+      if (sensorId <= Sensors::getMaxSensorId()) {
+        this->publishHaDynamicSensor(sensorId);
 
-        case Sensors::Type::DALLAS_TEMP:
-          this->haHelper->publishConnectionDynamicSensor(sSettings);
-          this->haHelper->publishSignalQualityDynamicSensor(sSettings, false);
-          this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::TEMPERATURE, settings.system.unitSystem);
-          break;
-        
-        default:
-          this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::PRIMARY, settings.system.unitSystem);
+      } else {
+        this->publishNonStaticHaEntities(true);
       }
+
+      return;
+    }
+
+    switch (step) {
+      // heating
+      case 0:
+        this->haHelper->publishSwitchHeatingTurbo(false);
+        break;
+      case 1:
+        this->haHelper->publishSwitchHeatingHysteresis();
+        break;
+      case 2:
+        this->haHelper->publishInputHeatingHysteresis(settings.system.unitSystem);
+        break;
+      case 3:
+        this->haHelper->publishInputHeatingTurboFactor(false);
+        break;
+      case 4:
+        this->haHelper->publishInputHeatingMinTemp(settings.system.unitSystem);
+        break;
+      case 5:
+        this->haHelper->publishInputHeatingMaxTemp(settings.system.unitSystem);
+        break;
+
+      // pid
+      case 6:
+        this->haHelper->publishSwitchPid();
+        break;
+      case 7:
+        this->haHelper->publishInputPidFactorP(false);
+        break;
+      case 8:
+        this->haHelper->publishInputPidFactorI(false);
+        break;
+      case 9:
+        this->haHelper->publishInputPidFactorD(false);
+        break;
+      case 10:
+        this->haHelper->publishInputPidDt(false);
+        break;
+      case 11:
+        this->haHelper->publishInputPidMinTemp(settings.system.unitSystem, false);
+        break;
+      case 12:
+        this->haHelper->publishInputPidMaxTemp(settings.system.unitSystem, false);
+        break;
+
+      // equitherm
+      case 13:
+        this->haHelper->publishSwitchEquitherm();
+        break;
+      case 14:
+        this->haHelper->publishInputEquithermSlope(false);
+        break;
+      case 15:
+        this->haHelper->publishInputEquithermExponent(false);
+        break;
+      case 16:
+        this->haHelper->publishInputEquithermShift(false);
+        break;
+      case 17:
+        this->haHelper->publishInputEquithermTargetDiffFactor(false);
+        break;
+
+      // states
+      case 18:
+        this->haHelper->publishStatusState();
+        break;
+      case 19:
+        this->haHelper->publishEmergencyState();
+        break;
+      case 20:
+        this->haHelper->publishOpenthermConnectedState();
+        break;
+      case 21:
+        this->haHelper->publishHeatingState();
+        break;
+      case 22:
+        this->haHelper->publishFlameState();
+        break;
+      case 23:
+        this->haHelper->publishFaultState();
+        break;
+      case 24:
+        this->haHelper->publishDiagState();
+        break;
+      case 25:
+        this->haHelper->publishExternalPumpState(false);
+        break;
+
+      // sensors
+      case 26:
+        this->haHelper->publishFaultCode();
+        break;
+      case 27:
+        this->haHelper->publishDiagCode();
+        break;
+      case 28:
+        this->haHelper->publishNetworkRssi(false);
+        break;
+      case 29:
+        this->haHelper->publishUptime(false);
+        break;
+
+      // buttons
+      case 30:
+        this->haHelper->publishRestartButton(false);
+        break;
+      case 31:
+        this->haHelper->publishResetFaultButton();
+        break;
+      case 32:
+        this->haHelper->publishResetDiagButton();
+        break;
+
+      // pid auto-tune
+      case 33:
+        this->haHelper->publishPidAutotuneState(false);
+        break;
+      case 34:
+        this->haHelper->publishPidAutotuneProgress(false);
+        break;
+      case 35:
+        this->haHelper->publishStartPidAutotuneButton(false);
+        break;
+      case 36:
+        this->haHelper->publishStopPidAutotuneButton(false);
+        break;
+      case 37:
+        this->haHelper->publishApplyPidAutotuneButton(false);
+        break;
+
+      // anti short cycling
+      case 38:
+        this->haHelper->publishBurnerCycles(false);
+        break;
+      case 39:
+        this->haHelper->publishAntiCyclingLockout(false);
+        break;
+
+      // schedule
+      case 40:
+        this->haHelper->publishSwitchHeatingSchedule(false);
+        break;
+      case 41:
+        this->haHelper->publishScheduleTarget(settings.system.unitSystem, false);
+        break;
+    }
+  }
+
+  void publishHaDynamicSensor(uint8_t sensorId) {
+    if (!Sensors::hasEnabledAndValid(sensorId)) {
+      return;
+    }
+
+    auto& sSettings = Sensors::settings[sensorId];
+    switch (sSettings.type) {
+      case Sensors::Type::BLUETOOTH:
+        this->haHelper->publishConnectionDynamicSensor(sSettings);
+        this->haHelper->publishSignalQualityDynamicSensor(sSettings, false);
+        this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::TEMPERATURE, settings.system.unitSystem);
+        this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::HUMIDITY, settings.system.unitSystem);
+        this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::BATTERY, settings.system.unitSystem);
+        this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::RSSI, settings.system.unitSystem, false);
+        break;
+
+      case Sensors::Type::DALLAS_TEMP:
+        this->haHelper->publishConnectionDynamicSensor(sSettings);
+        this->haHelper->publishSignalQualityDynamicSensor(sSettings, false);
+        this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::TEMPERATURE, settings.system.unitSystem);
+        break;
+      
+      default:
+        this->haHelper->publishDynamicSensor(sSettings, Sensors::ValueType::PRIMARY, settings.system.unitSystem);
     }
   }
 
@@ -609,12 +943,42 @@ protected:
     return published;
   }
 
+  void publishSamples() {
+    // publish variables
+    if (this->newConnection || millis() - this->prevPubVarsTime > (settings.mqtt.interval * 1000u)) {
+      this->publishVariables(this->topics->get(MqttTopics::Type::STATE));
+      this->prevPubVarsTime = millis();
+    }
+
+    // publish sensors
+    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+      if (!Sensors::hasEnabledAndValid(sensorId)) {
+        continue;
+      }
+
+      auto& rSensor = Sensors::results[sensorId];
+      bool needUpdate = false;
+      if (millis() - this->prevPubSensorTime[sensorId] > ((this->haHelper->getExpireAfter() - 10) * 1000u)) {
+        needUpdate = true;
+
+      } else if (rSensor.activityTime >= this->prevPubSensorTime[sensorId]) {
+        auto estimated = rSensor.activityTime - this->prevPubSensorTime[sensorId];
+        needUpdate = estimated > 1000u;
+      }
+
+      if (this->newConnection || needUpdate) {
+        this->publishSensor(sensorId);
+        this->prevPubSensorTime[sensorId] = millis();
+      }
+    }
+  }
+
   bool publishSettings(const char* topic) {
     JsonDocument doc;
     safeSettingsToJson(settings, doc);
     doc.shrinkToFit();
 
-    return this->writer->publish(topic, doc, true);
+    return this->queue->push(topic, doc, true, MQTT_QOS);
   }
 
   bool publishSensor(uint8_t sensorId) {
@@ -627,16 +991,20 @@ protected:
       return false;
     }
 
+    const char* topic = this->topics->get(MqttTopics::Type::SENSOR_STATE, sensorId);
+    if (topic == nullptr) {
+      return false;
+    }
+
     JsonDocument doc;
     sensorResultToJson(sensorId, doc);
     doc.shrinkToFit();
 
-    return this->writer->publish(
-      this->haHelper->getDeviceTopic(
-        F("sensors"),
-        Sensors::makeObjectId(sSettings.name).c_str()
-      ).c_str(),
+    return this->queue->push(
+      topic,
       doc,
+      true,
+      MQTT_QOS,
       true
     );
   }
@@ -646,6 +1014,6 @@ protected:
     varsToJson(vars, doc);
     doc.shrinkToFit();
 
-    return this->writer->publish(topic, doc, true);
+    return this->queue->push(topic, doc, true, MQTT_QOS, true);
   }
 };
\ No newline at end of file
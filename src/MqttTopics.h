@@ -0,0 +1,198 @@
+#pragma once
+
+class MqttTopics {
+public:
+  enum class Type : uint8_t {
+    STATUS,
+    STATE,
+    STATE_SET,
+    SETTINGS,
+    SETTINGS_SET,
+    SENSOR_STATE,
+    SENSOR_SET,
+    UNKNOWN
+  };
+
+  struct Match {
+    Type type = Type::UNKNOWN;
+    uint8_t sensorId = 0;
+  };
+
+  MqttTopics() {
+    for (uint8_t i = 0; i < amount; i++) {
+      this->offsets[i] = NONE;
+      this->hashes[i] = 0;
+    }
+  }
+
+  ~MqttTopics() {
+    free(this->arena);
+  }
+
+  /**
+   * Builds all device topics into one arena.
+   * Must be called after the prefix or the sensors settings are changed.
+   */
+  void rebuild(const char* prefix) {
+    String objIds[SENSORS_AMOUNT];
+    const size_t prefixLength = strlen(prefix);
+
+    // calculate arena size
+    size_t size = 0;
+    for (uint8_t i = 0; i < staticAmount; i++) {
+      size += prefixLength + 1 + strlen_P(staticSuffixes[i]) + 1;
+    }
+
+    for (uint8_t sensorId = 0; sensorId < SENSORS_AMOUNT; sensorId++) {
+      if (!Sensors::hasEnabledAndValid(sensorId)) {
+        continue;
+      }
+
+      Sensors::makeObjectId(objIds[sensorId], Sensors::settings[sensorId].name);
+
+      // "<prefix>/sensors/<objId>" and "<prefix>/sensors/<objId>/set"
+      size += (prefixLength + 9 + objIds[sensorId].length() + 1) * 2 + 4;
+    }
+
+    if (size > this->arenaSize) {
+      free(this->arena);
+      this->arena = (char*) malloc(size);
+      this->arenaSize = this->arena != nullptr ? size : 0;
+    }
+
+    for (uint8_t i = 0; i < amount; i++) {
+      this->offsets[i] = NONE;
+      this->hashes[i] = 0;
+    }
+
+    if (this->arena == nullptr) {
+      return;
+    }
+
+    // build topics
+    size_t pos = 0;
+    for (uint8_t i = 0; i < staticAmount; i++) {
+      this->offsets[i] = pos;
+      pos += sprintf(this->arena + pos, "%s/", prefix);
+
+      strcpy_P(this->arena + pos, staticSuffixes[i]);
+      pos += strlen(this->arena + pos) + 1;
+    }
+
+    for (uint8_t sensorId = 0; sensorId < SENSORS_AMOUNT; sensorId++) {
+      if (!objIds[sensorId].length()) {
+        continue;
+      }
+
+      const uint8_t stateIndex = staticAmount + sensorId;
+      this->offsets[stateIndex] = pos;
+      pos += sprintf_P(this->arena + pos, PSTR("%s/sensors/%s"), prefix, objIds[sensorId].c_str()) + 1;
+
+      if (Sensors::settings[sensorId].type == Sensors::Type::MANUAL) {
+        const uint8_t setIndex = staticAmount + SENSORS_AMOUNT + sensorId;
+        this->offsets[setIndex] = pos;
+        pos += sprintf_P(this->arena + pos, PSTR("%s/sensors/%s/set"), prefix, objIds[sensorId].c_str()) + 1;
+      }
+    }
+
+    for (uint8_t i = 0; i < amount; i++) {
+      if (this->offsets[i] != NONE) {
+        this->hashes[i] = hash(this->arena + this->offsets[i], strlen(this->arena + this->offsets[i]));
+      }
+    }
+  }
+
+  const char* get(Type type, uint8_t sensorId = 0) {
+    const uint8_t index = getIndex(type, sensorId);
+    if (index >= amount || this->offsets[index] == NONE) {
+      return nullptr;
+    }
+
+    return this->arena + this->offsets[index];
+  }
+
+  Match match(const char* topic, size_t length) {
+    Match result;
+    const uint32_t topicHash = hash(topic, length);
+
+    for (uint8_t i = 0; i < amount; i++) {
+      if (this->offsets[i] == NONE || this->hashes[i] != topicHash) {
+        continue;
+      }
+
+      const char* ref = this->arena + this->offsets[i];
+      if (strncmp(ref, topic, length) != 0 || ref[length] != '\0') {
+        continue;
+      }
+
+      if (i < staticAmount) {
+        result.type = static_cast<Type>(i);
+
+      } else if (i < staticAmount + SENSORS_AMOUNT) {
+        result.type = Type::SENSOR_STATE;
+        result.sensorId = i - staticAmount;
+
+      } else {
+        result.type = Type::SENSOR_SET;
+        result.sensorId = i - staticAmount - SENSORS_AMOUNT;
+      }
+
+      break;
+    }
+
+    return result;
+  }
+
+  // FNV-1a
+  static uint32_t hash(const char* value, size_t length) {
+    uint32_t result = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+      result ^= (uint8_t) value[i];
+      result *= 16777619u;
+    }
+
+    return result;
+  }
+
+protected:
+  static const uint8_t staticAmount = 5;
+  static const uint8_t amount = staticAmount + SENSORS_AMOUNT * 2;
+  static const uint16_t NONE = 0xffff;
+  static const char* const staticSuffixes[staticAmount];
+
+  char* arena = nullptr;
+  size_t arenaSize = 0;
+  uint16_t offsets[amount];
+  uint32_t hashes[amount];
+
+  static uint8_t getIndex(Type type, uint8_t sensorId) {
+    switch (type) {
+      case Type::SENSOR_STATE:
+        return sensorId < SENSORS_AMOUNT ? staticAmount + sensorId : amount;
+
+      case Type::SENSOR_SET:
+        return sensorId < SENSORS_AMOUNT ? staticAmount + SENSORS_AMOUNT + sensorId : amount;
+
+      case Type::UNKNOWN:
+        return amount;
+
+      default:
+        return static_cast<uint8_t>(type);
+    }
+  }
+};
+
+const char MQTT_TOPIC_STATUS[] PROGMEM = "status";
+const char MQTT_TOPIC_STATE[] PROGMEM = "state";
+const char MQTT_TOPIC_STATE_SET[] PROGMEM = "state/set";
+const char MQTT_TOPIC_SETTINGS[] PROGMEM = "settings";
+const char MQTT_TOPIC_SETTINGS_SET[] PROGMEM = "settings/set";
+
+// order must match MqttTopics::Type
+const char* const MqttTopics::staticSuffixes[] = {
+  MQTT_TOPIC_STATUS,
+  MQTT_TOPIC_STATE,
+  MQTT_TOPIC_STATE_SET,
+  MQTT_TOPIC_SETTINGS,
+  MQTT_TOPIC_SETTINGS_SET
+};
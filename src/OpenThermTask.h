@@ -1,5 +1,5 @@
 #include <CustomOpenTherm.h>
-extern FileData fsSettings;
+extern JournalData fsSettings;
 
 class OpenThermTask : public Task {
 public:
@@ -9,7 +9,14 @@ public:
     delete this->instance;
   }
 
+  // nullptr if the bus is not configured
+  inline const CustomOpenTherm::Stats* getBusStats() {
+    return this->instance != nullptr ? &this->instance->getStats() : nullptr;
+  }
+
 protected:
+  LoopStats loopStats{"opentherm"};
+
   const unsigned short readyTime = 60000u;
   const unsigned int resetBusInterval = 120000u;
   const unsigned short heatingSetTempInterval = 60000u;
@@ -47,7 +54,17 @@ protected:
   }
   #endif
 
+  void setupMaster() {
+    vars.master.memberId = settings.opentherm.memberId;
+    vars.master.flags = settings.opentherm.flags;
+    vars.master.protocolVersion = 2.2f;
+    vars.master.appVersion = 0x3F;
+    vars.master.type = 0x01;
+  }
+
   void setup() {
+    this->setupMaster();
+
     // Convert defaults at start
     if (settings.system.unitSystem != UnitSystem::METRIC) {
       vars.slave.heating.minTemp = convertTemp(vars.slave.heating.minTemp, UnitSystem::METRIC, settings.system.unitSystem);
@@ -119,20 +136,20 @@ protected:
   }
 
   void loop() {
+    LoopStats::Guard loopGuard(this->loopStats);
+
     if (vars.states.restarting || vars.states.upgrading) {
       return;
     }
 
-    if (this->instanceInGpio != settings.opentherm.inGpio || this->instanceOutGpio != settings.opentherm.outGpio) {
+    const uint32_t settingsChanges = takeSettingsChanges(SettingsSubscriber::OPENTHERM);
+
+    if (settingsChanges & SETTINGS_CHANGE_OT_GPIO) {
       this->setup();
 
-    } else if (vars.master.memberId != settings.opentherm.memberId || vars.master.flags != settings.opentherm.flags) {
+    } else if (settingsChanges & SETTINGS_CHANGE_OT_MASTER) {
       this->initialized = false;
-      vars.master.memberId = settings.opentherm.memberId;
-      vars.master.flags = settings.opentherm.flags;
-      vars.master.protocolVersion = 2.2f;
-      vars.master.appVersion = 0x3F;
-      vars.master.type = 0x01;
+      this->setupMaster();
 
     } else if (millis() - this->initializedTime > this->initializingInterval) {
       this->initialized = false;
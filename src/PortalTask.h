@@ -11,27 +11,42 @@ using WebServer = ESP8266WebServer;
 #include <Update.h>
 #endif
 #include <BufferedWebServer.h>
+#include <MetricsWriter.h>
+#include <EventStream.h>
+#include <StateVersion.h>
 #include <StaticPage.h>
+#include <StaticAssets.h>
 #include <DynamicPage.h>
 #include <UpgradeHandler.h>
+#include <RestoreHandler.h>
 #include <DNSServer.h>
+#include <new>
 
 using namespace NetworkUtils;
 
 extern NetworkMgr* network;
-extern FileData fsNetworkSettings, fsSettings, fsSensorsSettings;
+extern FileData fsNetworkSettings;
+extern JournalData fsSettings, fsSensorsSettings, fsScheduleSettings;
 extern MqttTask* tMqtt;
+extern OpenThermTask* tOt;
 
 
 class PortalTask : public LeanTask {
 public:
   PortalTask(bool _enabled = false, unsigned long _interval = 0) : LeanTask(_enabled, _interval) {
     this->webServer = new WebServer(80);
-    this->bufferedWebServer = new BufferedWebServer(this->webServer, 32u);
+    this->bufferedWebServer = new BufferedWebServer(this->webServer);
+    this->eventStream = new EventStream(this->webServer, PORTAL_EVENTS_MAX_CLIENTS);
+    this->assetsManifest = new AssetsManifest(&LittleFS, "/manifest.json");
     this->dnsServer = new DNSServer();
+
+    // random boot epoch, "since" of the sensors query is meaningless across reboots
+    this->sensorsVersion.setEpoch(random(1, 0x10000));
   }
 
   ~PortalTask() {
+    delete this->eventStream;
+    delete this->assetsManifest;
     delete this->bufferedWebServer;
 
     if (this->webServer != nullptr) {
@@ -46,10 +61,15 @@ public:
   }
 
 protected:
+  LoopStats loopStats{"portal"};
+
   const unsigned int changeStateInterval = 5000;
 
   WebServer* webServer = nullptr;
   BufferedWebServer* bufferedWebServer = nullptr;
+  EventStream* eventStream = nullptr;
+  AssetsManifest* assetsManifest = nullptr;
+  UpgradeHandler* upgradeHandler = nullptr;
   DNSServer* dnsServer = nullptr;
 
   bool webServerEnabled = false;
@@ -57,6 +77,32 @@ protected:
   unsigned long webServerChangeState = 0;
   bool mDnsState = false;
 
+  JsonDocument eventsVarsDoc;
+  unsigned long eventsTime = 0;
+  unsigned long eventsSensorTime[SENSORS_AMOUNT] = {};
+
+  StateVersion varsVersion{BUILD_ENV " " BUILD_VERSION};
+  StateVersion settingsVersion{BUILD_ENV " " BUILD_VERSION};
+  StateVersion sensorsVersion{BUILD_ENV " " BUILD_VERSION};
+  StateVersion infoVersion{BUILD_ENV " " BUILD_VERSION};
+  StateVersion sensorVersion;
+  uint32_t sensorsHashes[SENSORS_AMOUNT] = {};
+  uint32_t sensorsChangedVersions[SENSORS_AMOUNT] = {};
+
+  // restored sections are applied to copies, the copies are committed only after the whole backup is valid
+  struct RestoreStaging {
+    NetworkSettings network;
+    Settings settings;
+    ScheduleSettings schedule;
+    Sensors::Settings sensors[SENSORS_AMOUNT];
+    uint32_t settingsChanges = 0;
+    bool networkChanged = false;
+    bool settingsChanged = false;
+    bool scheduleChanged = false;
+    bool sensorsChanged = false;
+  };
+  RestoreStaging* restoreStaging = nullptr;
+
   #if defined(ARDUINO_ARCH_ESP32)
   const char* getTaskName() override {
     return "Portal";
@@ -74,6 +120,17 @@ protected:
   void setup() {
     this->dnsServer->setTTL(0);
     this->dnsServer->setErrorReplyCode(DNSReplyCode::NoError);
+
+    if (this->assetsManifest->load()) {
+      Log.straceln(FPSTR(L_PORTAL_WEBSERVER), F("Loaded assets manifest, %u items"), this->assetsManifest->size());
+
+    } else {
+      Log.swarningln(FPSTR(L_PORTAL_WEBSERVER), F("Failed to load assets manifest"));
+    }
+
+    // for gzip responses
+    const char* headerKeys[] = {"Accept-Encoding"};
+    this->webServer->collectHeaders(headerKeys, 1);
     this->webServer->enableETag(true, [](FS &fs, const String &fName) -> const String {
       char buf[32];
       {
@@ -105,10 +162,13 @@ protected:
         return result;
       });
     this->webServer->addHandler(indexPage);*/
-    this->webServer->addHandler(new StaticPage("/", &LittleFS, F("/pages/index.html"), PORTAL_CACHE));
+    auto indexPage = (new StaticPage("/", &LittleFS, F("/pages/index.html"), PORTAL_CACHE))
+      ->setManifest(this->assetsManifest);
+    this->webServer->addHandler(indexPage);
 
     // dashboard page
     auto dashboardPage = (new StaticPage("/dashboard.html", &LittleFS, F("/pages/dashboard.html"), PORTAL_CACHE))
+      ->setManifest(this->assetsManifest)
       ->setBeforeSendCallback([this]() {
         if (this->isAuthRequired() && !this->isValidCredentials()) {
           this->webServer->requestAuthentication(BASIC_AUTH);
@@ -133,6 +193,7 @@ protected:
 
     // network settings page
     auto networkPage = (new StaticPage("/network.html", &LittleFS, F("/pages/network.html"), PORTAL_CACHE))
+      ->setManifest(this->assetsManifest)
       ->setBeforeSendCallback([this]() {
         if (this->isAuthRequired() && !this->isValidCredentials()) {
           this->webServer->requestAuthentication(BASIC_AUTH);
@@ -145,6 +206,7 @@ protected:
 
     // settings page
     auto settingsPage = (new StaticPage("/settings.html", &LittleFS, F("/pages/settings.html"), PORTAL_CACHE))
+      ->setManifest(this->assetsManifest)
       ->setBeforeSendCallback([this]() {
         if (this->isAuthRequired() && !this->isValidCredentials()) {
           this->webServer->requestAuthentication(BASIC_AUTH);
@@ -157,6 +219,7 @@ protected:
 
     // sensors page
     auto sensorsPage = (new StaticPage("/sensors.html", &LittleFS, F("/pages/sensors.html"), PORTAL_CACHE))
+      ->setManifest(this->assetsManifest)
       ->setBeforeSendCallback([this]() {
         if (this->isAuthRequired() && !this->isValidCredentials()) {
           this->webServer->requestAuthentication(BASIC_AUTH);
@@ -169,6 +232,7 @@ protected:
 
     // upgrade page
     auto upgradePage = (new StaticPage("/upgrade.html", &LittleFS, F("/pages/upgrade.html"), PORTAL_CACHE))
+      ->setManifest(this->assetsManifest)
       ->setBeforeSendCallback([this]() {
         if (this->isAuthRequired() && !this->isValidCredentials()) {
           this->webServer->requestAuthentication(BASIC_AUTH);
@@ -208,39 +272,51 @@ protected:
       response.concat((short int) fwResult.status);
       response.concat(F(", \"error\": \""));
       response.concat(fwResult.error);
-      response.concat(F("\"}, \"filesystem\": {\"status\": "));
+      response.concat(F("\", \"written\": "));
+      response.concat(fwResult.written);
+      response.concat(F(", \"chunks\": "));
+      response.concat(fwResult.chunks);
+      response.concat(F("}, \"filesystem\": {\"status\": "));
       response.concat((short int) fsResult.status);
       response.concat(F(", \"error\": \""));
       response.concat(fsResult.error);
-      response.concat(F("\"}}"));
+      response.concat(F("\", \"written\": "));
+      response.concat(fsResult.written);
+      response.concat(F(", \"chunks\": "));
+      response.concat(fsResult.chunks);
+      response.concat(F("}}"));
       this->webServer->send(status, F("application/json"), response);
 
       vars.states.upgrading = false;
     });
     this->webServer->addHandler(upgradeHandler);
+    this->upgradeHandler = upgradeHandler;
 
-
-    // backup
-    this->webServer->on(F("/api/backup/save"), HTTP_GET, [this]() {
+    // progress of the current (or interrupted) upgrade, used to resume the upload
+    this->webServer->on(F("/api/upgrade"), HTTP_GET, [this, upgradeHandler]() {
       if (this->isAuthRequired() && !this->isValidCredentials()) {
         return this->webServer->send(401);
       }
 
+      auto& progress = upgradeHandler->getProgress();
+
       JsonDocument doc;
+      doc[FPSTR(S_RUNNING)] = progress.running;
+      doc[FPSTR(S_TYPE)] = static_cast<uint8_t>(progress.type);
+      doc[FPSTR(S_WRITTEN)] = progress.written;
+      doc[FPSTR(S_CHUNKS)] = progress.chunks;
 
-      auto networkDoc = doc[FPSTR(S_NETWORK)].to<JsonObject>();
-      networkSettingsToJson(networkSettings, networkDoc);
+      this->webServer->sendHeader(F("Cache-Control"), F("no-cache"));
+      this->bufferedWebServer->send(200, F("application/json"), doc);
+    });
 
-      auto settingsDoc = doc[FPSTR(S_SETTINGS)].to<JsonObject>();
-      settingsToJson(settings, settingsDoc);
 
-      for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
-        auto sensorsettingsDoc = doc[FPSTR(S_SENSORS)][sensorId].to<JsonObject>();
-        sensorSettingsToJson(sensorId, Sensors::settings[sensorId], sensorsettingsDoc);
+    // backup
+    this->webServer->on(F("/api/backup/save"), HTTP_GET, [this]() {
+      if (this->isAuthRequired() && !this->isValidCredentials()) {
+        return this->webServer->send(401);
       }
 
-      doc.shrinkToFit();
-
       char filename[64];
       getFilename(filename, sizeof(filename), "backup");
 
@@ -252,86 +328,167 @@ protected:
         filename
       );
       this->webServer->sendHeader(F("Content-Disposition"), contentDispositionHeaderValue);
-      this->bufferedWebServer->send(200, F("application/json"), doc);
-    });
 
-    this->webServer->on(F("/api/backup/restore"), HTTP_POST, [this]() {
-      if (this->isAuthRequired() && !this->isValidCredentials()) {
-        return this->webServer->send(401);
+      if (!this->bufferedWebServer->begin(200, F("application/json"))) {
+        return;
       }
 
-      if (vars.states.restarting) {
-        return this->webServer->send(503);
+      // written section by section, only one of them is in memory at a time
+      {
+        JsonDocument doc;
+        networkSettingsToJson(networkSettings, doc.to<JsonObject>());
+        this->writeBackupSection(FPSTR(S_NETWORK), doc, true);
       }
 
-      const String& plain = this->webServer->arg(0);
-      Log.straceln(FPSTR(L_PORTAL_WEBSERVER), F("Request /api/backup/restore %d bytes: %s"), plain.length(), plain.c_str());
+      {
+        JsonDocument doc;
+        settingsToJson(settings, doc.to<JsonObject>());
+        this->writeBackupSection(FPSTR(S_SETTINGS), doc);
+      }
 
-      if (plain.length() < 5) {
-        this->webServer->send(406);
-        return;
+      {
+        JsonDocument doc;
+        scheduleSettingsToJson(scheduleSettings, doc.to<JsonObject>());
+        this->writeBackupSection(FPSTR(S_SCHEDULE), doc);
+      }
 
-      } else if (plain.length() > 2536) {
-        this->webServer->send(413);
-        return;
+      this->bufferedWebServer->print(F(",\""));
+      this->bufferedWebServer->print(FPSTR(S_SENSORS));
+      this->bufferedWebServer->print(F("\":["));
+
+      for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+        if (sensorId) {
+          this->bufferedWebServer->print(',');
+        }
+
+        JsonDocument doc;
+        sensorSettingsToJson(sensorId, Sensors::settings[sensorId], doc.to<JsonObject>());
+        serializeJson(doc, *this->bufferedWebServer);
       }
 
-      JsonDocument doc;
-      DeserializationError dErr = deserializeJson(doc, plain);
+      this->bufferedWebServer->print(F("]}"));
+      this->bufferedWebServer->end();
+    });
 
-      if (dErr != DeserializationError::Ok || doc.isNull() || !doc.size()) {
-        this->webServer->send(400);
-        return;
+    // the settings section is the largest one, its bound follows the schema
+    const size_t restoreMaxSectionSize = max((size_t) PORTAL_RESTORE_MAX_SECTION_SIZE, getSettingsJsonMaxSize());
+    auto restoreHandler = (new RestoreHandler("/api/backup/restore", restoreMaxSectionSize))->setBeforeRestoreCallback([this]() {
+      if (vars.states.restarting || (this->isAuthRequired() && !this->isValidCredentials())) {
+        return false;
       }
 
-      bool changed = false;
-      if (!doc[FPSTR(S_NETWORK)].isNull() && jsonToNetworkSettings(doc[FPSTR(S_NETWORK)], networkSettings)) {
-        fsNetworkSettings.update();
-        network->setHostname(networkSettings.hostname)
-          ->setStaCredentials(networkSettings.sta.ssid, networkSettings.sta.password, networkSettings.sta.channel)
-          ->setApCredentials(networkSettings.ap.ssid, networkSettings.ap.password, networkSettings.ap.channel)
-          ->setUseDhcp(networkSettings.useDhcp)
-          ->setStaticConfig(
-            networkSettings.staticConfig.ip,
-            networkSettings.staticConfig.gateway,
-            networkSettings.staticConfig.subnet,
-            networkSettings.staticConfig.dns
-          );
-        changed = true;
+      // left over when the previous upload was dropped before the request was handled
+      delete this->restoreStaging;
+      this->restoreStaging = new (std::nothrow) RestoreStaging();
+
+      if (this->restoreStaging != nullptr) {
+        this->restoreStaging->network = networkSettings;
+        this->restoreStaging->settings = settings;
+        this->restoreStaging->schedule = scheduleSettings;
+
+        for (uint8_t sensorId = 0; sensorId < SENSORS_AMOUNT; sensorId++) {
+          this->restoreStaging->sensors[sensorId] = Sensors::settings[sensorId];
+        }
+
+      } else {
+        Log.swarningln(FPSTR(L_PORTAL_WEBSERVER), F("Not enough memory to restore backup"));
       }
 
-      if (!doc[FPSTR(S_SETTINGS)].isNull() && jsonToSettings(doc[FPSTR(S_SETTINGS)], settings)) {
-        fsSettings.update();
-        changed = true;
+      return true;
+    })->setSplitCallback([](const String& section) {
+      return section.equals(FPSTR(S_SENSORS));
+    })->setSectionCallback([this](const String& section, const String& key, const JsonVariantConst value) {
+      Log.straceln(FPSTR(L_PORTAL_WEBSERVER), F("Restore section '%s' %s"), section.c_str(), key.c_str());
+
+      auto staging = this->restoreStaging;
+      if (staging == nullptr) {
+        return false;
       }
 
-      if (!doc[FPSTR(S_SENSORS)].isNull()) {
-        for (auto sensor : doc[FPSTR(S_SENSORS)].as<JsonObject>()) {
-          if (!isDigit(sensor.key().c_str())) {
-            continue;
-          }
+      if (section.equals(FPSTR(S_NETWORK))) {
+        if (!jsonToNetworkSettings(value, staging->network)) {
+          return false;
+        }
 
-          int sensorId = atoi(sensor.key().c_str());
-          if (sensorId < 0 || sensorId > 255 || !Sensors::isValidSensorId(sensorId)) {
-            continue;
-          }
-          
-          if (jsonToSensorSettings(sensorId, sensor.value(), Sensors::settings[sensorId])) {
-            fsSensorsSettings.update();
-            changed = true;
-          }
+        staging->networkChanged = true;
+        return true;
+
+      } else if (section.equals(FPSTR(S_SETTINGS))) {
+        SettingsChanges changes;
+        if (!jsonToSettings(value, staging->settings, false, &changes)) {
+          return false;
+        }
+
+        staging->settingsChanges |= changes.groups;
+        staging->settingsChanged = true;
+        return true;
+
+      } else if (section.equals(FPSTR(S_SCHEDULE))) {
+        // the settings section goes first in a backup, targets are in its unit system
+        if (!jsonToScheduleSettings(value, staging->schedule, staging->settings.system.unitSystem)) {
+          return false;
+        }
+
+        staging->scheduleChanged = true;
+        return true;
+
+      } else if (section.equals(FPSTR(S_SENSORS))) {
+        if (!isDigit(key.c_str())) {
+          return false;
+        }
+
+        int sensorId = atoi(key.c_str());
+        if (sensorId < 0 || sensorId > 255 || !Sensors::isValidSensorId(sensorId)) {
+          return false;
         }
+
+        if (!jsonToSensorSettings(sensorId, value, staging->sensors[sensorId])) {
+          return false;
+        }
+
+        staging->sensorsChanged = true;
+        return true;
       }
-      
-      doc.clear();
-      doc.shrinkToFit();
 
-      if (changed) {
+      return false;
+    })->setAfterRestoreCallback([this](const RestoreHandler::RestoreResult& result) {
+      Log.straceln(
+        FPSTR(L_PORTAL_WEBSERVER),
+        F("Request /api/backup/restore %d bytes, status: %d"),
+        result.size, (short int) result.status
+      );
+
+      const bool staged = this->restoreStaging != nullptr;
+      if (result.status == RestoreHandler::RestoreStatus::SUCCESS && result.changed && staged) {
+        this->commitRestore();
         vars.actions.restart = true;
       }
 
-      this->webServer->send(changed ? 201 : 200);
+      delete this->restoreStaging;
+      this->restoreStaging = nullptr;
+
+      switch (result.status) {
+        case RestoreHandler::RestoreStatus::SUCCESS:
+          if (!staged) {
+            return this->webServer->send(500);
+          }
+
+          return this->webServer->send(result.changed ? 201 : 200);
+
+        case RestoreHandler::RestoreStatus::PROHIBITED:
+          return this->webServer->send(vars.states.restarting ? 503 : 401);
+
+        case RestoreHandler::RestoreStatus::NO_DATA:
+          return this->webServer->send(406);
+
+        case RestoreHandler::RestoreStatus::TOO_LARGE:
+          return this->webServer->send(413);
+
+        default:
+          return this->webServer->send(400);
+      }
     });
+    this->webServer->addHandler(restoreHandler);
 
     // network
     this->webServer->on(F("/api/network/settings"), HTTP_GET, [this]() {
@@ -451,11 +608,16 @@ protected:
         return this->webServer->send(401);
       }
 
+      this->settingsVersion.update(settings);
+      if (this->sendNotModified(this->settingsVersion)) {
+        return;
+      }
+
       JsonDocument doc;
       settingsToJson(settings, doc);
       doc.shrinkToFit();
       
-      this->bufferedWebServer->send(200, F("application/json"), doc);
+      this->bufferedWebServer->send(200, F("application/json"), doc, false, true);
     });
 
     this->webServer->on(F("/api/settings"), HTTP_POST, [this]() {
@@ -487,21 +649,80 @@ protected:
         return;
       }
 
-      bool changed = jsonToSettings(doc, settings);
+      SettingsChanges changes;
+      bool changed = jsonToSettings(doc, settings, false, &changes);
       doc.clear();
       doc.shrinkToFit();
 
-      settingsToJson(settings, doc);
+      // ?changed returns only the changed fields
+      settingsToJson(settings, doc, false, this->webServer->hasArg(F("changed")) ? &changes : nullptr);
       doc.shrinkToFit();
 
-      this->bufferedWebServer->send(changed ? 201 : 200, F("application/json"), doc);
+      this->bufferedWebServer->send(changed ? 201 : 200, F("application/json"), doc, false, true);
 
       if (changed) {
         doc.clear();
         doc.shrinkToFit();
 
         fsSettings.update();
-        tMqtt->resetPublishedSettingsTime();
+        publishSettingsChanges(changes.groups);
+      }
+    });
+
+
+    // schedule
+    this->webServer->on(F("/api/schedule"), HTTP_GET, [this]() {
+      if (this->isAuthRequired() && !this->isValidCredentials()) {
+        return this->webServer->send(401);
+      }
+
+      JsonDocument doc;
+      scheduleSettingsToJson(scheduleSettings, doc);
+      doc.shrinkToFit();
+
+      this->bufferedWebServer->send(200, F("application/json"), doc);
+    });
+
+    this->webServer->on(F("/api/schedule"), HTTP_POST, [this]() {
+      if (this->isAuthRequired() && !this->isValidCredentials()) {
+        return this->webServer->send(401);
+      }
+
+      if (vars.states.restarting) {
+        return this->webServer->send(503);
+      }
+
+      const String& plain = this->webServer->arg(0);
+      Log.straceln(FPSTR(L_PORTAL_WEBSERVER), F("Request /api/schedule %d bytes: %s"), plain.length(), plain.c_str());
+
+      if (plain.length() < 5) {
+        this->webServer->send(406);
+        return;
+
+      } else if (plain.length() > 2048) {
+        this->webServer->send(413);
+        return;
+      }
+
+      JsonDocument doc;
+      DeserializationError dErr = deserializeJson(doc, plain);
+
+      if (dErr != DeserializationError::Ok || doc.isNull() || !doc.size()) {
+        this->webServer->send(400);
+        return;
+      }
+
+      bool changed = jsonToScheduleSettings(doc, scheduleSettings);
+      doc.clear();
+      doc.shrinkToFit();
+
+      scheduleSettingsToJson(scheduleSettings, doc);
+      doc.shrinkToFit();
+
+      this->bufferedWebServer->send(changed ? 201 : 200, F("application/json"), doc);
+
+      if (changed) {
+        fsScheduleSettings.update();
       }
     });
 
@@ -512,11 +733,21 @@ protected:
         return this->webServer->send(401);
       }
 
+      this->updateSensorsVersion();
+      if (this->sendNotModified(this->sensorsVersion)) {
+        return;
+      }
+
+      if (this->webServer->hasArg(F("fields")) || this->webServer->hasArg(F("ids"))
+        || this->webServer->hasArg(F("only_enabled")) || this->webServer->hasArg(F("since"))) {
+        return this->sendSensorsQuery();
+      }
+
       bool detailed = false;
       if (this->webServer->hasArg(F("detailed"))) {
         detailed = this->webServer->arg(F("detailed")).toInt() > 0;
       }
-      
+
       JsonDocument doc;
       for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
         if (detailed) {
@@ -532,7 +763,7 @@ protected:
       }
       
       doc.shrinkToFit();
-      this->bufferedWebServer->send(200, F("application/json"), doc);
+      this->bufferedWebServer->send(200, F("application/json"), doc, false, detailed);
     });
 
     // sensor settings
@@ -636,11 +867,21 @@ protected:
 
     // vars
     this->webServer->on(F("/api/vars"), HTTP_GET, [this]() {
+      // master.uptime is part of the response, so the version changes at most once per second
+      this->varsVersion.begin()
+        ->add(vars)
+        ->add(millis() / 1000)
+        ->commit();
+
+      if (this->sendNotModified(this->varsVersion)) {
+        return;
+      }
+
       JsonDocument doc;
       varsToJson(vars, doc);
       doc.shrinkToFit();
 
-      this->bufferedWebServer->send(200, F("application/json"), doc);
+      this->bufferedWebServer->send(200, F("application/json"), doc, false, true);
     });
 
     this->webServer->on(F("/api/vars"), HTTP_POST, [this]() {
@@ -685,9 +926,48 @@ protected:
       }
     });
 
+    // live updates (server-sent events)
+    this->webServer->on(F("/api/events"), HTTP_GET, [this]() {
+      if (this->isAuthRequired() && !this->isValidCredentials()) {
+        return this->webServer->send(401);
+      }
+
+      if (!this->eventStream->accept()) {
+        return this->webServer->send(503);
+      }
+
+      Log.straceln(FPSTR(L_PORTAL_WEBSERVER), F("Events client connected"));
+    });
+
     this->webServer->on(F("/api/info"), HTTP_GET, [this]() {
       bool isConnected = network->isConnected();
 
+      // uptime and heap are part of the response, so the version changes at most once per second
+      this->infoVersion.begin()
+        ->add(millis() / 1000)
+        ->add(getFreeHeap())
+        ->add(getFreeHeap(true))
+        ->add(getMaxFreeBlockHeap())
+        ->add(getMaxFreeBlockHeap(true))
+        ->add(networkSettings.hostname, strlen(networkSettings.hostname))
+        ->add(isConnected);
+
+      if (isConnected) {
+        const char* ssid = network->getStaSsid();
+        this->infoVersion.add(ssid, strlen(ssid))
+          ->add(network->getRssi())
+          ->add(network->getStaChannel())
+          ->add(static_cast<uint32_t>(network->getStaIp()))
+          ->add(static_cast<uint32_t>(network->getStaSubnet()))
+          ->add(static_cast<uint32_t>(network->getStaGateway()))
+          ->add(static_cast<uint32_t>(network->getStaDns()));
+      }
+      this->infoVersion.commit();
+
+      if (this->sendNotModified(this->infoVersion)) {
+        return;
+      }
+
       JsonDocument doc;
 
       auto docSystem = doc[FPSTR(S_SYSTEM)].to<JsonObject>();
@@ -763,6 +1043,22 @@ protected:
       this->bufferedWebServer->send(200, F("application/json"), doc);
     });
 
+    // prometheus
+    this->webServer->on(F("/metrics"), HTTP_GET, [this]() {
+      if (this->isAuthRequired() && !this->isValidCredentials()) {
+        return this->webServer->send(401);
+      }
+
+      this->webServer->sendHeader(F("Cache-Control"), F("no-cache"));
+      if (!this->bufferedWebServer->begin(200, F("text/plain; version=0.0.4"))) {
+        return;
+      }
+
+      MetricsWriter writer(this->bufferedWebServer, "otgateway_");
+      this->writeMetrics(writer);
+      this->bufferedWebServer->end();
+    });
+
     this->webServer->on(F("/api/debug"), HTTP_GET, [this]() {
       JsonDocument doc;
 
@@ -883,10 +1179,25 @@ protected:
 
     this->webServer->serveStatic("/robots.txt", LittleFS, "/static/robots.txt", PORTAL_CACHE);
     this->webServer->serveStatic("/favicon.ico", LittleFS, "/static/images/favicon.ico", PORTAL_CACHE);
+    this->webServer->addHandler(new StaticAssets("/static", &LittleFS, this->assetsManifest));
     this->webServer->serveStatic("/static", LittleFS, "/static", PORTAL_CACHE);
   }
 
   void loop() {
+    LoopStats::Guard loopGuard(this->loopStats);
+
+    // OTA: the session of an aborted upload is not kept forever
+    if (this->upgradeHandler != nullptr && this->upgradeHandler->expireAborted(PORTAL_UPGRADE_RESUME_TIMEOUT)) {
+      vars.states.upgrading = false;
+
+      #ifdef ARDUINO_ARCH_ESP8266
+      // the filesystem was closed for the upgrade
+      if (this->upgradeHandler->getProgress().type == UpgradeHandler::UpgradeType::FILESYSTEM) {
+        LittleFS.begin();
+      }
+      #endif
+    }
+
     // web server
     if (!this->stateWebServer() && (network->isApEnabled() || network->isConnected()) && millis() - this->webServerChangeState >= this->changeStateInterval) {
       #ifdef ARDUINO_ARCH_ESP32
@@ -962,15 +1273,20 @@ protected:
     }
 
     if (this->stateWebServer()) {
-      #ifdef ARDUINO_ARCH_ESP32
-      // Fix ERR_CONNECTION_RESET for Chrome based browsers
-      auto& client = this->webServer->client();
-      if (!client.getNoDelay()) {
-        client.setNoDelay(true);
+      // every call serves at most one request, drain the queued clients in one pass
+      for (uint8_t i = 0; i < PORTAL_MAX_REQUESTS_PER_LOOP; i++) {
+        #ifdef ARDUINO_ARCH_ESP32
+        // Fix ERR_CONNECTION_RESET for Chrome based browsers
+        auto& client = this->webServer->client();
+        if (!client.getNoDelay()) {
+          client.setNoDelay(true);
+        }
+        #endif
+
+        this->webServer->handleClient();
       }
-      #endif
 
-      this->webServer->handleClient();
+      this->handleEvents();
     }
 
     if (!this->stateDnsServer() && !this->stateWebServer()) {
@@ -978,6 +1294,471 @@ protected:
     }
   }
 
+  void handleEvents() {
+    if (!this->eventStream->count()) {
+      if (this->eventsVarsDoc.size()) {
+        this->eventsVarsDoc.clear();
+        this->eventsVarsDoc.shrinkToFit();
+      }
+
+      return;
+    }
+
+    if (millis() - this->eventsTime < PORTAL_EVENTS_INTERVAL) {
+      this->eventStream->ping(PORTAL_EVENTS_PING_INTERVAL);
+      return;
+    }
+
+    this->eventsTime = millis();
+    const bool hasNew = this->eventStream->hasNew();
+
+    // vars: full state for new clients, changed fields only for others
+    {
+      JsonDocument doc;
+      varsToJson(vars, doc);
+
+      if (hasNew) {
+        this->eventStream->send(F("vars"), doc, EventStream::Target::NEW);
+      }
+
+      if (this->eventsVarsDoc.size()) {
+        JsonDocument delta;
+        if (diffJson(this->eventsVarsDoc, doc, delta.to<JsonObject>())) {
+          this->eventStream->send(F("vars"), delta, EventStream::Target::ESTABLISHED);
+        }
+      }
+
+      this->eventsVarsDoc = std::move(doc);
+    }
+
+    // sensors: results updated since the previous event
+    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+      if (!Sensors::hasEnabledAndValid(sensorId)) {
+        continue;
+      }
+
+      auto& rSensor = Sensors::results[sensorId];
+      const bool changed = rSensor.activityTime != this->eventsSensorTime[sensorId];
+      if (!changed && !hasNew) {
+        continue;
+      }
+
+      JsonDocument doc;
+      doc[FPSTR(S_ID)] = sensorId;
+      sensorResultToJson(sensorId, doc);
+
+      this->eventStream->send(F("sensor"), doc, changed ? EventStream::Target::ALL : EventStream::Target::NEW);
+      this->eventsSensorTime[sensorId] = rSensor.activityTime;
+    }
+
+    this->eventStream->establish();
+  }
+
+  void writeBackupSection(const __FlashStringHelper* name, const JsonVariantConst content, bool first = false) {
+    this->bufferedWebServer->print(first ? F("{\"") : F(",\""));
+    this->bufferedWebServer->print(name);
+    this->bufferedWebServer->print(F("\":"));
+    serializeJson(content, *this->bufferedWebServer);
+  }
+
+  void writeMetrics(MetricsWriter& dst) {
+    // system
+    dst.family(F("uptime_seconds"), F("Uptime"))->sample(millis() / 1000);
+    dst.family(F("heap_free_bytes"), F("Free heap"))->sample(getFreeHeap());
+    dst.family(F("heap_min_free_bytes"), F("Minimum free heap since boot"))->sample(getFreeHeap(true));
+    dst.family(F("heap_max_free_block_bytes"), F("Largest free heap block"))->sample(getMaxFreeBlockHeap());
+    dst.family(F("heap_fragmentation_percent"), F("Heap fragmentation"))->sample(getHeapFrag());
+
+    dst.family(F("task_loops_total"), F("Task loop iterations"), MetricsWriter::Type::COUNTER);
+    for (const LoopStats* item = LoopStats::first(); item != nullptr; item = item->getNext()) {
+      dst.begin()->label(F("task"), item->getName())->value(item->count);
+    }
+
+    dst.family(F("task_loop_last_microseconds"), F("Duration of the last task loop"));
+    for (const LoopStats* item = LoopStats::first(); item != nullptr; item = item->getNext()) {
+      dst.begin()->label(F("task"), item->getName())->value(item->lastTime);
+    }
+
+    dst.family(F("task_loop_max_microseconds"), F("Longest task loop since boot"));
+    for (const LoopStats* item = LoopStats::first(); item != nullptr; item = item->getNext()) {
+      dst.begin()->label(F("task"), item->getName())->value(item->maxTime);
+    }
+
+    // network & mqtt
+    dst.family(F("network_connected"), F("Network connection state"))->sample(vars.network.connected);
+    dst.family(F("network_rssi_dbm"), F("WiFi signal strength"))->sample(vars.network.rssi);
+    dst.family(F("mqtt_connected"), F("MQTT connection state"))->sample(vars.mqtt.connected);
+    dst.family(F("mqtt_published_messages_total"), F("MQTT messages published"), MetricsWriter::Type::COUNTER)
+      ->sample(tMqtt->getPublishedMessages());
+    dst.family(F("mqtt_published_bytes_total"), F("MQTT bytes published"), MetricsWriter::Type::COUNTER)
+      ->sample(tMqtt->getPublishedBytes());
+    dst.family(F("mqtt_publish_failures_total"), F("MQTT messages failed to publish"), MetricsWriter::Type::COUNTER)
+      ->sample(tMqtt->getPublishFailures());
+    dst.family(F("mqtt_flushes_total"), F("MQTT writer flushes"), MetricsWriter::Type::COUNTER)
+      ->sample(tMqtt->getFlushes());
+
+    // opentherm bus
+    auto busStats = tOt->getBusStats();
+    if (busStats != nullptr) {
+      dst.family(F("opentherm_requests_total"), F("OpenTherm requests, including retries"), MetricsWriter::Type::COUNTER)
+        ->sample(busStats->requests);
+      dst.family(F("opentherm_retries_total"), F("OpenTherm request retries"), MetricsWriter::Type::COUNTER)
+        ->sample(busStats->retries);
+      dst.family(F("opentherm_responses_total"), F("OpenTherm responses by status"), MetricsWriter::Type::COUNTER);
+      dst.begin()->label(F("status"), F("success"))->value(busStats->success);
+      dst.begin()->label(F("status"), F("invalid"))->value(busStats->invalid);
+      dst.begin()->label(F("status"), F("timeout"))->value(busStats->timeouts);
+    }
+
+    // slave, temperatures in the configured unit system
+    auto& slave = vars.slave;
+    dst.family(F("slave_connected"), F("OpenTherm slave connection state"))->sample(slave.connected);
+    dst.family(F("slave_flame"), F("Flame state"))->sample(slave.flame);
+    dst.family(F("slave_pressure"), F("Heating circuit pressure"))->sample(slave.pressure);
+    dst.family(F("slave_heat_exchanger_temp"), F("Heat exchanger temperature"))->sample(slave.heatExchangerTemp);
+
+    dst.family(F("slave_fault_active"), F("Fault state"))->sample(slave.fault.active);
+    dst.family(F("slave_fault_code"), F("Fault code"))->sample(slave.fault.code);
+    dst.family(F("slave_diag_active"), F("Diagnostic state"))->sample(slave.diag.active);
+    dst.family(F("slave_diag_code"), F("Diagnostic code"))->sample(slave.diag.code);
+
+    dst.family(F("slave_modulation_percent"), F("Burner modulation level"));
+    dst.begin()->label(F("type"), F("current"))->value(slave.modulation.current);
+    dst.begin()->label(F("type"), F("min"))->value(slave.modulation.min);
+    dst.begin()->label(F("type"), F("max"))->value(slave.modulation.max);
+
+    dst.family(F("slave_power_kw"), F("Burner power"));
+    dst.begin()->label(F("type"), F("current"))->value(slave.power.current);
+    dst.begin()->label(F("type"), F("min"))->value(slave.power.min);
+    dst.begin()->label(F("type"), F("max"))->value(slave.power.max);
+
+    dst.family(F("slave_exhaust_temp"), F("Exhaust temperature"))->sample(slave.exhaust.temp);
+    dst.family(F("slave_exhaust_co2_ppm"), F("Exhaust CO2"))->sample(slave.exhaust.co2);
+    dst.family(F("slave_exhaust_fan_speed_rpm"), F("Exhaust fan speed"))->sample(slave.exhaust.fanSpeed);
+
+    dst.family(F("slave_fan_speed"), F("Fan speed"));
+    dst.begin()->label(F("type"), F("setpoint"))->value(slave.fanSpeed.setpoint);
+    dst.begin()->label(F("type"), F("current"))->value(slave.fanSpeed.current);
+    dst.begin()->label(F("type"), F("supply"))->value(slave.fanSpeed.supply);
+
+    dst.family(F("slave_solar_temp"), F("Solar temperatures"));
+    dst.begin()->label(F("type"), F("storage"))->value(slave.solar.storage);
+    dst.begin()->label(F("type"), F("collector"))->value(slave.solar.collector);
+
+    dst.family(F("slave_starts"), F("Starts reported by the slave"));
+    dst.begin()->label(F("type"), F("burner"))->value(slave.stats.burnerStarts);
+    dst.begin()->label(F("type"), F("dhw_burner"))->value(slave.stats.dhwBurnerStarts);
+    dst.begin()->label(F("type"), F("heating_pump"))->value(slave.stats.heatingPumpStarts);
+    dst.begin()->label(F("type"), F("dhw_pump"))->value(slave.stats.dhwPumpStarts);
+
+    dst.family(F("slave_hours"), F("Operating hours reported by the slave"));
+    dst.begin()->label(F("type"), F("burner"))->value(slave.stats.burnerHours);
+    dst.begin()->label(F("type"), F("dhw_burner"))->value(slave.stats.dhwBurnerHours);
+    dst.begin()->label(F("type"), F("heating_pump"))->value(slave.stats.heatingPumpHours);
+    dst.begin()->label(F("type"), F("dhw_pump"))->value(slave.stats.dhwPumpHours);
+    dst.begin()->label(F("type"), F("cooling"))->value(slave.stats.coolingHours);
+
+    dst.family(F("slave_cooling_active"), F("Cooling state"))->sample(slave.cooling.active);
+    dst.family(F("slave_cooling_setpoint"), F("Cooling setpoint"))->sample(slave.cooling.setpoint);
+
+    dst.family(F("slave_circuit_active"), F("Circuit active state"));
+    dst.begin()->label(F("circuit"), F("heating"))->value(slave.heating.active);
+    dst.begin()->label(F("circuit"), F("dhw"))->value(slave.dhw.active);
+    dst.begin()->label(F("circuit"), F("ch2"))->value(slave.ch2.active);
+
+    dst.family(F("slave_circuit_enabled"), F("Circuit enabled state"));
+    dst.begin()->label(F("circuit"), F("heating"))->value(slave.heating.enabled);
+    dst.begin()->label(F("circuit"), F("dhw"))->value(slave.dhw.enabled);
+    dst.begin()->label(F("circuit"), F("ch2"))->value(slave.ch2.enabled);
+
+    dst.family(F("slave_temp"), F("Circuit temperatures"));
+    dst.begin()->label(F("circuit"), F("heating"))->label(F("type"), F("target"))->value(slave.heating.targetTemp);
+    dst.begin()->label(F("circuit"), F("heating"))->label(F("type"), F("current"))->value(slave.heating.currentTemp);
+    dst.begin()->label(F("circuit"), F("heating"))->label(F("type"), F("return"))->value(slave.heating.returnTemp);
+    dst.begin()->label(F("circuit"), F("heating"))->label(F("type"), F("indoor"))->value(slave.heating.indoorTemp);
+    dst.begin()->label(F("circuit"), F("heating"))->label(F("type"), F("outdoor"))->value(slave.heating.outdoorTemp);
+    dst.begin()->label(F("circuit"), F("heating"))->label(F("type"), F("min"))->value(slave.heating.minTemp);
+    dst.begin()->label(F("circuit"), F("heating"))->label(F("type"), F("max"))->value(slave.heating.maxTemp);
+    dst.begin()->label(F("circuit"), F("dhw"))->label(F("type"), F("target"))->value(slave.dhw.targetTemp);
+    dst.begin()->label(F("circuit"), F("dhw"))->label(F("type"), F("current"))->value(slave.dhw.currentTemp);
+    dst.begin()->label(F("circuit"), F("dhw"))->label(F("type"), F("current2"))->value(slave.dhw.currentTemp2);
+    dst.begin()->label(F("circuit"), F("dhw"))->label(F("type"), F("return"))->value(slave.dhw.returnTemp);
+    dst.begin()->label(F("circuit"), F("dhw"))->label(F("type"), F("min"))->value(slave.dhw.minTemp);
+    dst.begin()->label(F("circuit"), F("dhw"))->label(F("type"), F("max"))->value(slave.dhw.maxTemp);
+    dst.begin()->label(F("circuit"), F("ch2"))->label(F("type"), F("target"))->value(slave.ch2.targetTemp);
+    dst.begin()->label(F("circuit"), F("ch2"))->label(F("type"), F("current"))->value(slave.ch2.currentTemp);
+    dst.begin()->label(F("circuit"), F("ch2"))->label(F("type"), F("indoor"))->value(slave.ch2.indoorTemp);
+
+    dst.family(F("slave_dhw_flow_rate"), F("DHW flow rate"))->sample(slave.dhw.flowRate);
+
+    // burner cycling
+    dst.family(F("burner_cycles_per_hour"), F("Burner ignitions in the last hour"))->sample(vars.antiCycling.cycles);
+    dst.family(F("burner_last_on_seconds"), F("Duration of the last burn"))->sample(vars.antiCycling.lastOnTime);
+    dst.family(F("burner_min_on_seconds"), F("Shortest burn in the last hour"))->sample(vars.antiCycling.minOnTime);
+    dst.family(F("burner_anti_cycling_lockout"), F("Short cycling lockout state"))->sample(vars.antiCycling.lockout);
+
+    // sensors
+    dst.family(F("sensor_connected"), F("Sensor connection state"));
+    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+      auto& sSensor = Sensors::settings[sensorId];
+      if (!sSensor.enabled) {
+        continue;
+      }
+
+      dst.begin()->label(F("id"), sensorId)->label(F("name"), sSensor.name)->value(Sensors::results[sensorId].connected);
+    }
+
+    dst.family(F("sensor_signal_quality_percent"), F("Sensor signal quality"));
+    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+      auto& sSensor = Sensors::settings[sensorId];
+      if (!sSensor.enabled) {
+        continue;
+      }
+
+      dst.begin()->label(F("id"), sensorId)->label(F("name"), sSensor.name)->value(Sensors::results[sensorId].signalQuality);
+    }
+
+    dst.family(F("sensor_value"), F("Sensor values"));
+    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+      auto& sSensor = Sensors::settings[sensorId];
+      auto& rSensor = Sensors::results[sensorId];
+      if (!sSensor.enabled) {
+        continue;
+      }
+
+      if (sSensor.type == Sensors::Type::BLUETOOTH) {
+        dst.begin()->label(F("id"), sensorId)->label(F("name"), sSensor.name)->label(F("type"), F("temperature"))
+          ->value(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::TEMPERATURE)]);
+        dst.begin()->label(F("id"), sensorId)->label(F("name"), sSensor.name)->label(F("type"), F("humidity"))
+          ->value(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::HUMIDITY)]);
+        dst.begin()->label(F("id"), sensorId)->label(F("name"), sSensor.name)->label(F("type"), F("battery"))
+          ->value(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::BATTERY)]);
+        dst.begin()->label(F("id"), sensorId)->label(F("name"), sSensor.name)->label(F("type"), F("rssi"))
+          ->value(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::RSSI)]);
+
+      } else {
+        dst.begin()->label(F("id"), sensorId)->label(F("name"), sSensor.name)->label(F("type"), F("primary"))
+          ->value(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::PRIMARY)]);
+      }
+
+      #ifdef ARDUINO_ARCH_ESP8266
+      ::optimistic_yield(1000);
+      #endif
+    }
+  }
+
+  void updateSensorsVersion() {
+    // the global version is bumped by the commit below if any sensor has changed
+    const uint32_t nextVersion = this->sensorsVersion.get() + 1;
+
+    this->sensorsVersion.begin();
+    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+      auto& sSensor = Sensors::settings[sensorId];
+      auto& rSensor = Sensors::results[sensorId];
+
+      // only the fields that are sent, activity time changes on every poll
+      this->sensorVersion.begin()
+        ->add(sSensor.enabled)
+        ->add(sSensor.name, strlen(sSensor.name))
+        ->add(sSensor.purpose)
+        ->add(sSensor.type)
+        ->add(rSensor.connected)
+        ->add(rSensor.signalQuality)
+        ->add(rSensor.values);
+
+      const uint32_t hash = this->sensorVersion.getPendingHash();
+      if (hash != this->sensorsHashes[sensorId]) {
+        this->sensorsHashes[sensorId] = hash;
+        this->sensorsChangedVersions[sensorId] = nextVersion;
+      }
+
+      this->sensorsVersion.add(hash);
+    }
+    this->sensorsVersion.commit();
+  }
+
+  /**
+   * Sensors query: /api/sensors?ids=1,2&fields=name,value&only_enabled=1&since=<version>
+   * Streams an object keyed by sensor id with only the requested fields,
+   * "since" skips the sensors that have not changed after the given version,
+   * a version of another boot epoch returns all sensors.
+   */
+  void sendSensorsQuery() {
+    static const char* const fieldNames[] = {
+      S_ENABLED, S_NAME, S_PURPOSE, S_TYPE, S_CONNECTED, S_SIGNAL_QUALITY,
+      S_VALUE, S_TEMPERATURE, S_HUMIDITY, S_BATTERY, S_RSSI
+    };
+    enum : uint16_t {
+      FIELD_ENABLED = 1 << 0,
+      FIELD_NAME = 1 << 1,
+      FIELD_PURPOSE = 1 << 2,
+      FIELD_TYPE = 1 << 3,
+      FIELD_CONNECTED = 1 << 4,
+      FIELD_SIGNAL_QUALITY = 1 << 5,
+      FIELD_VALUE = 1 << 6,
+      FIELD_TEMPERATURE = 1 << 7,
+      FIELD_HUMIDITY = 1 << 8,
+      FIELD_BATTERY = 1 << 9,
+      FIELD_RSSI = 1 << 10
+    };
+
+    uint16_t fields = 0xFFFF;
+    if (this->webServer->hasArg(F("fields"))) {
+      fields = 0;
+
+      this->forEachArgItem(this->webServer->arg(F("fields")), [&fields](const String& item) {
+        for (uint8_t i = 0; i < sizeof(fieldNames) / sizeof(*fieldNames); i++) {
+          if (item.equals(FPSTR(fieldNames[i]))) {
+            fields |= 1 << i;
+            break;
+          }
+        }
+      });
+    }
+
+    uint8_t ids[(SENSORS_AMOUNT + 7) / 8];
+    memset(ids, this->webServer->hasArg(F("ids")) ? 0x00 : 0xFF, sizeof(ids));
+    if (this->webServer->hasArg(F("ids"))) {
+      this->forEachArgItem(this->webServer->arg(F("ids")), [&ids](const String& item) {
+        if (!isDigit(item.c_str())) {
+          return;
+        }
+
+        int sensorId = item.toInt();
+        if (sensorId >= 0 && sensorId <= 255 && Sensors::isValidSensorId(sensorId)) {
+          ids[sensorId / 8] |= 1 << (sensorId % 8);
+        }
+      });
+    }
+
+    const bool onlyEnabled = this->webServer->arg(F("only_enabled")).toInt() > 0;
+    unsigned long since = this->webServer->hasArg(F("since"))
+      ? strtoul(this->webServer->arg(F("since")).c_str(), nullptr, 10)
+      : 0;
+
+    // version from a previous boot or from the future: full resync
+    if (since > this->sensorsVersion.get() || StateVersion::epochOf(since) != this->sensorsVersion.getEpoch()) {
+      since = 0;
+    }
+
+    if (!this->bufferedWebServer->begin(200, F("application/json"))) {
+      return;
+    }
+
+    this->bufferedWebServer->print(F("{\""));
+    this->bufferedWebServer->print(FPSTR(S_VERSION));
+    this->bufferedWebServer->print(F("\":"));
+    this->bufferedWebServer->print(this->sensorsVersion.get());
+    this->bufferedWebServer->print(F(",\""));
+    this->bufferedWebServer->print(FPSTR(S_SENSORS));
+    this->bufferedWebServer->print(F("\":{"));
+
+    bool first = true;
+    for (uint8_t sensorId = 0; sensorId <= Sensors::getMaxSensorId(); sensorId++) {
+      auto& sSensor = Sensors::settings[sensorId];
+      auto& rSensor = Sensors::results[sensorId];
+
+      if (!(ids[sensorId / 8] & (1 << (sensorId % 8)))) {
+        continue;
+
+      } else if (onlyEnabled && !sSensor.enabled) {
+        continue;
+
+      } else if (this->sensorsChangedVersions[sensorId] <= since) {
+        continue;
+      }
+
+      JsonDocument doc;
+      auto item = doc.to<JsonObject>();
+
+      if (fields & FIELD_ENABLED) {
+        item[FPSTR(S_ENABLED)] = sSensor.enabled;
+      }
+
+      if (fields & FIELD_NAME) {
+        item[FPSTR(S_NAME)] = sSensor.name;
+      }
+
+      if (fields & FIELD_PURPOSE) {
+        item[FPSTR(S_PURPOSE)] = static_cast<uint8_t>(sSensor.purpose);
+      }
+
+      if (fields & FIELD_TYPE) {
+        item[FPSTR(S_TYPE)] = static_cast<uint8_t>(sSensor.type);
+      }
+
+      if (fields & FIELD_CONNECTED) {
+        item[FPSTR(S_CONNECTED)] = rSensor.connected;
+      }
+
+      if (fields & FIELD_SIGNAL_QUALITY) {
+        item[FPSTR(S_SIGNAL_QUALITY)] = rSensor.signalQuality;
+      }
+
+      // same set of values as sensorResultToJson()
+      if (sSensor.type == Sensors::Type::BLUETOOTH) {
+        if (fields & FIELD_TEMPERATURE) {
+          item[FPSTR(S_TEMPERATURE)] = roundf(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::TEMPERATURE)], 3);
+        }
+
+        if (fields & FIELD_HUMIDITY) {
+          item[FPSTR(S_HUMIDITY)] = roundf(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::HUMIDITY)], 3);
+        }
+
+        if (fields & FIELD_BATTERY) {
+          item[FPSTR(S_BATTERY)] = roundf(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::BATTERY)], 1);
+        }
+
+        if (fields & FIELD_RSSI) {
+          item[FPSTR(S_RSSI)] = roundf(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::RSSI)], 0);
+        }
+
+      } else if (fields & FIELD_VALUE) {
+        item[FPSTR(S_VALUE)] = roundf(rSensor.values[static_cast<uint8_t>(Sensors::ValueType::PRIMARY)], 3);
+      }
+
+      this->bufferedWebServer->print(first ? F("\"") : F(",\""));
+      this->bufferedWebServer->print(sensorId);
+      this->bufferedWebServer->print(F("\":"));
+      serializeJson(doc, *this->bufferedWebServer);
+      first = false;
+    }
+
+    this->bufferedWebServer->print(F("}}"));
+    this->bufferedWebServer->end();
+  }
+
+  template <class T>
+  static void forEachArgItem(const String& value, T callback) {
+    int start = 0;
+
+    while (start <= (int) value.length()) {
+      int end = value.indexOf(',', start);
+      if (end == -1) {
+        end = value.length();
+      }
+
+      if (end > start) {
+        callback(value.substring(start, end));
+      }
+
+      start = end + 1;
+    }
+  }
+
+  bool sendNotModified(StateVersion& version) {
+    const String eTag = version.getETag();
+    this->webServer->sendHeader(F("Cache-Control"), F("no-cache"));
+    this->webServer->sendHeader(F("ETag"), eTag);
+
+    if (this->webServer->header(F("If-None-Match")).equals(eTag)) {
+      this->webServer->send(304);
+      return true;
+    }
+
+    return false;
+  }
+
   bool isAuthRequired() {
     return !network->isApEnabled() && settings.portal.auth && strlen(settings.portal.password);
   }
@@ -1040,6 +1821,7 @@ protected:
     }
 
     //this->webServer->handleClient();
+    this->eventStream->stop();
     this->webServer->stop();
     this->webServerEnabled = false;
     this->webServerChangeState = millis();
@@ -1068,6 +1850,46 @@ protected:
     this->dnsServerEnabled = false;
   }
 
+  void commitRestore() {
+    auto staging = this->restoreStaging;
+
+    if (staging->networkChanged) {
+      networkSettings = staging->network;
+      fsNetworkSettings.update();
+      network->setHostname(networkSettings.hostname)
+        ->setStaCredentials(networkSettings.sta.ssid, networkSettings.sta.password, networkSettings.sta.channel)
+        ->setApCredentials(networkSettings.ap.ssid, networkSettings.ap.password, networkSettings.ap.channel)
+        ->setUseDhcp(networkSettings.useDhcp)
+        ->setStaticConfig(
+          networkSettings.staticConfig.ip,
+          networkSettings.staticConfig.gateway,
+          networkSettings.staticConfig.subnet,
+          networkSettings.staticConfig.dns
+        );
+    }
+
+    if (staging->settingsChanged) {
+      settings = staging->settings;
+      fsSettings.update();
+      publishSettingsChanges(staging->settingsChanges);
+    }
+
+    if (staging->scheduleChanged) {
+      scheduleSettings = staging->schedule;
+      fsScheduleSettings.update();
+    }
+
+    if (staging->sensorsChanged) {
+      for (uint8_t sensorId = 0; sensorId < SENSORS_AMOUNT; sensorId++) {
+        Sensors::settings[sensorId] = staging->sensors[sensorId];
+      }
+
+      fsSensorsSettings.update();
+    }
+
+    Log.sinfoln(FPSTR(L_PORTAL_WEBSERVER), F("Backup restored"));
+  }
+
   static void getFilename(char* filename, size_t maxSizeFilename, const char* type) {
     const time_t now = time(nullptr);
     const tm* localNow = localtime(&now);
@@ -1,4 +1,13 @@
 #include <GyverPID.h>
+#include <PidAutotune.h>
+#include <EquithermLearner.h>
+#include <CycleMonitor.h>
+#include <OptimumStart.h>
+#if REGULATOR_FIXED_POINT
+#include <FixedMath.h>
+#endif
+
+extern JournalData fsSettings, fsScheduleSettings;
 
 GyverPID pidRegulator(0, 0, 0);
 
@@ -8,9 +17,40 @@ public:
   RegulatorTask(bool _enabled = false, unsigned long _interval = 0) : LeanTask(_enabled, _interval) {}
 
 protected:
+  LoopStats loopStats{"regulator"};
+  PidAutotune pidAutotune;
+  PidAutotune::State prevPidAutotuneState = PidAutotune::State::IDLE;
+  EquithermLearner equithermLearner;
+  bool equithermLearnerReady = false;
+  CycleMonitor cycleMonitor;
+  bool hysteresisBlocking = false;
+  OptimumStart optimumStart;
+  bool optimumStartReady = false;
+  float scheduleTarget = NAN;
+  // the first evaluation after boot takes the current block as already applied
+  bool scheduleBooting = true;
+  time_t preheatEndTime = 0;
+
   float prevHeatingTarget = 0.0f;
   float prevEtResult = 0.0f;
   float prevPidResult = 0.0f;
+  bool pidStarted = false;
+  unsigned long lastPidTime = 0;
+
+  // inputs of the last run
+  unsigned long lastRunTime = 0;
+  bool hasRun = false;
+  float lastIndoorTemp = 0.0f;
+  float lastOutdoorTemp = 0.0f;
+  float lastTarget = 0.0f;
+  bool lastEmergency = false;
+  bool lastFlame = false;
+  bool lastFreezing = false;
+  bool lastIndoorSensorsConnected = false;
+
+  // raw burner flame, the current burn was ignited for DHW
+  bool burnerFlame = false;
+  bool dhwBurn = false;
 
   bool indoorSensorsConnected = false;
   //bool outdoorSensorsConnected = false;
@@ -37,6 +77,23 @@ protected:
     this->indoorSensorsConnected = Sensors::existsConnectedSensorsByPurpose(Sensors::Purpose::INDOOR_TEMP);
     //this->outdoorSensorsConnected = Sensors::existsConnectedSensorsByPurpose(Sensors::Purpose::OUTDOOR_TEMP);
 
+    // the task is polled at the min interval
+    const bool changed = takeSettingsChanges(SettingsSubscriber::REGULATOR) != 0 || this->hasInputChanges();
+    if (!changed && this->hasRun && millis() - this->lastRunTime < REGULATOR_MAX_INTERVAL) {
+      return;
+    }
+
+    LoopStats::Guard loopGuard(this->loopStats);
+    this->lastRunTime = millis();
+    this->hasRun = true;
+    this->lastIndoorTemp = vars.master.heating.indoorTemp;
+    this->lastOutdoorTemp = vars.master.heating.outdoorTemp;
+    this->lastTarget = settings.heating.target;
+    this->lastEmergency = vars.emergency.state;
+    this->lastFlame = vars.slave.flame;
+    this->lastFreezing = vars.master.heating.freezing;
+    this->lastIndoorSensorsConnected = this->indoorSensorsConnected;
+
     if (settings.equitherm.enabled || settings.pid.enabled || settings.opentherm.options.nativeOTC) {
       vars.master.heating.indoorTempControl = true;
       vars.master.heating.minTemp = THERMOSTAT_INDOOR_MIN_TEMP;
@@ -48,14 +105,22 @@ protected:
       vars.master.heating.maxTemp = settings.heating.maxTemp;
     }
 
+    if (!settings.pid.enabled) {
+      this->pidStarted = false;
+    }
+
     if (!settings.pid.enabled && fabsf(pidRegulator.integral) > 0.01f) {
       pidRegulator.integral = 0.0f;
 
       Log.sinfoln(FPSTR(L_REGULATOR_PID), F("Integral sum has been reset"));
     }
 
+    this->schedule();
     this->turbo();
+    this->autotune();
     this->hysteresis();
+    this->antiCycling();
+    vars.master.heating.blocking = this->hysteresisBlocking || vars.antiCycling.lockout;
 
     vars.master.heating.targetTemp = settings.heating.target;
     vars.master.heating.setpointTemp = roundf(constrain(
@@ -68,6 +133,211 @@ protected:
       Sensors::Type::HEATING_SETPOINT_TEMP, vars.master.heating.setpointTemp,
       Sensors::ValueType::PRIMARY, true, true
     );
+
+    this->equithermLearning();
+  }
+
+  bool hasInputChanges() {
+    return fabsf(vars.master.heating.indoorTemp - this->lastIndoorTemp) >= 0.05f
+      || fabsf(vars.master.heating.outdoorTemp - this->lastOutdoorTemp) >= 0.25f
+      || fabsf(settings.heating.target - this->lastTarget) > 0.0001f
+      || vars.emergency.state != this->lastEmergency
+      || vars.slave.flame != this->lastFlame
+      || vars.master.heating.freezing != this->lastFreezing
+      || this->indoorSensorsConnected != this->lastIndoorSensorsConnected
+      || vars.actions.startPidAutotune || vars.actions.stopPidAutotune
+      || vars.actions.applyPidAutotune || vars.actions.applyEquithermLearning;
+  }
+
+  /**
+   * Weekly schedule: the target of the last passed block is written to the heating target
+   * only when it changes, so a manual target holds until the next switch point.
+   * Optimum start switches to a higher next target in advance, by the time predicted
+   * by the heat-up model, see OptimumStart. Block targets are room temps,
+   * the schedule is inactive without indoor temp control or a synced clock.
+   * After a reboot the current block counts as applied, a manual target survives the restart.
+   */
+  void schedule() {
+    const time_t now = time(nullptr);
+    // 2023-11-14, the clock is not synced before
+    const bool clockValid = now > 1700000000;
+
+    if (!settings.heating.schedule.enabled || !vars.master.heating.indoorTempControl || !clockValid) {
+      // enabled later: the current block is applied at once
+      if (!settings.heating.schedule.enabled) {
+        this->scheduleBooting = false;
+      }
+
+      this->scheduleTarget = NAN;
+      this->preheatEndTime = 0;
+      this->optimumStart.abort();
+
+      vars.schedule.active = false;
+      vars.schedule.preheat = false;
+      vars.schedule.block = -1;
+      vars.schedule.nextTime = 0;
+      vars.schedule.preheatTime = 0;
+
+      return;
+    }
+
+    struct tm ti;
+    localtime_r(&now, &ti);
+
+    // minutes from monday midnight
+    const uint16_t weekMinutes = 7 * 1440;
+    const uint16_t nowMinute = ((ti.tm_wday + 6) % 7) * 1440 + ti.tm_hour * 60 + ti.tm_min;
+    int8_t currentBlock = -1;
+    int8_t nextBlock = -1;
+    uint16_t elapsed = weekMinutes;
+    // a block that starts now is also the next one, a week ahead
+    uint16_t remaining = weekMinutes + 1;
+
+    for (uint8_t i = 0; i < SCHEDULE_MAX_BLOCKS; i++) {
+      const auto& block = scheduleSettings.blocks[i];
+      if (!block.enabled) {
+        continue;
+      }
+
+      for (uint8_t day = 0; day < 7; day++) {
+        if (!(block.days & (1 << day))) {
+          continue;
+        }
+
+        const uint16_t minute = day * 1440 + block.start;
+        const uint16_t blockElapsed = (nowMinute - minute + weekMinutes) % weekMinutes;
+        const uint16_t blockRemaining = weekMinutes - blockElapsed;
+
+        if (blockElapsed < elapsed) {
+          elapsed = blockElapsed;
+          currentBlock = i;
+        }
+
+        if (blockRemaining < remaining) {
+          remaining = blockRemaining;
+          nextBlock = i;
+        }
+      }
+    }
+
+    if (currentBlock == -1 || nextBlock == -1) {
+      this->scheduleBooting = false;
+      this->scheduleTarget = NAN;
+      this->preheatEndTime = 0;
+
+      vars.schedule.active = false;
+      vars.schedule.preheat = false;
+      vars.schedule.block = -1;
+      vars.schedule.nextTime = 0;
+      vars.schedule.preheatTime = 0;
+
+      return;
+    }
+
+    const float indoorTemp = convertTemp(vars.master.heating.indoorTemp, settings.system.unitSystem, UnitSystem::METRIC);
+    const float outdoorTemp = convertTemp(vars.master.heating.outdoorTemp, settings.system.unitSystem, UnitSystem::METRIC);
+    const float currentTarget = scheduleSettings.blocks[currentBlock].target;
+    const float nextTarget = scheduleSettings.blocks[nextBlock].target;
+    const time_t nextTime = now - ti.tm_sec + remaining * 60l;
+
+    if (!this->optimumStartReady) {
+      this->optimumStart.reset(scheduleSettings.heatUp.base, scheduleSettings.heatUp.loss);
+      this->optimumStartReady = true;
+    }
+
+    unsigned long preheatTime = 0;
+    if (settings.heating.schedule.optimumStart && this->indoorSensorsConnected && nextTarget > currentTarget) {
+      preheatTime = min(
+        this->optimumStart.getPreheatTime(indoorTemp, nextTarget, outdoorTemp),
+        settings.heating.schedule.maxPreheatTime * 3600ul
+      );
+
+      // latched until the switch point, the prediction shrinks as the room warms up
+      if (this->preheatEndTime != nextTime && nextTime - now <= (time_t) preheatTime) {
+        this->preheatEndTime = nextTime;
+
+        Log.sinfoln(
+          FPSTR(L_SCHEDULE), F("Preheat started, %lu min. before block #%hhd"),
+          (unsigned long) (nextTime - now) / 60ul, nextBlock
+        );
+      }
+    }
+
+    if (this->preheatEndTime != 0 && (this->preheatEndTime != nextTime || !settings.heating.schedule.optimumStart)) {
+      this->preheatEndTime = 0;
+    }
+
+    const bool preheat = this->preheatEndTime != 0;
+    const float target = preheat ? nextTarget : currentTarget;
+
+    // a started preheat is still applied below
+    if (this->scheduleBooting) {
+      this->scheduleBooting = false;
+      this->scheduleTarget = currentTarget;
+
+      Log.sinfoln(FPSTR(L_SCHEDULE), F("Block #%hhd, heating target is kept after boot"), currentBlock);
+    }
+
+    if (isnan(this->scheduleTarget) || fabsf(target - this->scheduleTarget) > 0.001f) {
+      this->scheduleTarget = target;
+      const float value = roundf(convertTemp(target, UnitSystem::METRIC, settings.system.unitSystem), 2);
+
+      if (fabsf(value - settings.heating.target) > 0.001f) {
+        settings.heating.target = value;
+        fsSettings.update();
+        publishSettingsChanges(SETTINGS_CHANGE_HEATING);
+
+        Log.sinfoln(FPSTR(L_SCHEDULE), F("Block #%hhd, heating target: %.2f"), preheat ? nextBlock : currentBlock, value);
+      }
+
+      if (settings.heating.schedule.optimumStart) {
+        this->optimumStart.start(target, indoorTemp, outdoorTemp);
+      }
+    }
+
+    this->heatUpLearning(target, indoorTemp, outdoorTemp);
+
+    vars.schedule.active = true;
+    vars.schedule.preheat = preheat;
+    vars.schedule.block = preheat ? nextBlock : currentBlock;
+    vars.schedule.target = convertTemp(target, UnitSystem::METRIC, settings.system.unitSystem);
+    vars.schedule.nextTime = nextTime;
+    vars.schedule.nextTarget = convertTemp(nextTarget, UnitSystem::METRIC, settings.system.unitSystem);
+    vars.schedule.preheatTime = min(preheatTime, (unsigned long) UINT16_MAX);
+  }
+
+  /**
+   * Fits the heat-up model to the scheduled rises,
+   * a heat-up is only observed while nothing but the regulator drives it.
+   */
+  void heatUpLearning(float target, float indoorTemp, float outdoorTemp) {
+    if (this->optimumStart.isObserving()) {
+      const bool valid = settings.heating.enabled && this->indoorSensorsConnected
+        && !vars.emergency.state && !settings.heating.turbo && !this->pidAutotune.isRunning()
+        && fabsf(convertTemp(target, UnitSystem::METRIC, settings.system.unitSystem) - settings.heating.target) < 0.01f;
+
+      if (!valid) {
+        this->optimumStart.abort();
+
+      } else if (this->optimumStart.update(target, indoorTemp, outdoorTemp)) {
+        scheduleSettings.heatUp.base = roundf(this->optimumStart.getBase(), 3);
+        scheduleSettings.heatUp.loss = roundf(this->optimumStart.getLoss(), 4);
+
+        if (scheduleSettings.heatUp.samples < UINT16_MAX) {
+          scheduleSettings.heatUp.samples++;
+        }
+
+        fsScheduleSettings.update();
+
+        Log.sinfoln(
+          FPSTR(L_SCHEDULE), F("Heat-up sample #%hu, base: %.3f, loss: %.4f"),
+          scheduleSettings.heatUp.samples, scheduleSettings.heatUp.base, scheduleSettings.heatUp.loss
+        );
+      }
+    }
+
+    const float rate = this->optimumStart.getRate(indoorTemp, outdoorTemp);
+    vars.schedule.heatUpRate = settings.system.unitSystem == UnitSystem::IMPERIAL ? rate * 1.8f : rate;
   }
 
   void turbo() {
@@ -88,25 +358,273 @@ protected:
     }
   }
 
+  /**
+   * The relay experiment drives the PID part of the setpoint,
+   * it is aborted as soon as the loop can not be controlled by the PID.
+   */
+  inline bool canRunPidAutotune() {
+    return settings.pid.enabled && settings.heating.enabled && this->indoorSensorsConnected
+      && !vars.emergency.state && !settings.heating.turbo && !settings.opentherm.options.nativeOTC;
+  }
+
+  void autotune() {
+    if (vars.actions.startPidAutotune) {
+      vars.actions.startPidAutotune = false;
+
+      if (this->pidAutotune.isRunning()) {
+        Log.swarningln(FPSTR(L_REGULATOR_PID), F("Auto-tune is already running"));
+
+      } else if (!this->canRunPidAutotune()) {
+        Log.swarningln(FPSTR(L_REGULATOR_PID), F("Auto-tune requires enabled PID, heating and indoor temp sensor"));
+
+      } else if (settings.pid.maxTemp - settings.pid.minTemp < 4) {
+        Log.swarningln(FPSTR(L_REGULATOR_PID), F("Auto-tune requires wider PID limits"));
+
+      } else {
+        // relay swings over half of the PID limits around the current result
+        const float step = (settings.pid.maxTemp - settings.pid.minTemp) / 4.0f;
+        const float base = constrain(this->prevPidResult, settings.pid.minTemp + step, settings.pid.maxTemp - step);
+
+        this->pidAutotune.setHysteresis(PID_AUTOTUNE_HYSTERESIS)
+          ->setMaxCycles(PID_AUTOTUNE_MAX_CYCLES)
+          ->setTimeout(PID_AUTOTUNE_TIMEOUT);
+        this->pidAutotune.start(settings.heating.target, base, step);
+
+        Log.sinfoln(FPSTR(L_REGULATOR_PID), F("Auto-tune started, output: %.2f +/- %.2f"), base, step);
+      }
+    }
+
+    if (vars.actions.stopPidAutotune) {
+      vars.actions.stopPidAutotune = false;
+
+      if (this->pidAutotune.isRunning()) {
+        this->pidAutotune.abort();
+        Log.sinfoln(FPSTR(L_REGULATOR_PID), F("Auto-tune stopped"));
+      }
+    }
+
+    if (this->pidAutotune.isRunning()) {
+      if (!this->canRunPidAutotune()) {
+        this->pidAutotune.abort();
+        Log.swarningln(FPSTR(L_REGULATOR_PID), F("Auto-tune aborted, PID control is not possible"));
+
+      } else if (fabsf(this->pidAutotune.getSetpoint() - settings.heating.target) > 0.0001f) {
+        this->pidAutotune.abort();
+        Log.swarningln(FPSTR(L_REGULATOR_PID), F("Auto-tune aborted, target has been changed"));
+      }
+    }
+
+    if (vars.actions.applyPidAutotune) {
+      vars.actions.applyPidAutotune = false;
+
+      if (this->pidAutotune.getState() == PidAutotune::State::DONE) {
+        settings.pid.p_factor = constrain(this->pidAutotune.getKp(), 0.001f, 1000.0f);
+        settings.pid.i_factor = constrain(this->pidAutotune.getKi(), 0.0f, 100.0f);
+        settings.pid.d_factor = constrain(this->pidAutotune.getKd(), 0.0f, 100000.0f);
+        fsSettings.update();
+        publishSettingsChanges(SETTINGS_CHANGE_PID);
+        this->pidAutotune.reset();
+
+        Log.sinfoln(
+          FPSTR(L_REGULATOR_PID), F("Auto-tune result applied, P: %.3f, I: %.5f, D: %.1f"),
+          settings.pid.p_factor, settings.pid.i_factor, settings.pid.d_factor
+        );
+
+      } else {
+        Log.swarningln(FPSTR(L_REGULATOR_PID), F("Auto-tune has no result to apply"));
+      }
+    }
+
+    const PidAutotune::State state = this->pidAutotune.getState();
+    if (state != this->prevPidAutotuneState) {
+      this->prevPidAutotuneState = state;
+
+      if (state == PidAutotune::State::DONE) {
+        Log.sinfoln(
+          FPSTR(L_REGULATOR_PID), F("Auto-tune done, Ku: %.3f, Tu: %.0f s, proposed P: %.3f, I: %.5f, D: %.1f"),
+          this->pidAutotune.getUltimateGain(), this->pidAutotune.getUltimatePeriod(),
+          this->pidAutotune.getKp(), this->pidAutotune.getKi(), this->pidAutotune.getKd()
+        );
+
+      } else if (state == PidAutotune::State::FAILED) {
+        Log.swarningln(FPSTR(L_REGULATOR_PID), F("Auto-tune failed, no stable oscillation after %hhu cycles"), this->pidAutotune.getCycles());
+      }
+    }
+
+    vars.pidAutotune.state = static_cast<uint8_t>(state);
+    vars.pidAutotune.progress = this->pidAutotune.getProgress();
+    vars.pidAutotune.cycles = this->pidAutotune.getCycles();
+    vars.pidAutotune.ultimateGain = this->pidAutotune.getUltimateGain();
+    vars.pidAutotune.ultimatePeriod = this->pidAutotune.getUltimatePeriod();
+    vars.pidAutotune.p_factor = state == PidAutotune::State::DONE ? this->pidAutotune.getKp() : 0.0f;
+    vars.pidAutotune.i_factor = state == PidAutotune::State::DONE ? this->pidAutotune.getKi() : 0.0f;
+    vars.pidAutotune.d_factor = state == PidAutotune::State::DONE ? this->pidAutotune.getKd() : 0.0f;
+  }
+
+  /**
+   * Fits slope and shift of the curve to the observed indoor response, see EquithermLearner.
+   * Only steady heating by the curve is sampled: no turbo, emergency, hysteresis blocking,
+   * auto-tune, and the setpoint is not clipped by the heating limits.
+   */
+  void equithermLearning() {
+    if (!settings.equitherm.enabled || !settings.equitherm.learning.enabled) {
+      this->equithermLearnerReady = false;
+      vars.actions.applyEquithermLearning = false;
+      vars.equithermLearning.samples = 0;
+
+      return;
+    }
+
+    if (!this->equithermLearnerReady || fabsf(this->equithermLearner.getExponent() - settings.equitherm.exponent) > 0.0001f) {
+      this->equithermLearner.setWindow(EQUITHERM_LEARNING_WINDOW);
+      this->equithermLearner.reset(settings.equitherm.slope, settings.equitherm.shift, settings.equitherm.exponent);
+      this->equithermLearnerReady = true;
+
+      Log.sinfoln(FPSTR(L_REGULATOR_EQUITHERM), F("Learning started, slope: %.3f, shift: %.2f"), settings.equitherm.slope, settings.equitherm.shift);
+    }
+
+    const bool steady = settings.heating.enabled && this->indoorSensorsConnected
+      && Sensors::existsConnectedSensorsByPurpose(Sensors::Purpose::OUTDOOR_TEMP)
+      && !vars.emergency.state && !vars.master.heating.blocking && !vars.master.heating.freezing
+      && !settings.heating.turbo && !settings.opentherm.options.nativeOTC && !this->pidAutotune.isRunning()
+      && vars.master.heating.setpointTemp > settings.heating.minTemp
+      && vars.master.heating.setpointTemp < settings.heating.maxTemp;
+
+    if (!steady) {
+      this->equithermLearner.invalidate();
+
+    } else if (this->equithermLearner.sample(settings.heating.target, settings.heating.maxTemp, vars.master.heating.outdoorTemp, vars.master.heating.setpointTemp, vars.master.heating.indoorTemp)) {
+      Log.sinfoln(
+        FPSTR(L_REGULATOR_EQUITHERM), F("Learning sample #%hu, suggested slope: %.3f, shift: %.2f"),
+        this->equithermLearner.getSamples(), this->equithermLearner.getSlope(), this->equithermLearner.getShift()
+      );
+
+      if (settings.equitherm.learning.autoApply && this->equithermLearner.getSamples() >= EQUITHERM_LEARNING_MIN_SAMPLES) {
+        // small steps, the fit is revised every window
+        this->applyEquithermLearning(EQUITHERM_LEARNING_SLOPE_STEP, EQUITHERM_LEARNING_SHIFT_STEP);
+      }
+    }
+
+    if (vars.actions.applyEquithermLearning) {
+      vars.actions.applyEquithermLearning = false;
+
+      if (this->equithermLearner.getSamples() >= EQUITHERM_LEARNING_MIN_SAMPLES) {
+        this->applyEquithermLearning(EQUITHERM_LEARNING_MAX_SLOPE, EQUITHERM_LEARNING_MAX_SHIFT * 2);
+
+      } else {
+        Log.swarningln(
+          FPSTR(L_REGULATOR_EQUITHERM), F("Learning has %hu of %hu samples, nothing to apply"),
+          this->equithermLearner.getSamples(), (uint16_t) EQUITHERM_LEARNING_MIN_SAMPLES
+        );
+      }
+    }
+
+    vars.equithermLearning.samples = this->equithermLearner.getSamples();
+    vars.equithermLearning.slope = this->getEquithermLearnedSlope();
+    vars.equithermLearning.shift = this->getEquithermLearnedShift();
+  }
+
+  inline float getEquithermLearnedSlope() {
+    return constrain(this->equithermLearner.getSlope(), EQUITHERM_LEARNING_MIN_SLOPE, EQUITHERM_LEARNING_MAX_SLOPE);
+  }
+
+  inline float getEquithermLearnedShift() {
+    return constrain(this->equithermLearner.getShift(), -(EQUITHERM_LEARNING_MAX_SHIFT), EQUITHERM_LEARNING_MAX_SHIFT);
+  }
+
+  void applyEquithermLearning(float maxSlopeStep, float maxShiftStep) {
+    const float slope = settings.equitherm.slope + constrain(this->getEquithermLearnedSlope() - settings.equitherm.slope, -maxSlopeStep, maxSlopeStep);
+    const float shift = settings.equitherm.shift + constrain(this->getEquithermLearnedShift() - settings.equitherm.shift, -maxShiftStep, maxShiftStep);
+
+    if (fabsf(slope - settings.equitherm.slope) < 0.001f && fabsf(shift - settings.equitherm.shift) < 0.01f) {
+      return;
+    }
+
+    settings.equitherm.slope = roundf(slope, 3);
+    settings.equitherm.shift = roundf(shift, 2);
+    fsSettings.update();
+    publishSettingsChanges(SETTINGS_CHANGE_EQUITHERM);
+
+    Log.sinfoln(FPSTR(L_REGULATOR_EQUITHERM), F("Learned curve applied, slope: %.3f, shift: %.2f"), settings.equitherm.slope, settings.equitherm.shift);
+  }
+
   void hysteresis() {
     bool useHyst = false;
-    if (settings.heating.hysteresis.enabled && this->indoorSensorsConnected) {
+    if (settings.heating.hysteresis.enabled && this->indoorSensorsConnected && !this->pidAutotune.isRunning()) {
       useHyst = settings.equitherm.enabled || settings.pid.enabled || settings.opentherm.options.nativeOTC;
     }
 
     if (useHyst) {
-      if (!vars.master.heating.blocking && vars.master.heating.indoorTemp - settings.heating.target + 0.0001f >= settings.heating.hysteresis.value) {
-        vars.master.heating.blocking = true;
+      if (!this->hysteresisBlocking && vars.master.heating.indoorTemp - settings.heating.target + 0.0001f >= settings.heating.hysteresis.value) {
+        this->hysteresisBlocking = true;
 
-      } else if (vars.master.heating.blocking && vars.master.heating.indoorTemp - settings.heating.target - 0.0001f <= -(settings.heating.hysteresis.value)) {
-        vars.master.heating.blocking = false;
+      } else if (this->hysteresisBlocking && vars.master.heating.indoorTemp - settings.heating.target - 0.0001f <= -(settings.heating.hysteresis.value)) {
+        this->hysteresisBlocking = false;
       }
 
-    } else if (vars.master.heating.blocking) {
-      vars.master.heating.blocking = false;
+    } else if (this->hysteresisBlocking) {
+      this->hysteresisBlocking = false;
     }
   }
 
+  /**
+   * Keeps the burner off for the min off time after a short burn or when it cycles too often.
+   * The flame is sampled every regulator iteration, edges are not seen while the boiler is disconnected.
+   * A burn that ignited for DHW is not counted, a heating burn handed over to DHW (or back) is one burn.
+   * Freeze protection still enables heating, it ignores the blocking.
+   */
+  void antiCycling() {
+    if (vars.slave.connected) {
+      if (vars.slave.flame && !this->burnerFlame) {
+        this->dhwBurn = vars.slave.dhw.active;
+
+      } else if (!vars.slave.flame) {
+        this->dhwBurn = false;
+      }
+
+      this->burnerFlame = vars.slave.flame;
+    }
+
+    const bool flame = this->burnerFlame && !this->dhwBurn;
+
+    if (vars.slave.connected && this->cycleMonitor.update(flame, vars.slave.modulation.current) && !flame) {
+      const unsigned long onTime = this->cycleMonitor.getLastOnTime();
+      const uint8_t cycles = this->cycleMonitor.getCyclesPerHour();
+
+      Log.sinfoln(
+        FPSTR(L_REGULATOR), F("Burner off after %lu sec., cycles per hour: %hhu, modulation: %hhu%%"),
+        onTime, cycles, this->cycleMonitor.getLastModulation()
+      );
+
+      if (settings.heating.antiCycling.enabled && !vars.antiCycling.lockout) {
+        if (onTime < settings.heating.antiCycling.minOnTime * 60ul || cycles > settings.heating.antiCycling.maxCycles) {
+          vars.antiCycling.lockout = true;
+
+          Log.swarningln(
+            FPSTR(L_REGULATOR), F("Short cycling detected, heating blocked for %hhu min."),
+            settings.heating.antiCycling.minOffTime
+          );
+        }
+      }
+    }
+
+    if (vars.antiCycling.lockout) {
+      if (!settings.heating.antiCycling.enabled || this->cycleMonitor.isFlameOn()) {
+        vars.antiCycling.lockout = false;
+
+      } else if (this->cycleMonitor.getOffTime() >= settings.heating.antiCycling.minOffTime * 60ul) {
+        vars.antiCycling.lockout = false;
+
+        Log.sinfoln(FPSTR(L_REGULATOR), F("Short cycling lockout expired"));
+      }
+    }
+
+    vars.antiCycling.cycles = this->cycleMonitor.getCyclesPerHour();
+    vars.antiCycling.modulation = this->cycleMonitor.getLastModulation();
+    vars.antiCycling.lastOnTime = min(this->cycleMonitor.getLastOnTime(), (unsigned long) UINT16_MAX);
+    vars.antiCycling.minOnTime = min(this->cycleMonitor.getMinOnTime(), (unsigned long) UINT16_MAX);
+  }
+
   inline float getHeatingMinSetpointTemp() {
     return settings.opentherm.options.nativeOTC
       ? vars.master.heating.minTemp
@@ -119,6 +637,43 @@ protected:
       : settings.heating.maxTemp;
   }
 
+  /**
+   * Rise of the heat curve above the target.
+   * The curve reaches maxTemp when the outdoor temp is (maxTemp - target) / slope below the target,
+   * so range * (delta / maxDelta) ^ (1 / exponent) needs a single pow().
+   */
+  float getEquithermCurveTemp(float target, float outdoorTemp) {
+    #if REGULATOR_FIXED_POINT
+    const FixedMath::q16_t range = FixedMath::fromFloat(settings.heating.maxTemp - target);
+    const FixedMath::q16_t maxDelta = FixedMath::div(range, FixedMath::fromFloat(settings.equitherm.slope));
+    if (range <= 0 || maxDelta <= 0) {
+      return 0.0f;
+    }
+
+    const FixedMath::q16_t delta = FixedMath::fromFloat(target - outdoorTemp);
+    const FixedMath::q16_t result = FixedMath::mulPowRatio(
+      range,
+      delta >= 0 ? delta : -delta,
+      maxDelta,
+      FixedMath::div(FixedMath::ONE, FixedMath::fromFloat(settings.equitherm.exponent))
+    );
+
+    return FixedMath::toFloat(delta >= 0 ? result : -result);
+
+    #else
+    const float range = settings.heating.maxTemp - target;
+    const float maxDelta = range / settings.equitherm.slope;
+    if (range <= 0.0f || maxDelta <= 0.0f) {
+      return 0.0f;
+    }
+
+    const float delta = target - outdoorTemp;
+    const float result = range * powf(fabsf(delta) / maxDelta, 1.0f / settings.equitherm.exponent);
+
+    return delta >= 0 ? result : -result;
+    #endif
+  }
+
   float getHeatingSetpointTemp() {
     float newTemp = 0;
 
@@ -144,19 +699,9 @@ protected:
 
     // if use equitherm
     if (settings.equitherm.enabled) {
-      float tempDelta = settings.heating.target - vars.master.heating.outdoorTemp;
-      float maxPoint = settings.heating.target - (
-        settings.heating.maxTemp - settings.heating.target
-      ) / settings.equitherm.slope;
-
-      float sf = (settings.heating.maxTemp - settings.heating.target) / pow(
-        settings.heating.target - maxPoint,
-        1.0f / settings.equitherm.exponent
-      );
-      float etResult = settings.heating.target + settings.equitherm.shift + sf * (
-        tempDelta >= 0 
-          ? pow(tempDelta, 1.0f / settings.equitherm.exponent) 
-          : -(pow(-(tempDelta), 1.0f / settings.equitherm.exponent))
+      float etResult = settings.heating.target + settings.equitherm.shift + this->getEquithermCurveTemp(
+        settings.heating.target,
+        vars.master.heating.outdoorTemp
       );
 
       // add diff
@@ -185,13 +730,31 @@ protected:
     // if use pid
     if (settings.pid.enabled) {
       //if (vars.parameters.heatingEnabled) {
-      if (settings.heating.enabled && this->indoorSensorsConnected) {
+      if (this->pidAutotune.isRunning()) {
+        this->pidStarted = false;
+        float relayResult = this->pidAutotune.update(vars.master.heating.indoorTemp);
+        if (fabsf(prevPidResult - relayResult) > 0.09f) {
+          prevPidResult = relayResult;
+
+          Log.sinfoln(FPSTR(L_REGULATOR_PID), F("Auto-tune relay output: %.2f"), relayResult);
+        }
+
+        newTemp += prevPidResult;
+
+      } else if (settings.heating.enabled && this->indoorSensorsConnected) {
         pidRegulator.Kp = settings.heating.turbo ? 0.0f : settings.pid.p_factor;
         pidRegulator.Ki = settings.pid.i_factor;
         pidRegulator.Kd = settings.pid.d_factor;
 
         pidRegulator.setLimits(settings.pid.minTemp, settings.pid.maxTemp);
-        pidRegulator.setDt(settings.pid.dt * 1000u);
+
+        // computed every dt and at once on a new target, with the actual elapsed time
+        const unsigned long now = millis();
+        const bool pidDue = !this->pidStarted
+          || fabsf(pidRegulator.setpoint - settings.heating.target) > 0.0001f
+          || now - this->lastPidTime >= settings.pid.dt * 1000ul;
+
+        pidRegulator.setDt(this->pidStarted ? now - this->lastPidTime : settings.pid.dt * 1000ul);
         pidRegulator.input = vars.master.heating.indoorTemp;
         pidRegulator.setpoint = settings.heating.target;
 
@@ -214,7 +777,13 @@ protected:
           pidRegulator.Kd *= settings.pid.deadband.d_multiplier;
         }
 
-        float pidResult = pidRegulator.getResultTimer();
+        float pidResult = pidRegulator.output;
+        if (pidDue) {
+          pidResult = pidRegulator.getResult();
+          this->pidStarted = true;
+          this->lastPidTime = now;
+        }
+
         if (fabsf(prevPidResult - pidResult) > 0.09f) {
           prevPidResult = pidResult;
           newTemp += pidResult;
@@ -227,6 +796,7 @@ protected:
         }
 
       } else {
+        this->pidStarted = false;
         newTemp += prevPidResult;
       }
     }
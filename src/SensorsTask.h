@@ -6,7 +6,7 @@
   #include <NimBLEDevice.h>
 #endif
 
-extern FileData fsSensorsSettings;
+extern JournalData fsSensorsSettings;
 
 #if USE_BLE
 class BluetoothClientCallbacks : public NimBLEClientCallbacks {
@@ -66,6 +66,8 @@ public:
   }
 
 protected:
+  LoopStats loopStats{"sensors"};
+
   const unsigned int wiredDisconnectTimeout = 180000u;
   const unsigned int wirelessDisconnectTimeout = 600000u;
   const unsigned short dallasSearchInterval = 60000;
@@ -107,6 +109,8 @@ protected:
   #endif
 
   void loop() {
+    LoopStats::Guard loopGuard(this->loopStats);
+
     if (vars.states.restarting || vars.states.upgrading) {
       return;
     }
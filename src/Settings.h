@@ -124,6 +124,21 @@ struct Settings {
       uint8_t highTemp = 15;
       uint8_t lowTemp = 10;
     } freezeProtection;
+
+    // times in minutes
+    struct {
+      bool enabled = false;
+      uint8_t maxCycles = 6;
+      uint8_t minOnTime = 5;
+      uint8_t minOffTime = 10;
+    } antiCycling;
+
+    struct {
+      bool enabled = false;
+      bool optimumStart = true;
+      // in hours
+      uint8_t maxPreheatTime = 3;
+    } schedule;
   } heating;
 
   struct {
@@ -164,6 +179,11 @@ struct Settings {
     float exponent = 1.3f;
     float shift = 0.0f;
     float targetDiffFactor = 2.0f;
+
+    struct {
+      bool enabled = false;
+      bool autoApply = false;
+    } learning;
   } equitherm;
 
   struct {
@@ -268,6 +288,27 @@ Sensors::Settings sensorsSettings[SENSORS_AMOUNT] = {
   }
 };
 
+// the blocks must stay last: a change of SCHEDULE_MAX_BLOCKS only resizes the file, see SettingsMigrations.h
+struct ScheduleSettings {
+  // optimum start model, see OptimumStart
+  struct {
+    float base = 2.0f;
+    float loss = 0.03f;
+    uint16_t samples = 0;
+  } heatUp;
+
+  // a block holds its target from its start until the start of the next block
+  struct Block {
+    bool enabled = false;
+    // bit 0 - monday, bit 6 - sunday
+    uint8_t days = 0;
+    // minutes from midnight
+    uint16_t start = 0;
+    // in celsius
+    float target = 20.0f;
+  } blocks[SCHEDULE_MAX_BLOCKS];
+} scheduleSettings;
+
 struct Variables {
   struct {
     bool connected = false;
@@ -276,6 +317,7 @@ struct Variables {
 
   struct {
     bool connected = false;
+    uint8_t discoveryProgress = 0;
   } mqtt;
 
   struct {
@@ -430,10 +472,50 @@ struct Variables {
     } ch2;
   } slave;
 
+  struct {
+    uint8_t state = 0;
+    uint8_t progress = 0;
+    uint8_t cycles = 0;
+    float ultimateGain = 0.0f;
+    float ultimatePeriod = 0.0f;
+    float p_factor = 0.0f;
+    float i_factor = 0.0f;
+    float d_factor = 0.0f;
+  } pidAutotune;
+
+  struct {
+    uint16_t samples = 0;
+    float slope = 0.0f;
+    float shift = 0.0f;
+  } equithermLearning;
+
+  struct {
+    bool lockout = false;
+    uint8_t cycles = 0;
+    uint8_t modulation = 0;
+    uint16_t lastOnTime = 0;
+    uint16_t minOnTime = 0;
+  } antiCycling;
+
+  struct {
+    bool active = false;
+    bool preheat = false;
+    int8_t block = -1;
+    float target = 0.0f;
+    unsigned long nextTime = 0;
+    float nextTarget = 0.0f;
+    uint16_t preheatTime = 0;
+    float heatUpRate = 0.0f;
+  } schedule;
+
   struct {
     bool restart = false;
     bool resetFault = false;
     bool resetDiagnostic = false;
+    bool startPidAutotune = false;
+    bool stopPidAutotune = false;
+    bool applyPidAutotune = false;
+    bool applyEquithermLearning = false;
   } actions;
 
   struct {
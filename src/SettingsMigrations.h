@@ -0,0 +1,120 @@
+#include <stddef.h>
+
+/**
+ * Layout history of Settings as stored on flash.
+ * When the layout of Settings changes, bump SETTINGS_VERSION and append a step converting
+ * the previous layout in place. Bytes of new fields are taken from `settings`,
+ * which still holds the defaults while migrating. Offsets of old layouts are frozen numbers.
+ *
+ * 0 - FileData file, same layout as 1
+ * 1 - journaled storage
+ * 2 - equitherm.learning
+ * 3 - heating.antiCycling
+ * 4 - heating.schedule
+ */
+typedef bool (*SettingsMigrationStep)(uint8_t* buffer, uint16_t& size, uint16_t capacity);
+
+// inserts `length` bytes at `offset` of the new layout, filled from the defaults at `defaultsOffset`
+inline bool insertSettingsBytes(uint8_t* buffer, uint16_t& size, uint16_t capacity, uint16_t offset, uint16_t length, uint16_t defaultsOffset) {
+  if (offset > size || size + length > capacity) {
+    return false;
+  }
+
+  memmove(buffer + offset + length, buffer + offset, size - offset);
+  memcpy(buffer + offset, reinterpret_cast<const uint8_t*>(&settings) + defaultsOffset, length);
+  size += length;
+
+  return true;
+}
+
+// removes `length` bytes at `offset` of the old layout
+inline bool removeSettingsBytes(uint8_t* buffer, uint16_t& size, uint16_t offset, uint16_t length) {
+  if (offset + length > size) {
+    return false;
+  }
+
+  memmove(buffer + offset, buffer + offset + length, size - offset - length);
+  size -= length;
+
+  return true;
+}
+
+bool migrateSettingsFrom0(uint8_t* buffer, uint16_t& size, uint16_t capacity) {
+  // written by FileData with the v1 layout, the size was fixed
+  const uint16_t v1Size = 552;
+  const uint16_t v1ValidationOffset = 544;
+  if (size != v1Size) {
+    return false;
+  }
+
+  return strncmp(reinterpret_cast<const char*>(buffer + v1ValidationOffset), SETTINGS_VALID_VALUE, sizeof(Settings::validationValue)) == 0;
+}
+
+bool migrateSettingsFrom1(uint8_t* buffer, uint16_t& size, uint16_t capacity) {
+  // equitherm.learning and its padding, before externalPump
+  return insertSettingsBytes(buffer, size, capacity, 512, 4, SETTINGS_OFFSET(equitherm.learning));
+}
+
+bool migrateSettingsFrom2(uint8_t* buffer, uint16_t& size, uint16_t capacity) {
+  // heating.antiCycling, at the end of heating
+  return insertSettingsBytes(buffer, size, capacity, 428, 4, SETTINGS_OFFSET(heating.antiCycling));
+}
+
+bool migrateSettingsFrom3(uint8_t* buffer, uint16_t& size, uint16_t capacity) {
+  // heating.schedule and its padding, at the end of heating
+  return insertSettingsBytes(buffer, size, capacity, 432, 4, SETTINGS_OFFSET(heating.schedule));
+}
+
+const SettingsMigrationStep settingsMigrationSteps[SETTINGS_VERSION] = {
+  migrateSettingsFrom0,
+  migrateSettingsFrom1,
+  migrateSettingsFrom2,
+  migrateSettingsFrom3
+};
+
+bool migrateSettings(uint16_t version, uint8_t* buffer, uint16_t& size, uint16_t capacity) {
+  for (uint16_t i = version; i < SETTINGS_VERSION; i++) {
+    if (!settingsMigrationSteps[i](buffer, size, capacity)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Layout history of ScheduleSettings, same rules as above.
+ * The blocks are the last field, the file of another SCHEDULE_MAX_BLOCKS is loaded as resized.
+ *
+ * 0 - blocks, then heatUp
+ * 1 - heatUp, then blocks
+ */
+bool migrateScheduleSettingsFrom0(uint8_t* buffer, uint16_t& size, uint16_t capacity) {
+  // heatUp was the last 12 bytes, after any number of 8 byte blocks
+  const uint16_t heatUpSize = 12;
+  const uint16_t blockSize = 8;
+  if (size < heatUpSize || (size - heatUpSize) % blockSize != 0) {
+    return false;
+  }
+
+  uint8_t heatUp[heatUpSize];
+  memcpy(heatUp, buffer + size - heatUpSize, heatUpSize);
+  memmove(buffer + heatUpSize, buffer, size - heatUpSize);
+  memcpy(buffer, heatUp, heatUpSize);
+
+  return true;
+}
+
+const SettingsMigrationStep scheduleSettingsMigrationSteps[SCHEDULE_SETTINGS_VERSION] = {
+  migrateScheduleSettingsFrom0
+};
+
+bool migrateScheduleSettings(uint16_t version, uint8_t* buffer, uint16_t& size, uint16_t capacity) {
+  for (uint16_t i = version; i < SCHEDULE_SETTINGS_VERSION; i++) {
+    if (!scheduleSettingsMigrationSteps[i](buffer, size, capacity)) {
+      return false;
+    }
+  }
+
+  return true;
+}
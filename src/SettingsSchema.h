@@ -0,0 +1,466 @@
+#include <stddef.h>
+
+/**
+ * Field descriptors of Settings, drive settingsToJson() and jsonToSettings().
+ * Fields are listed depth-first, so the fields of any json object are contiguous.
+ * Fields with cross-field rules are flagged as MANUAL and parsed by hand in jsonToSettings().
+ */
+enum class SettingsFieldType : uint8_t {
+  BOOL,
+  UINT8,
+  UINT16,
+  UINT32,
+  INT16,
+  FLOAT,
+  STRING,
+  GPIO
+};
+
+// available with safe = true (e.g. via mqtt)
+#define SETTINGS_FIELD_SAFE         (1 << 0)
+// temperature, converted when the unit system is changed
+#define SETTINGS_FIELD_TEMP         (1 << 1)
+// min/max are metric temps, validated by isValidTemp() in the current unit system
+#define SETTINGS_FIELD_TEMP_RANGE   (1 << 2)
+// serialized from the table, parsed by hand
+#define SETTINGS_FIELD_MANUAL       (1 << 3)
+
+struct SettingsField {
+  const char* path[3];
+  uint16_t offset;
+  SettingsFieldType type;
+  uint8_t flags;
+  // string: buffer size, float: decimals
+  uint8_t size;
+  float min;
+  float max;
+  // stored value = json value * scale
+  uint32_t scale;
+  void (*onChange)(Settings&);
+};
+
+#define SETTINGS_OFFSET(member) static_cast<uint16_t>(offsetof(Settings, member))
+
+void onChangeCh2AlwaysEnabled(Settings& dst) {
+  if (dst.opentherm.options.ch2AlwaysEnabled) {
+    dst.opentherm.options.heatingToCh2 = false;
+    dst.opentherm.options.dhwToCh2 = false;
+  }
+}
+
+void onChangeHeatingToCh2(Settings& dst) {
+  if (dst.opentherm.options.heatingToCh2) {
+    dst.opentherm.options.ch2AlwaysEnabled = false;
+    dst.opentherm.options.dhwToCh2 = false;
+  }
+}
+
+void onChangeDhwToCh2(Settings& dst) {
+  if (dst.opentherm.options.dhwToCh2) {
+    dst.opentherm.options.ch2AlwaysEnabled = false;
+    dst.opentherm.options.heatingToCh2 = false;
+  }
+}
+
+void onChangeNativeOtc(Settings& dst) {
+  if (dst.opentherm.options.nativeOTC) {
+    dst.equitherm.enabled = false;
+    dst.pid.enabled = false;
+  }
+}
+
+const SettingsField settingsFields[] PROGMEM = {
+  // system
+  {{S_SYSTEM, S_LOG_LEVEL}, SETTINGS_OFFSET(system.logLevel), SettingsFieldType::UINT8, 0, 0, TinyLogger::Level::SILENT, TinyLogger::Level::VERBOSE, 1, nullptr},
+  {{S_SYSTEM, S_SERIAL, S_ENABLED}, SETTINGS_OFFSET(system.serial.enabled), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_SYSTEM, S_SERIAL, S_BAUDRATE}, SETTINGS_OFFSET(system.serial.baudrate), SettingsFieldType::UINT32, SETTINGS_FIELD_MANUAL, 0, 0, 0, 1, nullptr},
+  {{S_SYSTEM, S_TELNET, S_ENABLED}, SETTINGS_OFFSET(system.telnet.enabled), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_SYSTEM, S_TELNET, S_PORT}, SETTINGS_OFFSET(system.telnet.port), SettingsFieldType::UINT16, 0, 0, 1, 65535, 1, nullptr},
+  {{S_SYSTEM, S_NTP, S_SERVER}, SETTINGS_OFFSET(system.ntp.server), SettingsFieldType::STRING, 0, sizeof(settings.system.ntp.server), 0, 0, 1, nullptr},
+  {{S_SYSTEM, S_NTP, S_TIMEZONE}, SETTINGS_OFFSET(system.ntp.timezone), SettingsFieldType::STRING, 0, sizeof(settings.system.ntp.timezone), 0, 0, 1, nullptr},
+  {{S_SYSTEM, S_UNIT_SYSTEM}, SETTINGS_OFFSET(system.unitSystem), SettingsFieldType::UINT8, SETTINGS_FIELD_MANUAL, 0, 0, 1, 1, nullptr},
+  {{S_SYSTEM, S_STATUS_LED_GPIO}, SETTINGS_OFFSET(system.statusLedGpio), SettingsFieldType::GPIO, 0, 0, 0, 0, 1, nullptr},
+
+  // portal
+  {{S_PORTAL, S_AUTH}, SETTINGS_OFFSET(portal.auth), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_PORTAL, S_LOGIN}, SETTINGS_OFFSET(portal.login), SettingsFieldType::STRING, 0, sizeof(settings.portal.login), 0, 0, 1, nullptr},
+  {{S_PORTAL, S_PASSWORD}, SETTINGS_OFFSET(portal.password), SettingsFieldType::STRING, 0, sizeof(settings.portal.password), 0, 0, 1, nullptr},
+  {{S_PORTAL, S_MDNS}, SETTINGS_OFFSET(portal.mdns), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+
+  // opentherm
+  {{S_OPENTHERM, S_UNIT_SYSTEM}, SETTINGS_OFFSET(opentherm.unitSystem), SettingsFieldType::UINT8, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_IN_GPIO}, SETTINGS_OFFSET(opentherm.inGpio), SettingsFieldType::GPIO, 0, 0, 0, 0, 1, nullptr},
+  {{S_OPENTHERM, S_OUT_GPIO}, SETTINGS_OFFSET(opentherm.outGpio), SettingsFieldType::GPIO, 0, 0, 0, 0, 1, nullptr},
+  {{S_OPENTHERM, S_RX_LED_GPIO}, SETTINGS_OFFSET(opentherm.rxLedGpio), SettingsFieldType::GPIO, 0, 0, 0, 0, 1, nullptr},
+  {{S_OPENTHERM, S_MEMBER_ID}, SETTINGS_OFFSET(opentherm.memberId), SettingsFieldType::UINT8, 0, 0, 0, 255, 1, nullptr},
+  {{S_OPENTHERM, S_FLAGS}, SETTINGS_OFFSET(opentherm.flags), SettingsFieldType::UINT8, 0, 0, 0, 255, 1, nullptr},
+  {{S_OPENTHERM, S_MIN_POWER}, SETTINGS_OFFSET(opentherm.minPower), SettingsFieldType::FLOAT, 0, 2, 0, 1000, 1, nullptr},
+  {{S_OPENTHERM, S_MAX_POWER}, SETTINGS_OFFSET(opentherm.maxPower), SettingsFieldType::FLOAT, 0, 2, 0, 1000, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_DHW_SUPPORT}, SETTINGS_OFFSET(opentherm.options.dhwSupport), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_COOLING_SUPPORT}, SETTINGS_OFFSET(opentherm.options.coolingSupport), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_SUMMER_WINTER_MODE}, SETTINGS_OFFSET(opentherm.options.summerWinterMode), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_HEATING_STATE_TO_SUMMER_WINTER_MODE}, SETTINGS_OFFSET(opentherm.options.heatingStateToSummerWinterMode), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_CH2_ALWAYS_ENABLED}, SETTINGS_OFFSET(opentherm.options.ch2AlwaysEnabled), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, onChangeCh2AlwaysEnabled},
+  {{S_OPENTHERM, S_OPTIONS, S_HEATING_TO_CH2}, SETTINGS_OFFSET(opentherm.options.heatingToCh2), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, onChangeHeatingToCh2},
+  {{S_OPENTHERM, S_OPTIONS, S_DHW_TO_CH2}, SETTINGS_OFFSET(opentherm.options.dhwToCh2), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, onChangeDhwToCh2},
+  {{S_OPENTHERM, S_OPTIONS, S_DHW_BLOCKING}, SETTINGS_OFFSET(opentherm.options.dhwBlocking), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_DHW_STATE_AS_DHW_BLOCKING}, SETTINGS_OFFSET(opentherm.options.dhwStateAsDhwBlocking), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_MAX_TEMP_SYNC_WITH_TARGET_TEMP}, SETTINGS_OFFSET(opentherm.options.maxTempSyncWithTargetTemp), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_GET_MIN_MAX_TEMP}, SETTINGS_OFFSET(opentherm.options.getMinMaxTemp), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_IGNORE_DIAG_STATE}, SETTINGS_OFFSET(opentherm.options.ignoreDiagState), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_AUTO_FAULT_RESET}, SETTINGS_OFFSET(opentherm.options.autoFaultReset), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_AUTO_DIAG_RESET}, SETTINGS_OFFSET(opentherm.options.autoDiagReset), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_SET_DATE_AND_TIME}, SETTINGS_OFFSET(opentherm.options.setDateAndTime), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_ALWAYS_SEND_INDOOR_TEMP}, SETTINGS_OFFSET(opentherm.options.alwaysSendIndoorTemp), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_OPENTHERM, S_OPTIONS, S_NATIVE_OTC}, SETTINGS_OFFSET(opentherm.options.nativeOTC), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, onChangeNativeOtc},
+  {{S_OPENTHERM, S_OPTIONS, S_IMMERGAS_FIX}, SETTINGS_OFFSET(opentherm.options.immergasFix), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+
+  // mqtt
+  {{S_MQTT, S_ENABLED}, SETTINGS_OFFSET(mqtt.enabled), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_MQTT, S_SERVER}, SETTINGS_OFFSET(mqtt.server), SettingsFieldType::STRING, 0, sizeof(settings.mqtt.server), 0, 0, 1, nullptr},
+  {{S_MQTT, S_PORT}, SETTINGS_OFFSET(mqtt.port), SettingsFieldType::UINT16, 0, 0, 1, 65535, 1, nullptr},
+  {{S_MQTT, S_USER}, SETTINGS_OFFSET(mqtt.user), SettingsFieldType::STRING, 0, sizeof(settings.mqtt.user), 0, 0, 1, nullptr},
+  {{S_MQTT, S_PASSWORD}, SETTINGS_OFFSET(mqtt.password), SettingsFieldType::STRING, 0, sizeof(settings.mqtt.password), 0, 0, 1, nullptr},
+  {{S_MQTT, S_PREFIX}, SETTINGS_OFFSET(mqtt.prefix), SettingsFieldType::STRING, 0, sizeof(settings.mqtt.prefix), 0, 0, 1, nullptr},
+  {{S_MQTT, S_INTERVAL}, SETTINGS_OFFSET(mqtt.interval), SettingsFieldType::UINT16, 0, 0, 3, 60, 1, nullptr},
+  {{S_MQTT, S_HOME_ASSISTANT_DISCOVERY}, SETTINGS_OFFSET(mqtt.homeAssistantDiscovery), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+
+  // emergency
+  {{S_EMERGENCY, S_TARGET}, SETTINGS_OFFSET(emergency.target), SettingsFieldType::FLOAT, SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 2, 0, 0, 1, nullptr},
+  {{S_EMERGENCY, S_TRESHOLD_TIME}, SETTINGS_OFFSET(emergency.tresholdTime), SettingsFieldType::UINT16, 0, 0, 60, 1800, 1, nullptr},
+
+  // heating
+  {{S_HEATING, S_ENABLED}, SETTINGS_OFFSET(heating.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_HEATING, S_TURBO}, SETTINGS_OFFSET(heating.turbo), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_HEATING, S_TARGET}, SETTINGS_OFFSET(heating.target), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 2, 0, 0, 1, nullptr},
+  {{S_HEATING, S_HYSTERESIS, S_ENABLED}, SETTINGS_OFFSET(heating.hysteresis.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_HEATING, S_HYSTERESIS, S_VALUE}, SETTINGS_OFFSET(heating.hysteresis.value), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0, 15, 1, nullptr},
+  {{S_HEATING, S_HYSTERESIS, S_ACTION}, SETTINGS_OFFSET(heating.hysteresis.action), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_HEATING, S_TURBO_FACTOR}, SETTINGS_OFFSET(heating.turboFactor), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 1.5f, 10, 1, nullptr},
+  {{S_HEATING, S_MIN_TEMP}, SETTINGS_OFFSET(heating.minTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 0, 0, 0, 1, nullptr},
+  {{S_HEATING, S_MAX_TEMP}, SETTINGS_OFFSET(heating.maxTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 0, 0, 0, 1, nullptr},
+  {{S_HEATING, S_MAX_MODULATION}, SETTINGS_OFFSET(heating.maxModulation), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE, 0, 1, 100, 1, nullptr},
+  {{S_HEATING, S_OVERHEAT_PROTECTION, S_HIGH_TEMP}, SETTINGS_OFFSET(heating.overheatProtection.highTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP_RANGE, 0, 0, 100, 1, nullptr},
+  {{S_HEATING, S_OVERHEAT_PROTECTION, S_LOW_TEMP}, SETTINGS_OFFSET(heating.overheatProtection.lowTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP_RANGE, 0, 0, 99, 1, nullptr},
+  {{S_HEATING, S_FREEZE_PROTECTION, S_HIGH_TEMP}, SETTINGS_OFFSET(heating.freezeProtection.highTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP_RANGE, 0, 1, 50, 1, nullptr},
+  {{S_HEATING, S_FREEZE_PROTECTION, S_LOW_TEMP}, SETTINGS_OFFSET(heating.freezeProtection.lowTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP_RANGE, 0, 1, 30, 1, nullptr},
+  {{S_HEATING, S_ANTI_CYCLING, S_ENABLED}, SETTINGS_OFFSET(heating.antiCycling.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_HEATING, S_ANTI_CYCLING, S_MAX_CYCLES}, SETTINGS_OFFSET(heating.antiCycling.maxCycles), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE, 0, 1, 20, 1, nullptr},
+  {{S_HEATING, S_ANTI_CYCLING, S_MIN_ON_TIME}, SETTINGS_OFFSET(heating.antiCycling.minOnTime), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE, 0, 0, 30, 1, nullptr},
+  {{S_HEATING, S_ANTI_CYCLING, S_MIN_OFF_TIME}, SETTINGS_OFFSET(heating.antiCycling.minOffTime), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE, 0, 1, 60, 1, nullptr},
+  {{S_HEATING, S_SCHEDULE, S_ENABLED}, SETTINGS_OFFSET(heating.schedule.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_HEATING, S_SCHEDULE, S_OPTIMUM_START}, SETTINGS_OFFSET(heating.schedule.optimumStart), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_HEATING, S_SCHEDULE, S_MAX_PREHEAT_TIME}, SETTINGS_OFFSET(heating.schedule.maxPreheatTime), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE, 0, 1, 12, 1, nullptr},
+
+  // dhw
+  {{S_DHW, S_ENABLED}, SETTINGS_OFFSET(dhw.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_DHW, S_TARGET}, SETTINGS_OFFSET(dhw.target), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 1, 0, 0, 1, nullptr},
+  {{S_DHW, S_MIN_TEMP}, SETTINGS_OFFSET(dhw.minTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 0, 0, 0, 1, nullptr},
+  {{S_DHW, S_MAX_TEMP}, SETTINGS_OFFSET(dhw.maxTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 0, 0, 0, 1, nullptr},
+  {{S_DHW, S_MAX_MODULATION}, SETTINGS_OFFSET(dhw.maxModulation), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE, 0, 1, 100, 1, nullptr},
+  {{S_DHW, S_OVERHEAT_PROTECTION, S_HIGH_TEMP}, SETTINGS_OFFSET(dhw.overheatProtection.highTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP_RANGE, 0, 0, 100, 1, nullptr},
+  {{S_DHW, S_OVERHEAT_PROTECTION, S_LOW_TEMP}, SETTINGS_OFFSET(dhw.overheatProtection.lowTemp), SettingsFieldType::UINT8, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP_RANGE, 0, 0, 99, 1, nullptr},
+
+  // equitherm
+  {{S_EQUITHERM, S_ENABLED}, SETTINGS_OFFSET(equitherm.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_MANUAL, 0, 0, 1, 1, nullptr},
+  {{S_EQUITHERM, S_SLOPE}, SETTINGS_OFFSET(equitherm.slope), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0.001f, 10, 1, nullptr},
+  {{S_EQUITHERM, S_EXPONENT}, SETTINGS_OFFSET(equitherm.exponent), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0.001f, 2, 1, nullptr},
+  {{S_EQUITHERM, S_SHIFT}, SETTINGS_OFFSET(equitherm.shift), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 2, -15, 15, 1, nullptr},
+  {{S_EQUITHERM, S_TARGET_DIFF_FACTOR}, SETTINGS_OFFSET(equitherm.targetDiffFactor), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0, 10, 1, nullptr},
+  {{S_EQUITHERM, S_LEARNING, S_ENABLED}, SETTINGS_OFFSET(equitherm.learning.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_EQUITHERM, S_LEARNING, S_AUTO_APPLY}, SETTINGS_OFFSET(equitherm.learning.autoApply), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+
+  // pid
+  {{S_PID, S_ENABLED}, SETTINGS_OFFSET(pid.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_MANUAL, 0, 0, 1, 1, nullptr},
+  {{S_PID, S_P_FACTOR}, SETTINGS_OFFSET(pid.p_factor), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0.001f, 1000, 1, nullptr},
+  {{S_PID, S_I_FACTOR}, SETTINGS_OFFSET(pid.i_factor), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 4, 0, 100, 1, nullptr},
+  {{S_PID, S_D_FACTOR}, SETTINGS_OFFSET(pid.d_factor), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 1, 0, 100000, 1, nullptr},
+  {{S_PID, S_DT}, SETTINGS_OFFSET(pid.dt), SettingsFieldType::UINT16, SETTINGS_FIELD_SAFE, 0, 30, 1800, 1, nullptr},
+  {{S_PID, S_MIN_TEMP}, SETTINGS_OFFSET(pid.minTemp), SettingsFieldType::INT16, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_MANUAL, 0, 0, 0, 1, nullptr},
+  {{S_PID, S_MAX_TEMP}, SETTINGS_OFFSET(pid.maxTemp), SettingsFieldType::INT16, SETTINGS_FIELD_SAFE | SETTINGS_FIELD_TEMP | SETTINGS_FIELD_TEMP_RANGE, 0, 0.1f, 99.9f, 1, nullptr},
+  {{S_PID, S_DEADBAND, S_ENABLED}, SETTINGS_OFFSET(pid.deadband.enabled), SettingsFieldType::BOOL, SETTINGS_FIELD_SAFE, 0, 0, 1, 1, nullptr},
+  {{S_PID, S_DEADBAND, S_P_MULTIPLIER}, SETTINGS_OFFSET(pid.deadband.p_multiplier), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0, 1, 1, nullptr},
+  {{S_PID, S_DEADBAND, S_I_MULTIPLIER}, SETTINGS_OFFSET(pid.deadband.i_multiplier), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0, 1, 1, nullptr},
+  {{S_PID, S_DEADBAND, S_D_MULTIPLIER}, SETTINGS_OFFSET(pid.deadband.d_multiplier), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 3, 0, 1, 1, nullptr},
+  {{S_PID, S_DEADBAND, S_THRESHOLD_HIGH}, SETTINGS_OFFSET(pid.deadband.thresholdHigh), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 2, 0, 5, 1, nullptr},
+  {{S_PID, S_DEADBAND, S_THRESHOLD_LOW}, SETTINGS_OFFSET(pid.deadband.thresholdLow), SettingsFieldType::FLOAT, SETTINGS_FIELD_SAFE, 2, 0, 5, 1, nullptr},
+
+  // external pump, times in minutes and days
+  {{S_EXTERNAL_PUMP, S_USE}, SETTINGS_OFFSET(externalPump.use), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_EXTERNAL_PUMP, S_GPIO}, SETTINGS_OFFSET(externalPump.gpio), SettingsFieldType::GPIO, 0, 0, 0, 0, 1, nullptr},
+  {{S_EXTERNAL_PUMP, S_INVERT_STATE}, SETTINGS_OFFSET(externalPump.invertState), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_EXTERNAL_PUMP, S_POST_CIRCULATION_TIME}, SETTINGS_OFFSET(externalPump.postCirculationTime), SettingsFieldType::UINT16, 0, 0, 0, 120, 60, nullptr},
+  {{S_EXTERNAL_PUMP, S_ANTI_STUCK_INTERVAL}, SETTINGS_OFFSET(externalPump.antiStuckInterval), SettingsFieldType::UINT32, 0, 0, 0, 366, 86400, nullptr},
+  {{S_EXTERNAL_PUMP, S_ANTI_STUCK_TIME}, SETTINGS_OFFSET(externalPump.antiStuckTime), SettingsFieldType::UINT16, 0, 0, 0, 20, 60, nullptr},
+
+  // cascade control
+  {{S_CASCADE_CONTROL, S_INPUT, S_ENABLED}, SETTINGS_OFFSET(cascadeControl.input.enabled), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_INPUT, S_GPIO}, SETTINGS_OFFSET(cascadeControl.input.gpio), SettingsFieldType::GPIO, 0, 0, 0, 0, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_INPUT, S_INVERT_STATE}, SETTINGS_OFFSET(cascadeControl.input.invertState), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_INPUT, S_THRESHOLD_TIME}, SETTINGS_OFFSET(cascadeControl.input.thresholdTime), SettingsFieldType::UINT16, 0, 0, 5, 600, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_OUTPUT, S_ENABLED}, SETTINGS_OFFSET(cascadeControl.output.enabled), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_OUTPUT, S_GPIO}, SETTINGS_OFFSET(cascadeControl.output.gpio), SettingsFieldType::GPIO, 0, 0, 0, 0, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_OUTPUT, S_INVERT_STATE}, SETTINGS_OFFSET(cascadeControl.output.invertState), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_OUTPUT, S_THRESHOLD_TIME}, SETTINGS_OFFSET(cascadeControl.output.thresholdTime), SettingsFieldType::UINT16, 0, 0, 5, 600, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_OUTPUT, S_ON_FAULT}, SETTINGS_OFFSET(cascadeControl.output.onFault), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_OUTPUT, S_ON_LOSS_CONNECTION}, SETTINGS_OFFSET(cascadeControl.output.onLossConnection), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr},
+  {{S_CASCADE_CONTROL, S_OUTPUT, S_ON_ENABLED_HEATING}, SETTINGS_OFFSET(cascadeControl.output.onEnabledHeating), SettingsFieldType::BOOL, 0, 0, 0, 1, 1, nullptr}
+};
+
+const uint8_t settingsFieldsAmount = sizeof(settingsFields) / sizeof(*settingsFields);
+
+inline void getSettingsField(uint8_t index, SettingsField& dst) {
+  memcpy_P(&dst, &settingsFields[index], sizeof(SettingsField));
+}
+
+inline uint8_t getSettingsFieldDepth(const SettingsField& field) {
+  return field.path[2] != nullptr ? 3 : (field.path[1] != nullptr ? 2 : 1);
+}
+
+/**
+ * Upper bound of the compact json written by settingsToJson(),
+ * with every string at its max length and every char escaped as \u00XX.
+ */
+size_t getSettingsJsonMaxSize() {
+  const char* parentKeys[2] = {nullptr, nullptr};
+  SettingsField field;
+  // root braces
+  size_t result = 2;
+
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    getSettingsField(i, field);
+    const uint8_t depth = getSettingsFieldDepth(field);
+
+    // ,"key":{}
+    for (uint8_t level = 0; level < depth - 1; level++) {
+      if (parentKeys[level] != field.path[level]) {
+        parentKeys[level] = field.path[level];
+        result += strlen_P(field.path[level]) + 6;
+
+        if (level == 0) {
+          parentKeys[1] = nullptr;
+        }
+      }
+    }
+
+    // ,"key":value
+    result += strlen_P(field.path[depth - 1]) + 4;
+
+    switch (field.type) {
+      case SettingsFieldType::BOOL:
+        result += 5;
+        break;
+
+      case SettingsFieldType::UINT8:
+      case SettingsFieldType::GPIO:
+        result += 3;
+        break;
+
+      case SettingsFieldType::UINT16:
+        result += 5;
+        break;
+
+      case SettingsFieldType::UINT32:
+        result += 10;
+        break;
+
+      case SettingsFieldType::INT16:
+        result += 6;
+        break;
+
+      case SettingsFieldType::FLOAT:
+        // -1.23456789e+38
+        result += 15;
+        break;
+
+      case SettingsFieldType::STRING:
+        result += (field.size - 1) * 6 + 2;
+        break;
+    }
+  }
+
+  return result;
+}
+
+
+// change groups, every task reacts only to the groups it depends on
+#define SETTINGS_CHANGE_SYSTEM            (1ul << 0)
+#define SETTINGS_CHANGE_NTP               (1ul << 1)
+#define SETTINGS_CHANGE_UNIT_SYSTEM       (1ul << 2)
+#define SETTINGS_CHANGE_PORTAL            (1ul << 3)
+#define SETTINGS_CHANGE_OT_GPIO           (1ul << 4)
+#define SETTINGS_CHANGE_OT_MASTER         (1ul << 5)
+#define SETTINGS_CHANGE_OT                (1ul << 6)
+#define SETTINGS_CHANGE_MQTT_CONNECTION   (1ul << 7)
+#define SETTINGS_CHANGE_MQTT              (1ul << 8)
+#define SETTINGS_CHANGE_EMERGENCY         (1ul << 9)
+#define SETTINGS_CHANGE_HEATING           (1ul << 10)
+#define SETTINGS_CHANGE_DHW               (1ul << 11)
+#define SETTINGS_CHANGE_EQUITHERM         (1ul << 12)
+#define SETTINGS_CHANGE_PID               (1ul << 13)
+#define SETTINGS_CHANGE_EXTERNAL_PUMP     (1ul << 14)
+#define SETTINGS_CHANGE_CASCADE_CONTROL   (1ul << 15)
+
+uint32_t getSettingsFieldGroup(const SettingsField& field) {
+  const char* section = field.path[0];
+  const char* name = field.path[1];
+
+  if (section == S_SYSTEM) {
+    if (name == S_NTP) {
+      return SETTINGS_CHANGE_NTP;
+
+    } else if (name == S_UNIT_SYSTEM) {
+      return SETTINGS_CHANGE_UNIT_SYSTEM;
+    }
+
+    return SETTINGS_CHANGE_SYSTEM;
+
+  } else if (section == S_PORTAL) {
+    return SETTINGS_CHANGE_PORTAL;
+
+  } else if (section == S_OPENTHERM) {
+    if (name == S_IN_GPIO || name == S_OUT_GPIO) {
+      return SETTINGS_CHANGE_OT_GPIO;
+
+    } else if (name == S_MEMBER_ID || name == S_FLAGS) {
+      return SETTINGS_CHANGE_OT_MASTER;
+    }
+
+    return SETTINGS_CHANGE_OT;
+
+  } else if (section == S_MQTT) {
+    if (name == S_SERVER || name == S_PORT || name == S_USER || name == S_PASSWORD || name == S_PREFIX) {
+      return SETTINGS_CHANGE_MQTT_CONNECTION;
+    }
+
+    return SETTINGS_CHANGE_MQTT;
+
+  } else if (section == S_EMERGENCY) {
+    return SETTINGS_CHANGE_EMERGENCY;
+
+  } else if (section == S_HEATING) {
+    return SETTINGS_CHANGE_HEATING;
+
+  } else if (section == S_DHW) {
+    return SETTINGS_CHANGE_DHW;
+
+  } else if (section == S_EQUITHERM) {
+    return SETTINGS_CHANGE_EQUITHERM;
+
+  } else if (section == S_PID) {
+    return SETTINGS_CHANGE_PID;
+
+  } else if (section == S_EXTERNAL_PUMP) {
+    return SETTINGS_CHANGE_EXTERNAL_PUMP;
+
+  } else if (section == S_CASCADE_CONTROL) {
+    return SETTINGS_CHANGE_CASCADE_CONTROL;
+  }
+
+  return 0;
+}
+
+inline uint8_t getSettingsFieldSize(const SettingsField& field) {
+  switch (field.type) {
+    case SettingsFieldType::UINT16:
+    case SettingsFieldType::INT16:
+      return 2;
+
+    case SettingsFieldType::UINT32:
+    case SettingsFieldType::FLOAT:
+      return 4;
+
+    case SettingsFieldType::STRING:
+      return field.size;
+
+    default:
+      return 1;
+  }
+}
+
+/**
+ * Changed fields (bit per table index) and their groups.
+ */
+struct SettingsChanges {
+  uint32_t fields[(settingsFieldsAmount + 31) / 32] = {};
+  uint32_t groups = 0;
+
+  inline bool any() const {
+    return this->groups != 0;
+  }
+
+  inline bool hasField(uint8_t index) const {
+    return this->fields[index / 32] & (1ul << (index % 32));
+  }
+
+  inline bool has(uint32_t groups) const {
+    return this->groups & groups;
+  }
+};
+
+void diffSettings(const Settings& prev, const Settings& current, SettingsChanges& dst) {
+  SettingsField field;
+
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    getSettingsField(i, field);
+
+    const uint8_t* prevValue = reinterpret_cast<const uint8_t*>(&prev) + field.offset;
+    const uint8_t* currentValue = reinterpret_cast<const uint8_t*>(&current) + field.offset;
+    const bool changed = field.type == SettingsFieldType::STRING
+      ? strncmp(reinterpret_cast<const char*>(prevValue), reinterpret_cast<const char*>(currentValue), field.size) != 0
+      : memcmp(prevValue, currentValue, getSettingsFieldSize(field)) != 0;
+
+    if (changed) {
+      dst.fields[i / 32] |= 1ul << (i % 32);
+      dst.groups |= getSettingsFieldGroup(field);
+    }
+  }
+}
+
+
+enum class SettingsSubscriber : uint8_t {
+  MAIN,
+  OPENTHERM,
+  MQTT,
+  REGULATOR
+};
+
+uint32_t settingsChangesQueue[4] = {};
+
+// the tasks are preempted on ESP32, a change published between the read and the reset
+// of a queue would be lost; the ESP8266 scheduler is cooperative
+#ifdef ARDUINO_ARCH_ESP32
+portMUX_TYPE settingsChangesMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+// delivers the changed groups to every subscriber
+inline void publishSettingsChanges(uint32_t groups) {
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&settingsChangesMux);
+  #endif
+
+  for (auto& queued : settingsChangesQueue) {
+    queued |= groups;
+  }
+
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&settingsChangesMux);
+  #endif
+}
+
+inline uint32_t takeSettingsChanges(SettingsSubscriber subscriber) {
+  uint32_t& queued = settingsChangesQueue[static_cast<uint8_t>(subscriber)];
+
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&settingsChangesMux);
+  #endif
+
+  const uint32_t result = queued;
+  queued = 0;
+
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&settingsChangesMux);
+  #endif
+
+  return result;
+}
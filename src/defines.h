@@ -2,8 +2,27 @@
 #define PROJECT_REPO                    "https://github.com/Laxilef/OTGateway"
 
 #define MQTT_RECONNECT_INTERVAL         15000
+#define MQTT_HA_DISCOVERY_MAX_MESSAGES  6     // per loop
+#define MQTT_HA_DISCOVERY_MAX_BYTES     3072  // per loop
+#define MQTT_HA_DISCOVERY_MIN_TX_SPACE  1024
+#define MQTT_QUEUE_MAX_ITEMS            (SENSORS_AMOUNT + 8)
+#define MQTT_QUEUE_MAX_BYTES            12288
+#define MQTT_QUEUE_MAX_MESSAGES         32    // per loop
+#define MQTT_RETRANSMIT_WINDOW          15000
+#define MQTT_SPOOL_PATH                 "/mqtt.spool"
+#define MQTT_SPOOL_MAX_SIZE             16384
+#define MQTT_COMMAND_BUFFER_SIZE        2048
+
+#define PORTAL_EVENTS_MAX_CLIENTS       2
+#define PORTAL_EVENTS_INTERVAL          1000
+#define PORTAL_EVENTS_PING_INTERVAL     15000
+#define PORTAL_MAX_REQUESTS_PER_LOOP    4
+#define PORTAL_RESTORE_MAX_SECTION_SIZE 2560  // at least, settings: getSettingsJsonMaxSize()
+#define PORTAL_UPGRADE_RESUME_TIMEOUT   300000
 #define CONFIG_URL                      "http://%s/"
 #define SETTINGS_VALID_VALUE            "stvalid" // only 8 chars!
+#define SETTINGS_VERSION                4 // see SettingsMigrations.h
+#define SCHEDULE_SETTINGS_VERSION       1 // see SettingsMigrations.h
 #define GPIO_IS_NOT_CONFIGURED          0xff
 
 #define DEFAULT_HEATING_TARGET_TEMP     40
@@ -34,6 +53,10 @@
   #define BUILD_ENV                     "undefined"
 #endif
 
+#ifndef MQTT_QOS
+  #define MQTT_QOS                      0
+#endif
+
 #ifndef DEFAULT_SERIAL_ENABLED
   #define DEFAULT_SERIAL_ENABLED true
 #endif
@@ -142,10 +165,75 @@
   #define SENSORS_AMOUNT 20
 #endif
 
+#ifndef SCHEDULE_MAX_BLOCKS
+  #define SCHEDULE_MAX_BLOCKS 16
+#endif
+
 #ifndef DEFAULT_EXT_PUMP_GPIO
   #define DEFAULT_EXT_PUMP_GPIO GPIO_IS_NOT_CONFIGURED
 #endif
 
+// relay experiment of the PID auto-tune
+#ifndef PID_AUTOTUNE_HYSTERESIS
+  #define PID_AUTOTUNE_HYSTERESIS 0.1f
+#endif
+
+#ifndef PID_AUTOTUNE_MAX_CYCLES
+  #define PID_AUTOTUNE_MAX_CYCLES 10
+#endif
+
+#ifndef PID_AUTOTUNE_TIMEOUT
+  #define PID_AUTOTUNE_TIMEOUT 86400
+#endif
+
+// online fit of the equitherm curve, bounds of the applied values
+#ifndef EQUITHERM_LEARNING_WINDOW
+  #define EQUITHERM_LEARNING_WINDOW 3600
+#endif
+
+#ifndef EQUITHERM_LEARNING_MIN_SAMPLES
+  #define EQUITHERM_LEARNING_MIN_SAMPLES 24
+#endif
+
+#ifndef EQUITHERM_LEARNING_MIN_SLOPE
+  #define EQUITHERM_LEARNING_MIN_SLOPE 0.1f
+#endif
+
+#ifndef EQUITHERM_LEARNING_MAX_SLOPE
+  #define EQUITHERM_LEARNING_MAX_SLOPE 5.0f
+#endif
+
+#ifndef EQUITHERM_LEARNING_MAX_SHIFT
+  #define EQUITHERM_LEARNING_MAX_SHIFT 10.0f
+#endif
+
+#ifndef EQUITHERM_LEARNING_SLOPE_STEP
+  #define EQUITHERM_LEARNING_SLOPE_STEP 0.02f
+#endif
+
+#ifndef EQUITHERM_LEARNING_SHIFT_STEP
+  #define EQUITHERM_LEARNING_SHIFT_STEP 0.2f
+#endif
+
+// the regulator runs when its inputs change, but not more often than the min interval
+// and at least once per the max interval, in ms
+#ifndef REGULATOR_MIN_INTERVAL
+  #define REGULATOR_MIN_INTERVAL 1000
+#endif
+
+#ifndef REGULATOR_MAX_INTERVAL
+  #define REGULATOR_MAX_INTERVAL 30000
+#endif
+
+// chips without FPU evaluate the heat curve in fixed point
+#ifndef REGULATOR_FIXED_POINT
+  #if defined(ARDUINO_ARCH_ESP8266) || CONFIG_IDF_TARGET_ESP32C2 || CONFIG_IDF_TARGET_ESP32C3 || CONFIG_IDF_TARGET_ESP32C6 || CONFIG_IDF_TARGET_ESP32S2
+    #define REGULATOR_FIXED_POINT true
+  #else
+    #define REGULATOR_FIXED_POINT false
+  #endif
+#endif
+
 #ifndef PROGMEM
   #define PROGMEM 
 #endif
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <FileData.h>
+#include <JournalData.h>
 #include <LittleFS.h>
 #include <ESPTelnetStream.h>
 
@@ -15,6 +16,8 @@
 #include "CrashRecorder.h"
 #include "Sensors.h"
 #include "Settings.h"
+#include "SettingsSchema.h"
+#include "SettingsMigrations.h"
 #include "utils.h"
 
 #if defined(ARDUINO_ARCH_ESP32)
@@ -42,8 +45,9 @@ NetworkMgr* network = nullptr;
 Sensors::Result sensorsResults[SENSORS_AMOUNT];
 
 FileData fsNetworkSettings(&LittleFS, "/network.conf", 'n', &networkSettings, sizeof(networkSettings), 1000);
-FileData fsSettings(&LittleFS, "/settings.conf", 's', &settings, sizeof(settings), 60000);
-FileData fsSensorsSettings(&LittleFS, "/sensors.conf", 'e', &sensorsSettings, sizeof(sensorsSettings), 60000);
+JournalData fsSettings(&LittleFS, "/settings.conf", 's', &settings, sizeof(settings), 60000);
+JournalData fsSensorsSettings(&LittleFS, "/sensors.conf", 'e', &sensorsSettings, sizeof(sensorsSettings), 60000);
+JournalData fsScheduleSettings(&LittleFS, "/schedule.conf", 'h', &scheduleSettings, sizeof(scheduleSettings), 60000);
 
 // Tasks
 MqttTask* tMqtt;
@@ -129,26 +133,29 @@ void setup() {
 
   //
   // Settings
+  fsSettings.setVersion(SETTINGS_VERSION)->setMigrateCallback(migrateSettings);
   switch (fsSettings.read()) {
-    case FD_FS_ERR:
+    case JournalData::Status::FS_ERROR:
       Log.swarningln(FPSTR(L_SETTINGS), F("Filesystem error, load default"));
       break;
-    case FD_FILE_ERR:
+    case JournalData::Status::CORRUPTED:
       Log.swarningln(FPSTR(L_SETTINGS), F("Bad data, load default"));
       break;
-    case FD_WRITE:
+    case JournalData::Status::NEWER_VERSION:
+      Log.swarningln(FPSTR(L_SETTINGS), F("Saved by a newer firmware, load default"));
+      break;
+    case JournalData::Status::WRITE_ERROR:
+      Log.swarningln(FPSTR(L_SETTINGS), F("Loaded, but failed to compact"));
+      break;
+    case JournalData::Status::NOT_FOUND:
       Log.sinfoln(FPSTR(L_SETTINGS), F("Not found, load default"));
       break;
-    case FD_ADD:
-    case FD_READ:
+    case JournalData::Status::MIGRATED:
+      Log.sinfoln(FPSTR(L_SETTINGS), F("Migrated from version %hu to %hu"), fsSettings.getLoadedVersion(), SETTINGS_VERSION);
+      break;
+    case JournalData::Status::RESIZED:
+    case JournalData::Status::LOADED:
       Log.sinfoln(FPSTR(L_SETTINGS), F("Loaded"));
-
-      if (strcmp(SETTINGS_VALID_VALUE, settings.validationValue) != 0) {
-        Log.swarningln(FPSTR(L_SETTINGS), F("Not valid, set default and restart..."));
-        fsSettings.reset();
-        ::delay(5000);
-        ESP.restart();
-      }
       break;
     default:
       break;
@@ -186,22 +193,54 @@ void setup() {
   //
   // Sensors settings
   switch (fsSensorsSettings.read()) {
-    case FD_FS_ERR:
+    case JournalData::Status::FS_ERROR:
       Log.swarningln(FPSTR(L_SENSORS), F("Filesystem error, load default"));
       break;
-    case FD_FILE_ERR:
+    case JournalData::Status::CORRUPTED:
       Log.swarningln(FPSTR(L_SENSORS), F("Bad data, load default"));
       break;
-    case FD_WRITE:
+    case JournalData::Status::WRITE_ERROR:
+      Log.swarningln(FPSTR(L_SENSORS), F("Loaded, but failed to compact"));
+      break;
+    case JournalData::Status::NOT_FOUND:
       Log.sinfoln(FPSTR(L_SENSORS), F("Not found, load default"));
       break;
-    case FD_ADD:
-    case FD_READ:
+    case JournalData::Status::RESIZED:
+    case JournalData::Status::LOADED:
       Log.sinfoln(FPSTR(L_SENSORS), F("Loaded"));
     default:
       break;
   }
 
+  //
+  // Schedule settings
+  fsScheduleSettings.setVersion(SCHEDULE_SETTINGS_VERSION)->setMigrateCallback(migrateScheduleSettings);
+  switch (fsScheduleSettings.read()) {
+    case JournalData::Status::FS_ERROR:
+      Log.swarningln(FPSTR(L_SCHEDULE_SETTINGS), F("Filesystem error, load default"));
+      break;
+    case JournalData::Status::CORRUPTED:
+      Log.swarningln(FPSTR(L_SCHEDULE_SETTINGS), F("Bad data, load default"));
+      break;
+    case JournalData::Status::NEWER_VERSION:
+      Log.swarningln(FPSTR(L_SCHEDULE_SETTINGS), F("Saved by a newer firmware, load default"));
+      break;
+    case JournalData::Status::WRITE_ERROR:
+      Log.swarningln(FPSTR(L_SCHEDULE_SETTINGS), F("Loaded, but failed to compact"));
+      break;
+    case JournalData::Status::NOT_FOUND:
+      Log.sinfoln(FPSTR(L_SCHEDULE_SETTINGS), F("Not found, load default"));
+      break;
+    case JournalData::Status::MIGRATED:
+      Log.sinfoln(FPSTR(L_SCHEDULE_SETTINGS), F("Migrated from version %hu to %hu"), fsScheduleSettings.getLoadedVersion(), SCHEDULE_SETTINGS_VERSION);
+      break;
+    case JournalData::Status::RESIZED:
+    case JournalData::Status::LOADED:
+      Log.sinfoln(FPSTR(L_SCHEDULE_SETTINGS), F("Loaded"));
+    default:
+      break;
+  }
+
   //
   // Make tasks
   tMqtt = new MqttTask(false, 500);
@@ -213,7 +252,7 @@ void setup() {
   tSensors = new SensorsTask(true, 1000);
   Scheduler.start(tSensors);
 
-  tRegulator = new RegulatorTask(true, 10000);
+  tRegulator = new RegulatorTask(true, REGULATOR_MIN_INTERVAL);
   Scheduler.start(tRegulator);
 
   tPortal = new PortalTask(true, 0);
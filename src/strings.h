@@ -29,6 +29,8 @@ const char L_SENSORS_BLE[]                          PROGMEM = "SENSORS.BLE";
 const char L_REGULATOR[]                            PROGMEM = "REGULATOR";
 const char L_REGULATOR_PID[]                        PROGMEM = "REGULATOR.PID";
 const char L_REGULATOR_EQUITHERM[]                  PROGMEM = "REGULATOR.EQUITHERM";
+const char L_SCHEDULE[]                             PROGMEM = "SCHEDULE";
+const char L_SCHEDULE_SETTINGS[]                    PROGMEM = "SCHEDULE.SETTINGS";
 const char L_CASCADE_INPUT[]                        PROGMEM = "CASCADE.INPUT";
 const char L_CASCADE_OUTPUT[]                       PROGMEM = "CASCADE.OUTPUT";
 const char L_EXTPUMP[]                              PROGMEM = "EXTPUMP";
@@ -38,23 +40,31 @@ const char S_ACTION[]                               PROGMEM = "action";
 const char S_ACTIONS[]                              PROGMEM = "actions";
 const char S_ACTIVE[]                               PROGMEM = "active";
 const char S_ADDRESS[]                              PROGMEM = "address";
+const char S_ANTI_CYCLING[]                         PROGMEM = "antiCycling";
 const char S_ANTI_STUCK_INTERVAL[]                  PROGMEM = "antiStuckInterval";
 const char S_ANTI_STUCK_TIME[]                      PROGMEM = "antiStuckTime";
 const char S_AP[]                                   PROGMEM = "ap";
 const char S_APP_VERSION[]                          PROGMEM = "appVersion";
+const char S_APPLY_EQUITHERM_LEARNING[]             PROGMEM = "applyEquithermLearning";
+const char S_APPLY_PID_AUTOTUNE[]                   PROGMEM = "applyPidAutotune";
 const char S_AUTH[]                                 PROGMEM = "auth";
+const char S_AUTO_APPLY[]                           PROGMEM = "autoApply";
 const char S_AUTO_DIAG_RESET[]                      PROGMEM = "autoDiagReset";
 const char S_AUTO_FAULT_RESET[]                     PROGMEM = "autoFaultReset";
 const char S_BACKTRACE[]                            PROGMEM = "backtrace";
+const char S_BASE[]                                 PROGMEM = "base";
 const char S_BATTERY[]                              PROGMEM = "battery";
 const char S_BAUDRATE[]                             PROGMEM = "baudrate";
+const char S_BLOCK[]                                PROGMEM = "block";
 const char S_BLOCKING[]                             PROGMEM = "blocking";
+const char S_BLOCKS[]                               PROGMEM = "blocks";
 const char S_BSSID[]                                PROGMEM = "bssid";
 const char S_BUILD[]                                PROGMEM = "build";
 const char S_CASCADE_CONTROL[]                      PROGMEM = "cascadeControl";
 const char S_CHANNEL[]                              PROGMEM = "channel";
 const char S_CH2_ALWAYS_ENABLED[]                   PROGMEM = "ch2AlwaysEnabled";
 const char S_CHIP[]                                 PROGMEM = "chip";
+const char S_CHUNKS[]                               PROGMEM = "chunks";
 const char S_CODE[]                                 PROGMEM = "code";
 const char S_CONNECTED[]                            PROGMEM = "connected";
 const char S_CONTINUES[]                            PROGMEM = "continues";
@@ -64,8 +74,10 @@ const char S_CORE[]                                 PROGMEM = "core";
 const char S_CORES[]                                PROGMEM = "cores";
 const char S_CRASH[]                                PROGMEM = "crash";
 const char S_CURRENT_TEMP[]                         PROGMEM = "currentTemp";
+const char S_CYCLES[]                               PROGMEM = "cycles";
 const char S_DATA[]                                 PROGMEM = "data";
 const char S_DATE[]                                 PROGMEM = "date";
+const char S_DAYS[]                                 PROGMEM = "days";
 const char S_DEADBAND[]                             PROGMEM = "deadband";
 const char S_DHW[]                                  PROGMEM = "dhw";
 const char S_DHW_BLOCKING[]                         PROGMEM = "dhwBlocking";
@@ -73,6 +85,7 @@ const char S_DHW_STATE_AS_DHW_BLOCKING[]            PROGMEM = "dhwStateAsDhwBloc
 const char S_DHW_SUPPORT[]                          PROGMEM = "dhwSupport";
 const char S_DHW_TO_CH2[]                           PROGMEM = "dhwToCh2";
 const char S_DIAG[]                                 PROGMEM = "diag";
+const char S_DISCOVERY[]                            PROGMEM = "discovery";
 const char S_DNS[]                                  PROGMEM = "dns";
 const char S_DT[]                                   PROGMEM = "dt";
 const char S_D_FACTOR[]                             PROGMEM = "d_factor";
@@ -82,6 +95,7 @@ const char S_ENABLED[]                              PROGMEM = "enabled";
 const char S_ENV[]                                  PROGMEM = "env";
 const char S_EPC[]                                  PROGMEM = "epc";
 const char S_EQUITHERM[]                            PROGMEM = "equitherm";
+const char S_EQUITHERM_LEARNING[]                   PROGMEM = "equithermLearning";
 const char S_EXPONENT[]                             PROGMEM = "exponent";
 const char S_EXTERNAL_PUMP[]                        PROGMEM = "externalPump";
 const char S_FACTOR[]                               PROGMEM = "factor";
@@ -102,6 +116,8 @@ const char S_HEAP[]                                 PROGMEM = "heap";
 const char S_HEATING[]                              PROGMEM = "heating";
 const char S_HEATING_TO_CH2[]                       PROGMEM = "heatingToCh2";
 const char S_HEATING_STATE_TO_SUMMER_WINTER_MODE[]  PROGMEM = "heatingStateToSummerWinterMode";
+const char S_HEAT_UP[]                              PROGMEM = "heatUp";
+const char S_HEAT_UP_RATE[]                         PROGMEM = "heatUpRate";
 const char S_HIDDEN[]                               PROGMEM = "hidden";
 const char S_HIGH_TEMP[]                            PROGMEM = "highTemp";
 const char S_HOME_ASSISTANT_DISCOVERY[]             PROGMEM = "homeAssistantDiscovery";
@@ -121,15 +137,21 @@ const char S_INVERT_STATE[]                         PROGMEM = "invertState";
 const char S_IP[]                                   PROGMEM = "ip";
 const char S_I_FACTOR[]                             PROGMEM = "i_factor";
 const char S_I_MULTIPLIER[]                         PROGMEM = "i_multiplier";
+const char S_LAST_ON_TIME[]                         PROGMEM = "lastOnTime";
+const char S_LEARNING[]                             PROGMEM = "learning";
+const char S_LOCKOUT[]                              PROGMEM = "lockout";
 const char S_LOGIN[]                                PROGMEM = "login";
 const char S_LOG_LEVEL[]                            PROGMEM = "logLevel";
+const char S_LOSS[]                                 PROGMEM = "loss";
 const char S_LOW_TEMP[]                             PROGMEM = "lowTemp";
 const char S_MAC[]                                  PROGMEM = "mac";
 const char S_MASTER[]                               PROGMEM = "master";
 const char S_MAX[]                                  PROGMEM = "max";
+const char S_MAX_CYCLES[]                           PROGMEM = "maxCycles";
 const char S_MAX_FREE_BLOCK[]                       PROGMEM = "maxFreeBlock";
 const char S_MAX_MODULATION[]                       PROGMEM = "maxModulation";
 const char S_MAX_POWER[]                            PROGMEM = "maxPower";
+const char S_MAX_PREHEAT_TIME[]                     PROGMEM = "maxPreheatTime";
 const char S_MAX_TEMP[]                             PROGMEM = "maxTemp";
 const char S_MAX_TEMP_SYNC_WITH_TARGET_TEMP[]       PROGMEM = "maxTempSyncWithTargetTemp";
 const char S_MDNS[]                                 PROGMEM = "mdns";
@@ -137,6 +159,8 @@ const char S_MEMBER_ID[]                            PROGMEM = "memberId";
 const char S_MIN[]                                  PROGMEM = "min";
 const char S_MIN_FREE[]                             PROGMEM = "minFree";
 const char S_MIN_MAX_FREE_BLOCK[]                   PROGMEM = "minMaxFreeBlock";
+const char S_MIN_OFF_TIME[]                         PROGMEM = "minOffTime";
+const char S_MIN_ON_TIME[]                          PROGMEM = "minOnTime";
 const char S_MIN_POWER[]                            PROGMEM = "minPower";
 const char S_MIN_TEMP[]                             PROGMEM = "minTemp";
 const char S_MODEL[]                                PROGMEM = "model";
@@ -145,12 +169,15 @@ const char S_MQTT[]                                 PROGMEM = "mqtt";
 const char S_NAME[]                                 PROGMEM = "name";
 const char S_NATIVE_OTC[]                           PROGMEM = "nativeOTC";
 const char S_NETWORK[]                              PROGMEM = "network";
+const char S_NEXT_TARGET[]                          PROGMEM = "nextTarget";
+const char S_NEXT_TIME[]                            PROGMEM = "nextTime";
 const char S_NTP[]                                  PROGMEM = "ntp";
 const char S_OFFSET[]                               PROGMEM = "offset";
 const char S_ON_ENABLED_HEATING[]                   PROGMEM = "onEnabledHeating";
 const char S_ON_FAULT[]                             PROGMEM = "onFault";
 const char S_ON_LOSS_CONNECTION[]                   PROGMEM = "onLossConnection";
 const char S_OPENTHERM[]                            PROGMEM = "opentherm";
+const char S_OPTIMUM_START[]                        PROGMEM = "optimumStart";
 const char S_OPTIONS[]                              PROGMEM = "options";
 const char S_OUTDOOR_TEMP[]                         PROGMEM = "outdoorTemp";
 const char S_OUT_GPIO[]                             PROGMEM = "outGpio";
@@ -159,11 +186,15 @@ const char S_OVERHEAT[]                             PROGMEM = "overheat";
 const char S_OVERHEAT_PROTECTION[]                  PROGMEM = "overheatProtection";
 const char S_PASSWORD[]                             PROGMEM = "password";
 const char S_PID[]                                  PROGMEM = "pid";
+const char S_PID_AUTOTUNE[]                         PROGMEM = "pidAutotune";
 const char S_PORT[]                                 PROGMEM = "port";
 const char S_PORTAL[]                               PROGMEM = "portal";
 const char S_POST_CIRCULATION_TIME[]                PROGMEM = "postCirculationTime";
 const char S_POWER[]                                PROGMEM = "power";
 const char S_PREFIX[]                               PROGMEM = "prefix";
+const char S_PREHEAT[]                              PROGMEM = "preheat";
+const char S_PREHEAT_TIME[]                         PROGMEM = "preheatTime";
+const char S_PROGRESS[]                             PROGMEM = "progress";
 const char S_PROTOCOL_VERSION[]                     PROGMEM = "protocolVersion";
 const char S_PURPOSE[]                              PROGMEM = "purpose";
 const char S_P_FACTOR[]                             PROGMEM = "p_factor";
@@ -177,7 +208,10 @@ const char S_RESTART[]                              PROGMEM = "restart";
 const char S_RETURN_TEMP[]                          PROGMEM = "returnTemp";
 const char S_REV[]                                  PROGMEM = "rev";
 const char S_RSSI[]                                 PROGMEM = "rssi";
+const char S_RUNNING[]                              PROGMEM = "running";
 const char S_RX_LED_GPIO[]                          PROGMEM = "rxLedGpio";
+const char S_SAMPLES[]                              PROGMEM = "samples";
+const char S_SCHEDULE[]                             PROGMEM = "schedule";
 const char S_SDK[]                                  PROGMEM = "sdk";
 const char S_SENSORS[]                              PROGMEM = "sensors";
 const char S_SERIAL[]                               PROGMEM = "serial";
@@ -191,9 +225,12 @@ const char S_SLAVE[]                                PROGMEM = "slave";
 const char S_SLOPE[]                                PROGMEM = "slope";
 const char S_SSID[]                                 PROGMEM = "ssid";
 const char S_STA[]                                  PROGMEM = "sta";
+const char S_START[]                                PROGMEM = "start";
+const char S_START_PID_AUTOTUNE[]                   PROGMEM = "startPidAutotune";
 const char S_STATE[]                                PROGMEM = "state";
 const char S_STATIC_CONFIG[]                        PROGMEM = "staticConfig";
 const char S_STATUS_LED_GPIO[]                      PROGMEM = "statusLedGpio";
+const char S_STOP_PID_AUTOTUNE[]                    PROGMEM = "stopPidAutotune";
 const char S_SETPOINT[]                             PROGMEM = "setpoint";
 const char S_SETPOINT_TEMP[]                        PROGMEM = "setpointTemp";
 const char S_SUBNET[]                               PROGMEM = "subnet";
@@ -213,6 +250,8 @@ const char S_TRESHOLD_TIME[]                        PROGMEM = "tresholdTime";
 const char S_TURBO[]                                PROGMEM = "turbo";
 const char S_TURBO_FACTOR[]                         PROGMEM = "turboFactor";
 const char S_TYPE[]                                 PROGMEM = "type";
+const char S_ULTIMATE_GAIN[]                        PROGMEM = "ultimateGain";
+const char S_ULTIMATE_PERIOD[]                      PROGMEM = "ultimatePeriod";
 const char S_UNIT_SYSTEM[]                          PROGMEM = "unitSystem";
 const char S_UPTIME[]                               PROGMEM = "uptime";
 const char S_USE[]                                  PROGMEM = "use";
@@ -220,3 +259,4 @@ const char S_USE_DHCP[]                             PROGMEM = "useDhcp";
 const char S_USER[]                                 PROGMEM = "user";
 const char S_VALUE[]                                PROGMEM = "value";
 const char S_VERSION[]                              PROGMEM = "version";
+const char S_WRITTEN[]                              PROGMEM = "written";
@@ -204,6 +204,68 @@ inline uint8_t getHeapFrag() {
   return 100 - getMaxFreeBlockHeap() * 100.0 / getFreeHeap();
 }
 
+// loop duration of a task, in microseconds
+class LoopStats {
+public:
+  unsigned long count = 0;
+  unsigned long lastTime = 0;
+  unsigned long maxTime = 0;
+
+  class Guard {
+  public:
+    Guard(LoopStats& stats) : stats(stats), startTime(micros()) {}
+
+    ~Guard() {
+      const unsigned long time = micros() - this->startTime;
+
+      this->stats.count++;
+      this->stats.lastTime = time;
+      if (time > this->stats.maxTime) {
+        this->stats.maxTime = time;
+      }
+    }
+
+  protected:
+    LoopStats& stats;
+    unsigned long startTime;
+  };
+
+  LoopStats(const char* name) {
+    this->name = name;
+    this->next = first();
+    first() = this;
+  }
+
+  LoopStats(const LoopStats&) = delete;
+
+  ~LoopStats() {
+    for (LoopStats** item = &first(); *item != nullptr; item = &(*item)->next) {
+      if (*item == this) {
+        *item = this->next;
+        break;
+      }
+    }
+  }
+
+  inline const char* getName() const {
+    return this->name;
+  }
+
+  inline const LoopStats* getNext() const {
+    return this->next;
+  }
+
+  // all registered tasks
+  static LoopStats*& first() {
+    static LoopStats* value = nullptr;
+    return value;
+  }
+
+protected:
+  const char* name = nullptr;
+  LoopStats* next = nullptr;
+};
+
 String getResetReason() {
   String value;
 
@@ -280,6 +342,32 @@ void arr2str(String& str, T arr[], size_t length) {
   str.trim();
 }
 
+bool diffJson(const JsonVariantConst prev, const JsonVariantConst curr, JsonVariant dst) {
+  if (!curr.is<JsonObjectConst>()) {
+    return false;
+  }
+
+  bool changed = false;
+  for (JsonPairConst kv : curr.as<JsonObjectConst>()) {
+    auto prevValue = prev[kv.key()];
+
+    if (kv.value().is<JsonObjectConst>() && prevValue.is<JsonObjectConst>()) {
+      if (diffJson(prevValue, kv.value(), dst[kv.key()].to<JsonObject>())) {
+        changed = true;
+
+      } else {
+        dst.remove(kv.key());
+      }
+
+    } else if (prevValue.isNull() || prevValue != kv.value()) {
+      dst[kv.key()] = kv.value();
+      changed = true;
+    }
+  }
+
+  return changed;
+}
+
 void networkSettingsToJson(const NetworkSettings& src, JsonVariant dst) {
   dst[FPSTR(S_HOSTNAME)] = src.hostname;
 
@@ -416,960 +504,404 @@ bool jsonToNetworkSettings(const JsonVariantConst src, NetworkSettings& dst) {
   return changed;
 }
 
-void settingsToJson(const Settings& src, JsonVariant dst, bool safe = false) {
-  if (!safe) {
-    auto system = dst[FPSTR(S_SYSTEM)].to<JsonObject>();
-    system[FPSTR(S_LOG_LEVEL)] = static_cast<uint8_t>(src.system.logLevel);
-
-    auto serial = system[FPSTR(S_SERIAL)].to<JsonObject>();
-    serial[FPSTR(S_ENABLED)] = src.system.serial.enabled;
-    serial[FPSTR(S_BAUDRATE)] = src.system.serial.baudrate;
-
-    auto telnet = system[FPSTR(S_TELNET)].to<JsonObject>();
-    telnet[FPSTR(S_ENABLED)] = src.system.telnet.enabled;
-    telnet[FPSTR(S_PORT)] = src.system.telnet.port;
-
-    auto ntp = system[FPSTR(S_NTP)].to<JsonObject>();
-    ntp[FPSTR(S_SERVER)] = src.system.ntp.server;
-    ntp[FPSTR(S_TIMEZONE)] = src.system.ntp.timezone;
-
-    system[FPSTR(S_UNIT_SYSTEM)] = static_cast<uint8_t>(src.system.unitSystem);
-    system[FPSTR(S_STATUS_LED_GPIO)] = src.system.statusLedGpio;
-
-    auto portal = dst[FPSTR(S_PORTAL)].to<JsonObject>();
-    portal[FPSTR(S_AUTH)] = src.portal.auth;
-    portal[FPSTR(S_LOGIN)] = src.portal.login;
-    portal[FPSTR(S_PASSWORD)] = src.portal.password;
-    portal[FPSTR(S_MDNS)] = src.portal.mdns;
-
-    auto opentherm = dst[FPSTR(S_OPENTHERM)].to<JsonObject>();
-    opentherm[FPSTR(S_UNIT_SYSTEM)] = static_cast<uint8_t>(src.opentherm.unitSystem);
-    opentherm[FPSTR(S_IN_GPIO)] = src.opentherm.inGpio;
-    opentherm[FPSTR(S_OUT_GPIO)] = src.opentherm.outGpio;
-    opentherm[FPSTR(S_RX_LED_GPIO)] = src.opentherm.rxLedGpio;
-    opentherm[FPSTR(S_MEMBER_ID)] = src.opentherm.memberId;
-    opentherm[FPSTR(S_FLAGS)] = src.opentherm.flags;
-    opentherm[FPSTR(S_MIN_POWER)] = roundf(src.opentherm.minPower, 2);
-    opentherm[FPSTR(S_MAX_POWER)] = roundf(src.opentherm.maxPower, 2);
-
-    auto otOptions = opentherm[FPSTR(S_OPTIONS)].to<JsonObject>();
-    otOptions[FPSTR(S_DHW_SUPPORT)] = src.opentherm.options.dhwSupport;
-    otOptions[FPSTR(S_COOLING_SUPPORT)] = src.opentherm.options.coolingSupport;
-    otOptions[FPSTR(S_SUMMER_WINTER_MODE)] = src.opentherm.options.summerWinterMode;
-    otOptions[FPSTR(S_HEATING_STATE_TO_SUMMER_WINTER_MODE)] = src.opentherm.options.heatingStateToSummerWinterMode;
-    otOptions[FPSTR(S_CH2_ALWAYS_ENABLED)] = src.opentherm.options.ch2AlwaysEnabled;
-    otOptions[FPSTR(S_HEATING_TO_CH2)] = src.opentherm.options.heatingToCh2;
-    otOptions[FPSTR(S_DHW_TO_CH2)] = src.opentherm.options.dhwToCh2;
-    otOptions[FPSTR(S_DHW_BLOCKING)] = src.opentherm.options.dhwBlocking;
-    otOptions[FPSTR(S_DHW_STATE_AS_DHW_BLOCKING)] = src.opentherm.options.dhwStateAsDhwBlocking;
-    otOptions[FPSTR(S_MAX_TEMP_SYNC_WITH_TARGET_TEMP)] = src.opentherm.options.maxTempSyncWithTargetTemp;
-    otOptions[FPSTR(S_GET_MIN_MAX_TEMP)] = src.opentherm.options.getMinMaxTemp;
-    otOptions[FPSTR(S_IGNORE_DIAG_STATE)] = src.opentherm.options.ignoreDiagState;
-    otOptions[FPSTR(S_AUTO_FAULT_RESET)] = src.opentherm.options.autoFaultReset;
-    otOptions[FPSTR(S_AUTO_DIAG_RESET)] = src.opentherm.options.autoDiagReset;
-    otOptions[FPSTR(S_SET_DATE_AND_TIME)] = src.opentherm.options.setDateAndTime;
-    otOptions[FPSTR(S_ALWAYS_SEND_INDOOR_TEMP)] = src.opentherm.options.alwaysSendIndoorTemp;
-    otOptions[FPSTR(S_NATIVE_OTC)] = src.opentherm.options.nativeOTC;
-    otOptions[FPSTR(S_IMMERGAS_FIX)] = src.opentherm.options.immergasFix;
-    
-
-    auto mqtt = dst[FPSTR(S_MQTT)].to<JsonObject>();
-    mqtt[FPSTR(S_ENABLED)] = src.mqtt.enabled;
-    mqtt[FPSTR(S_SERVER)] = src.mqtt.server;
-    mqtt[FPSTR(S_PORT)] = src.mqtt.port;
-    mqtt[FPSTR(S_USER)] = src.mqtt.user;
-    mqtt[FPSTR(S_PASSWORD)] = src.mqtt.password;
-    mqtt[FPSTR(S_PREFIX)] = src.mqtt.prefix;
-    mqtt[FPSTR(S_INTERVAL)] = src.mqtt.interval;
-    mqtt[FPSTR(S_HOME_ASSISTANT_DISCOVERY)] = src.mqtt.homeAssistantDiscovery;
-
-    auto emergency = dst[FPSTR(S_EMERGENCY)].to<JsonObject>();
-    emergency[FPSTR(S_TARGET)] = roundf(src.emergency.target, 2);
-    emergency[FPSTR(S_TRESHOLD_TIME)] = src.emergency.tresholdTime;
-  }
-  
-  auto heating = dst[FPSTR(S_HEATING)].to<JsonObject>();
-  heating[FPSTR(S_ENABLED)] = src.heating.enabled;
-  heating[FPSTR(S_TURBO)] = src.heating.turbo;
-  heating[FPSTR(S_TARGET)] = roundf(src.heating.target, 2);
-  heating[FPSTR(S_HYSTERESIS)][FPSTR(S_ENABLED)] = src.heating.hysteresis.enabled;
-  heating[FPSTR(S_HYSTERESIS)][FPSTR(S_VALUE)] = roundf(src.heating.hysteresis.value, 3);
-  heating[FPSTR(S_HYSTERESIS)][FPSTR(S_ACTION)] = static_cast<uint8_t>(src.heating.hysteresis.action);
-  heating[FPSTR(S_TURBO_FACTOR)] = roundf(src.heating.turboFactor, 3);
-  heating[FPSTR(S_MIN_TEMP)] = src.heating.minTemp;
-  heating[FPSTR(S_MAX_TEMP)] = src.heating.maxTemp;
-  heating[FPSTR(S_MAX_MODULATION)] = src.heating.maxModulation;
-
-  auto heatingOverheatProtection = heating[FPSTR(S_OVERHEAT_PROTECTION)].to<JsonObject>();
-  heatingOverheatProtection[FPSTR(S_HIGH_TEMP)] = src.heating.overheatProtection.highTemp;
-  heatingOverheatProtection[FPSTR(S_LOW_TEMP)] = src.heating.overheatProtection.lowTemp;
-
-  auto freezeProtection = heating[FPSTR(S_FREEZE_PROTECTION)].to<JsonObject>();
-  freezeProtection[FPSTR(S_HIGH_TEMP)] = src.heating.freezeProtection.highTemp;
-  freezeProtection[FPSTR(S_LOW_TEMP)] = src.heating.freezeProtection.lowTemp;
-
-  auto dhw = dst[FPSTR(S_DHW)].to<JsonObject>();
-  dhw[FPSTR(S_ENABLED)] = src.dhw.enabled;
-  dhw[FPSTR(S_TARGET)] = roundf(src.dhw.target, 1);
-  dhw[FPSTR(S_MIN_TEMP)] = src.dhw.minTemp;
-  dhw[FPSTR(S_MAX_TEMP)] = src.dhw.maxTemp;
-  dhw[FPSTR(S_MAX_MODULATION)] = src.dhw.maxModulation;
-
-  auto dhwOverheatProtection = dhw[FPSTR(S_OVERHEAT_PROTECTION)].to<JsonObject>();
-  dhwOverheatProtection[FPSTR(S_HIGH_TEMP)] = src.dhw.overheatProtection.highTemp;
-  dhwOverheatProtection[FPSTR(S_LOW_TEMP)] = src.dhw.overheatProtection.lowTemp;
-
-  auto equitherm = dst[FPSTR(S_EQUITHERM)].to<JsonObject>();
-  equitherm[FPSTR(S_ENABLED)] = src.equitherm.enabled;
-  equitherm[FPSTR(S_SLOPE)] = roundf(src.equitherm.slope, 3);
-  equitherm[FPSTR(S_EXPONENT)] = roundf(src.equitherm.exponent, 3);
-  equitherm[FPSTR(S_SHIFT)] = roundf(src.equitherm.shift, 2);
-  equitherm[FPSTR(S_TARGET_DIFF_FACTOR)] = roundf(src.equitherm.targetDiffFactor, 3);
-
-  auto pid = dst[FPSTR(S_PID)].to<JsonObject>();
-  pid[FPSTR(S_ENABLED)] = src.pid.enabled;
-  pid[FPSTR(S_P_FACTOR)] = roundf(src.pid.p_factor, 3);
-  pid[FPSTR(S_I_FACTOR)] = roundf(src.pid.i_factor, 4);
-  pid[FPSTR(S_D_FACTOR)] = roundf(src.pid.d_factor, 1);
-  pid[FPSTR(S_DT)] = src.pid.dt;
-  pid[FPSTR(S_MIN_TEMP)] = src.pid.minTemp;
-  pid[FPSTR(S_MAX_TEMP)] = src.pid.maxTemp;
-
-  auto pidDeadband = pid[FPSTR(S_DEADBAND)].to<JsonObject>();
-  pidDeadband[FPSTR(S_ENABLED)] = src.pid.deadband.enabled;
-  pidDeadband[FPSTR(S_P_MULTIPLIER)] = src.pid.deadband.p_multiplier;
-  pidDeadband[FPSTR(S_I_MULTIPLIER)] = src.pid.deadband.i_multiplier;
-  pidDeadband[FPSTR(S_D_MULTIPLIER)] = src.pid.deadband.d_multiplier;
-  pidDeadband[FPSTR(S_THRESHOLD_HIGH)] = src.pid.deadband.thresholdHigh;
-  pidDeadband[FPSTR(S_THRESHOLD_LOW)] = src.pid.deadband.thresholdLow;
-
-  if (!safe) {
-    auto externalPump = dst[FPSTR(S_EXTERNAL_PUMP)].to<JsonObject>();
-    externalPump[FPSTR(S_USE)] = src.externalPump.use;
-    externalPump[FPSTR(S_GPIO)] = src.externalPump.gpio;
-    externalPump[FPSTR(S_INVERT_STATE)] = src.externalPump.invertState;
-    externalPump[FPSTR(S_POST_CIRCULATION_TIME)] = roundf(src.externalPump.postCirculationTime / 60, 0);
-    externalPump[FPSTR(S_ANTI_STUCK_INTERVAL)] = roundf(src.externalPump.antiStuckInterval / 86400, 0);
-    externalPump[FPSTR(S_ANTI_STUCK_TIME)] = roundf(src.externalPump.antiStuckTime / 60, 0);
-
-    auto cascadeControlInput = dst[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)].to<JsonObject>();
-    cascadeControlInput[FPSTR(S_ENABLED)] = src.cascadeControl.input.enabled;
-    cascadeControlInput[FPSTR(S_GPIO)] = src.cascadeControl.input.gpio;
-    cascadeControlInput[FPSTR(S_INVERT_STATE)] = src.cascadeControl.input.invertState;
-    cascadeControlInput[FPSTR(S_THRESHOLD_TIME)] = src.cascadeControl.input.thresholdTime;
-
-    auto cascadeControlOutput = dst[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)].to<JsonObject>();
-    cascadeControlOutput[FPSTR(S_ENABLED)] = src.cascadeControl.output.enabled;
-    cascadeControlOutput[FPSTR(S_GPIO)] = src.cascadeControl.output.gpio;
-    cascadeControlOutput[FPSTR(S_INVERT_STATE)] = src.cascadeControl.output.invertState;
-    cascadeControlOutput[FPSTR(S_THRESHOLD_TIME)] = src.cascadeControl.output.thresholdTime;
-    cascadeControlOutput[FPSTR(S_ON_FAULT)] = src.cascadeControl.output.onFault;
-    cascadeControlOutput[FPSTR(S_ON_LOSS_CONNECTION)] = src.cascadeControl.output.onLossConnection;
-    cascadeControlOutput[FPSTR(S_ON_ENABLED_HEATING)] = src.cascadeControl.output.onEnabledHeating;
-  }
+inline uint8_t* getSettingsFieldPtr(Settings& settings, const SettingsField& field) {
+  return reinterpret_cast<uint8_t*>(&settings) + field.offset;
 }
 
-inline void safeSettingsToJson(const Settings& src, JsonVariant dst) {
-  settingsToJson(src, dst, true);
+inline const uint8_t* getSettingsFieldPtr(const Settings& settings, const SettingsField& field) {
+  return reinterpret_cast<const uint8_t*>(&settings) + field.offset;
 }
 
-bool jsonToSettings(const JsonVariantConst src, Settings& dst, bool safe = false) {
-  bool changed = false;
-
-  if (!safe) {
-    // system
-    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_LOG_LEVEL)].isNull()) {
-      uint8_t value = src[FPSTR(S_SYSTEM)][FPSTR(S_LOG_LEVEL)].as<uint8_t>();
-
-      if (value != dst.system.logLevel && value >= TinyLogger::Level::SILENT && value <= TinyLogger::Level::VERBOSE) {
-        dst.system.logLevel = value;
-        changed = true;
-      }
-    }
-
-    if (src[FPSTR(S_SYSTEM)][FPSTR(S_SERIAL)][FPSTR(S_ENABLED)].is<bool>()) {
-      bool value = src[FPSTR(S_SYSTEM)][FPSTR(S_SERIAL)][FPSTR(S_ENABLED)].as<bool>();
-
-      if (value != dst.system.serial.enabled) {
-        dst.system.serial.enabled = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_SERIAL)][FPSTR(S_BAUDRATE)].isNull()) {
-      unsigned int value = src[FPSTR(S_SYSTEM)][FPSTR(S_SERIAL)][FPSTR(S_BAUDRATE)].as<unsigned int>();
-
-      if (value == 9600 || value == 19200 || value == 38400 || value == 57600 || value == 74880 || value == 115200) {
-        if (value != dst.system.serial.baudrate) {
-          dst.system.serial.baudrate = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (src[FPSTR(S_SYSTEM)][FPSTR(S_TELNET)][FPSTR(S_ENABLED)].is<bool>()) {
-      bool value = src[FPSTR(S_SYSTEM)][FPSTR(S_TELNET)][FPSTR(S_ENABLED)].as<bool>();
-
-      if (value != dst.system.telnet.enabled) {
-        dst.system.telnet.enabled = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_TELNET)][FPSTR(S_PORT)].isNull()) {
-      unsigned short value = src[FPSTR(S_SYSTEM)][FPSTR(S_TELNET)][FPSTR(S_PORT)].as<unsigned short>();
-
-      if (value > 0 && value <= 65535 && value != dst.system.telnet.port) {
-        dst.system.telnet.port = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_NTP)][FPSTR(S_SERVER)].isNull()) {
-      String value = src[FPSTR(S_SYSTEM)][FPSTR(S_NTP)][FPSTR(S_SERVER)].as<String>();
-
-      if (value.length() < sizeof(dst.system.ntp.server) && !value.equals(dst.system.ntp.server)) {
-        strcpy(dst.system.ntp.server, value.c_str());
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_NTP)][FPSTR(S_TIMEZONE)].isNull()) {
-      String value = src[FPSTR(S_SYSTEM)][FPSTR(S_NTP)][FPSTR(S_TIMEZONE)].as<String>();
-
-      if (value.length() < sizeof(dst.system.ntp.timezone) && !value.equals(dst.system.ntp.timezone)) {
-        strcpy(dst.system.ntp.timezone, value.c_str());
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_UNIT_SYSTEM)].isNull()) {
-      uint8_t value = src[FPSTR(S_SYSTEM)][FPSTR(S_UNIT_SYSTEM)].as<unsigned char>();
-      UnitSystem prevUnitSystem = dst.system.unitSystem;
-
-      switch (value) {
-        case static_cast<uint8_t>(UnitSystem::METRIC):
-          if (dst.system.unitSystem != UnitSystem::METRIC) {
-            dst.system.unitSystem = UnitSystem::METRIC;
-            changed = true;
-          }
-          break;
-
-        case static_cast<uint8_t>(UnitSystem::IMPERIAL):
-          if (dst.system.unitSystem != UnitSystem::IMPERIAL) {
-            dst.system.unitSystem = UnitSystem::IMPERIAL;
-            changed = true;
-          }
-          break;
-
-        default:
-          break;
-      }
-
-      // convert temps
-      if (dst.system.unitSystem != prevUnitSystem) {
-        dst.emergency.target = convertTemp(dst.emergency.target, prevUnitSystem, dst.system.unitSystem);
-        dst.heating.target = convertTemp(dst.heating.target, prevUnitSystem, dst.system.unitSystem);
-        dst.heating.minTemp = convertTemp(dst.heating.minTemp, prevUnitSystem, dst.system.unitSystem);
-        dst.heating.maxTemp = convertTemp(dst.heating.maxTemp, prevUnitSystem, dst.system.unitSystem);
-        dst.dhw.target = convertTemp(dst.dhw.target, prevUnitSystem, dst.system.unitSystem);
-        dst.dhw.minTemp = convertTemp(dst.dhw.minTemp, prevUnitSystem, dst.system.unitSystem);
-        dst.dhw.maxTemp = convertTemp(dst.dhw.maxTemp, prevUnitSystem, dst.system.unitSystem);
-        dst.pid.minTemp = convertTemp(dst.pid.minTemp, prevUnitSystem, dst.system.unitSystem);
-        dst.pid.maxTemp = convertTemp(dst.pid.maxTemp, prevUnitSystem, dst.system.unitSystem);
-      }
-    }
-
-    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_STATUS_LED_GPIO)].isNull()) {
-      if (src[FPSTR(S_SYSTEM)][FPSTR(S_STATUS_LED_GPIO)].is<JsonString>() && src[FPSTR(S_SYSTEM)][FPSTR(S_STATUS_LED_GPIO)].as<JsonString>().size() == 0) {
-        if (dst.system.statusLedGpio != GPIO_IS_NOT_CONFIGURED) {
-          dst.system.statusLedGpio = GPIO_IS_NOT_CONFIGURED;
-          changed = true;
-        }
-
-      } else {
-        unsigned char value = src[FPSTR(S_SYSTEM)][FPSTR(S_STATUS_LED_GPIO)].as<unsigned char>();
-
-        if (GPIO_IS_VALID(value) && value != dst.system.statusLedGpio) {
-          dst.system.statusLedGpio = value;
-          changed = true;
-        }
-      }
-    }
-
-
-    // portal
-    if (src[FPSTR(S_PORTAL)][FPSTR(S_AUTH)].is<bool>()) {
-      bool value = src[FPSTR(S_PORTAL)][FPSTR(S_AUTH)].as<bool>();
-
-      if (value != dst.portal.auth) {
-        dst.portal.auth = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_PORTAL)][FPSTR(S_LOGIN)].isNull()) {
-      String value = src[FPSTR(S_PORTAL)][FPSTR(S_LOGIN)].as<String>();
-
-      if (value.length() < sizeof(dst.portal.login) && !value.equals(dst.portal.login)) {
-        strcpy(dst.portal.login, value.c_str());
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_PORTAL)][FPSTR(S_PASSWORD)].isNull()) {
-      String value = src[FPSTR(S_PORTAL)][FPSTR(S_PASSWORD)].as<String>();
-
-      if (value.length() < sizeof(dst.portal.password) && !value.equals(dst.portal.password)) {
-        strcpy(dst.portal.password, value.c_str());
-        changed = true;
-      }
-    }
-
-    if (dst.portal.auth && (!strlen(dst.portal.login) || !strlen(dst.portal.password))) {
-      dst.portal.auth = false;
-      changed = true;
-    }
-
-    if (src[FPSTR(S_PORTAL)][FPSTR(S_MDNS)].is<bool>()) {
-      bool value = src[FPSTR(S_PORTAL)][FPSTR(S_MDNS)].as<bool>();
-
-      if (value != dst.portal.mdns) {
-        dst.portal.mdns = value;
-        changed = true;
-      }
-    }
-
-
-    // opentherm
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_UNIT_SYSTEM)].isNull()) {
-      uint8_t value = src[FPSTR(S_OPENTHERM)][FPSTR(S_UNIT_SYSTEM)].as<unsigned char>();
-
-      switch (value) {
-        case static_cast<uint8_t>(UnitSystem::METRIC):
-          if (dst.opentherm.unitSystem != UnitSystem::METRIC) {
-            dst.opentherm.unitSystem = UnitSystem::METRIC;
-            changed = true;
-          }
-          break;
-
-        case static_cast<uint8_t>(UnitSystem::IMPERIAL):
-          if (dst.opentherm.unitSystem != UnitSystem::IMPERIAL) {
-            dst.opentherm.unitSystem = UnitSystem::IMPERIAL;
-            changed = true;
-          }
-          break;
-
-        default:
-          break;
-      }
-    }
-
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_IN_GPIO)].isNull()) {
-      if (src[FPSTR(S_OPENTHERM)][FPSTR(S_IN_GPIO)].is<JsonString>() && src[FPSTR(S_OPENTHERM)][FPSTR(S_IN_GPIO)].as<JsonString>().size() == 0) {
-        if (dst.opentherm.inGpio != GPIO_IS_NOT_CONFIGURED) {
-          dst.opentherm.inGpio = GPIO_IS_NOT_CONFIGURED;
-          changed = true;
-        }
-
-      } else {
-        unsigned char value = src[FPSTR(S_OPENTHERM)][FPSTR(S_IN_GPIO)].as<unsigned char>();
-
-        if (GPIO_IS_VALID(value) && value != dst.opentherm.inGpio) {
-          dst.opentherm.inGpio = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_OUT_GPIO)].isNull()) {
-      if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OUT_GPIO)].is<JsonString>() && src[FPSTR(S_OPENTHERM)][FPSTR(S_OUT_GPIO)].as<JsonString>().size() == 0) {
-        if (dst.opentherm.outGpio != GPIO_IS_NOT_CONFIGURED) {
-          dst.opentherm.outGpio = GPIO_IS_NOT_CONFIGURED;
-          changed = true;
-        }
+float getSettingsFieldNumber(const Settings& src, const SettingsField& field) {
+  const uint8_t* ptr = getSettingsFieldPtr(src, field);
 
-      } else {
-        unsigned char value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OUT_GPIO)].as<unsigned char>();
+  switch (field.type) {
+    case SettingsFieldType::BOOL:
+      return *reinterpret_cast<const bool*>(ptr);
 
-        if (GPIO_IS_VALID(value) && value != dst.opentherm.outGpio) {
-          dst.opentherm.outGpio = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_RX_LED_GPIO)].isNull()) {
-      if (src[FPSTR(S_OPENTHERM)][FPSTR(S_RX_LED_GPIO)].is<JsonString>() && src[FPSTR(S_OPENTHERM)][FPSTR(S_RX_LED_GPIO)].as<JsonString>().size() == 0) {
-        if (dst.opentherm.rxLedGpio != GPIO_IS_NOT_CONFIGURED) {
-          dst.opentherm.rxLedGpio = GPIO_IS_NOT_CONFIGURED;
-          changed = true;
-        }
+    case SettingsFieldType::UINT8:
+    case SettingsFieldType::GPIO:
+      return *ptr;
 
-      } else {
-        unsigned char value = src[FPSTR(S_OPENTHERM)][FPSTR(S_RX_LED_GPIO)].as<unsigned char>();
+    case SettingsFieldType::UINT16:
+      return *reinterpret_cast<const unsigned short*>(ptr);
 
-        if (GPIO_IS_VALID(value) && value != dst.opentherm.rxLedGpio) {
-          dst.opentherm.rxLedGpio = value;
-          changed = true;
-        }
-      }
-    }
+    case SettingsFieldType::UINT32:
+      return *reinterpret_cast<const unsigned int*>(ptr);
 
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_MEMBER_ID)].isNull()) {
-      auto value = src[FPSTR(S_OPENTHERM)][FPSTR(S_MEMBER_ID)].as<uint8_t>();
+    case SettingsFieldType::INT16:
+      return *reinterpret_cast<const short*>(ptr);
 
-      if (value != dst.opentherm.memberId) {
-        dst.opentherm.memberId = value;
-        changed = true;
-      }
-    }
+    case SettingsFieldType::FLOAT:
+      return *reinterpret_cast<const float*>(ptr);
 
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_FLAGS)].isNull()) {
-      auto value = src[FPSTR(S_OPENTHERM)][FPSTR(S_FLAGS)].as<uint8_t>();
+    default:
+      return 0.0f;
+  }
+}
 
-      if (value != dst.opentherm.flags) {
-        dst.opentherm.flags = value;
-        changed = true;
-      }
-    }
+void setSettingsFieldNumber(Settings& dst, const SettingsField& field, float value) {
+  uint8_t* ptr = getSettingsFieldPtr(dst, field);
 
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_MIN_POWER)].isNull()) {
-      float value = src[FPSTR(S_OPENTHERM)][FPSTR(S_MIN_POWER)].as<float>();
+  switch (field.type) {
+    case SettingsFieldType::BOOL:
+      *reinterpret_cast<bool*>(ptr) = value != 0.0f;
+      break;
 
-      if (value >= 0 && value <= 1000 && fabsf(value - dst.opentherm.minPower) > 0.0001f) {
-        dst.opentherm.minPower = roundf(value, 2);
-        changed = true;
-      }
-    }
+    case SettingsFieldType::UINT8:
+    case SettingsFieldType::GPIO:
+      *ptr = static_cast<uint8_t>(value);
+      break;
 
-    if (!src[FPSTR(S_OPENTHERM)][FPSTR(S_MAX_POWER)].isNull()) {
-      float value = src[FPSTR(S_OPENTHERM)][FPSTR(S_MAX_POWER)].as<float>();
+    case SettingsFieldType::UINT16:
+      *reinterpret_cast<unsigned short*>(ptr) = static_cast<unsigned short>(value);
+      break;
 
-      if (value >= 0 && value <= 1000 && fabsf(value - dst.opentherm.maxPower) > 0.0001f) {
-        dst.opentherm.maxPower = roundf(value, 2);
-        changed = true;
-      }
-    }
+    case SettingsFieldType::UINT32:
+      *reinterpret_cast<unsigned int*>(ptr) = static_cast<unsigned int>(value);
+      break;
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_SUPPORT)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_SUPPORT)].as<bool>();
+    case SettingsFieldType::INT16:
+      *reinterpret_cast<short*>(ptr) = static_cast<short>(value);
+      break;
 
-      if (value != dst.opentherm.options.dhwSupport) {
-        dst.opentherm.options.dhwSupport = value;
-        changed = true;
-      }
-    }
+    case SettingsFieldType::FLOAT:
+      *reinterpret_cast<float*>(ptr) = value;
+      break;
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_COOLING_SUPPORT)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_COOLING_SUPPORT)].as<bool>();
+    default:
+      break;
+  }
+}
 
-      if (value != dst.opentherm.options.coolingSupport) {
-        dst.opentherm.options.coolingSupport = value;
-        changed = true;
-      }
-    }
+void convertSettingsTemps(Settings& dst, const UnitSystem unitFrom, const UnitSystem unitTo) {
+  SettingsField field;
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_SUMMER_WINTER_MODE)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_SUMMER_WINTER_MODE)].as<bool>();
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    getSettingsField(i, field);
 
-      if (value != dst.opentherm.options.summerWinterMode) {
-        dst.opentherm.options.summerWinterMode = value;
-        changed = true;
-      }
+    if (field.flags & SETTINGS_FIELD_TEMP) {
+      setSettingsFieldNumber(dst, field, convertTemp(getSettingsFieldNumber(dst, field), unitFrom, unitTo));
     }
+  }
+}
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_HEATING_STATE_TO_SUMMER_WINTER_MODE)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_HEATING_STATE_TO_SUMMER_WINTER_MODE)].as<bool>();
-
-      if (value != dst.opentherm.options.heatingStateToSummerWinterMode) {
-        dst.opentherm.options.heatingStateToSummerWinterMode = value;
-        changed = true;
-      }
-    }
-
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_CH2_ALWAYS_ENABLED)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_CH2_ALWAYS_ENABLED)].as<bool>();
-
-      if (value != dst.opentherm.options.ch2AlwaysEnabled) {
-        dst.opentherm.options.ch2AlwaysEnabled = value;
+bool jsonToSettingsField(const JsonVariantConst src, const SettingsField& field, Settings& dst) {
+  if (src.isNull()) {
+    return false;
+  }
 
-        if (dst.opentherm.options.ch2AlwaysEnabled) {
-          dst.opentherm.options.heatingToCh2 = false;
-          dst.opentherm.options.dhwToCh2 = false;
-        }
+  uint8_t* ptr = getSettingsFieldPtr(dst, field);
 
-        changed = true;
-      }
+  if (field.type == SettingsFieldType::BOOL) {
+    if (!src.is<bool>()) {
+      return false;
     }
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_HEATING_TO_CH2)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_HEATING_TO_CH2)].as<bool>();
-
-      if (value != dst.opentherm.options.heatingToCh2) {
-        dst.opentherm.options.heatingToCh2 = value;
-
-        if (dst.opentherm.options.heatingToCh2) {
-          dst.opentherm.options.ch2AlwaysEnabled = false;
-          dst.opentherm.options.dhwToCh2 = false;
-        }
-
-        changed = true;
-      }
+    bool value = src.as<bool>();
+    if (value == *reinterpret_cast<bool*>(ptr)) {
+      return false;
     }
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_TO_CH2)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_TO_CH2)].as<bool>();
-
-      if (value != dst.opentherm.options.dhwToCh2) {
-        dst.opentherm.options.dhwToCh2 = value;
-
-        if (dst.opentherm.options.dhwToCh2) {
-          dst.opentherm.options.ch2AlwaysEnabled = false;
-          dst.opentherm.options.heatingToCh2 = false;
-        }
-
-        changed = true;
-      }
-    }
+    *reinterpret_cast<bool*>(ptr) = value;
+    return true;
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_BLOCKING)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_BLOCKING)].as<bool>();
+  } else if (field.type == SettingsFieldType::STRING) {
+    String value = src.as<String>();
+    char* current = reinterpret_cast<char*>(ptr);
 
-      if (value != dst.opentherm.options.dhwBlocking) {
-        dst.opentherm.options.dhwBlocking = value;
-        changed = true;
-      }
+    if (value.length() >= field.size || value.equals(current)) {
+      return false;
     }
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_STATE_AS_DHW_BLOCKING)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_DHW_STATE_AS_DHW_BLOCKING)].as<bool>();
+    strcpy(current, value.c_str());
+    return true;
 
-      if (value != dst.opentherm.options.dhwStateAsDhwBlocking) {
-        dst.opentherm.options.dhwStateAsDhwBlocking = value;
-        changed = true;
-      }
-    }
+  } else if (field.type == SettingsFieldType::GPIO) {
+    uint8_t value = GPIO_IS_NOT_CONFIGURED;
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_MAX_TEMP_SYNC_WITH_TARGET_TEMP)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_MAX_TEMP_SYNC_WITH_TARGET_TEMP)].as<bool>();
+    if (!src.is<JsonString>() || src.as<JsonString>().size() != 0) {
+      value = src.as<unsigned char>();
 
-      if (value != dst.opentherm.options.maxTempSyncWithTargetTemp) {
-        dst.opentherm.options.maxTempSyncWithTargetTemp = value;
-        changed = true;
+      if (!GPIO_IS_VALID(value)) {
+        return false;
       }
     }
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_GET_MIN_MAX_TEMP)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_GET_MIN_MAX_TEMP)].as<bool>();
-
-      if (value != dst.opentherm.options.getMinMaxTemp) {
-        dst.opentherm.options.getMinMaxTemp = value;
-        changed = true;
-      }
+    if (value == *ptr) {
+      return false;
     }
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_IGNORE_DIAG_STATE)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_IGNORE_DIAG_STATE)].as<bool>();
+    *ptr = value;
+    return true;
+  }
 
-      if (value != dst.opentherm.options.ignoreDiagState) {
-        dst.opentherm.options.ignoreDiagState = value;
-        changed = true;
-      }
-    }
+  float value = field.type == SettingsFieldType::FLOAT ? src.as<float>() : src.as<long>();
+  bool valid = field.flags & SETTINGS_FIELD_TEMP_RANGE
+    ? isValidTemp(value, dst.system.unitSystem, field.min, field.max)
+    : value >= field.min && value <= field.max;
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_AUTO_FAULT_RESET)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_AUTO_FAULT_RESET)].as<bool>();
+  if (!valid) {
+    return false;
+  }
 
-      if (value != dst.opentherm.options.autoFaultReset) {
-        dst.opentherm.options.autoFaultReset = value;
-        changed = true;
-      }
+  if (field.type == SettingsFieldType::FLOAT) {
+    if (fabsf(value - getSettingsFieldNumber(dst, field)) <= 0.0001f) {
+      return false;
     }
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_AUTO_DIAG_RESET)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_AUTO_DIAG_RESET)].as<bool>();
+    value = roundf(value, field.size);
 
-      if (value != dst.opentherm.options.autoDiagReset) {
-        dst.opentherm.options.autoDiagReset = value;
-        changed = true;
-      }
-    }
-
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_SET_DATE_AND_TIME)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_SET_DATE_AND_TIME)].as<bool>();
+  } else {
+    value *= field.scale;
 
-      if (value != dst.opentherm.options.setDateAndTime) {
-        dst.opentherm.options.setDateAndTime = value;
-        changed = true;
-      }
+    if (value == getSettingsFieldNumber(dst, field)) {
+      return false;
     }
+  }
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_ALWAYS_SEND_INDOOR_TEMP)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_ALWAYS_SEND_INDOOR_TEMP)].as<bool>();
+  setSettingsFieldNumber(dst, field, value);
+  return true;
+}
 
-      if (value != dst.opentherm.options.alwaysSendIndoorTemp) {
-        dst.opentherm.options.alwaysSendIndoorTemp = value;
-        changed = true;
-      }
-    }
+/**
+ * Walks the json once, each member is matched against the descriptors of its parent object only.
+ */
+bool jsonToSettingsFields(const JsonObjectConst src, Settings& dst, bool safe, uint8_t depth, uint8_t begin, uint8_t end) {
+  bool changed = false;
 
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_NATIVE_OTC)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_NATIVE_OTC)].as<bool>();
+  for (JsonPairConst item : src) {
+    const char* key = item.key().c_str();
 
-      if (value != dst.opentherm.options.nativeOTC) {
-        dst.opentherm.options.nativeOTC = value;
+    // the fields of an object are contiguous
+    uint8_t first = end;
+    uint8_t last = end;
+    for (uint8_t i = begin; i < end; i++) {
+      const char* part = reinterpret_cast<const char*>(pgm_read_ptr(&settingsFields[i].path[depth]));
 
-        if (value) {
-          dst.equitherm.enabled = false;
-          dst.pid.enabled = false;
+      if (part != nullptr && strcmp_P(key, part) == 0) {
+        if (first == end) {
+          first = i;
         }
 
-        changed = true;
-      }
-    }
-
-    if (src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_IMMERGAS_FIX)].is<bool>()) {
-      bool value = src[FPSTR(S_OPENTHERM)][FPSTR(S_OPTIONS)][FPSTR(S_IMMERGAS_FIX)].as<bool>();
-
-      if (value != dst.opentherm.options.immergasFix) {
-        dst.opentherm.options.immergasFix = value;
-        changed = true;
-      }
-    }
-
-    // mqtt
-    if (src[FPSTR(S_MQTT)][FPSTR(S_ENABLED)].is<bool>()) {
-      bool value = src[FPSTR(S_MQTT)][FPSTR(S_ENABLED)].as<bool>();
-
-      if (value != dst.mqtt.enabled) {
-        dst.mqtt.enabled = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_MQTT)][FPSTR(S_SERVER)].isNull()) {
-      String value = src[FPSTR(S_MQTT)][FPSTR(S_SERVER)].as<String>();
-
-      if (value.length() < sizeof(dst.mqtt.server) && !value.equals(dst.mqtt.server)) {
-        strcpy(dst.mqtt.server, value.c_str());
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_MQTT)][FPSTR(S_PORT)].isNull()) {
-      unsigned short value = src[FPSTR(S_MQTT)][FPSTR(S_PORT)].as<unsigned short>();
+        last = i + 1;
 
-      if (value > 0 && value <= 65535 && value != dst.mqtt.port) {
-        dst.mqtt.port = value;
-        changed = true;
+      } else if (first != end) {
+        break;
       }
     }
 
-    if (!src[FPSTR(S_MQTT)][FPSTR(S_USER)].isNull()) {
-      String value = src[FPSTR(S_MQTT)][FPSTR(S_USER)].as<String>();
-
-      if (value.length() < sizeof(dst.mqtt.user) && !value.equals(dst.mqtt.user)) {
-        strcpy(dst.mqtt.user, value.c_str());
-        changed = true;
-      }
+    if (first == end) {
+      continue;
     }
 
-    if (!src[FPSTR(S_MQTT)][FPSTR(S_PASSWORD)].isNull()) {
-      String value = src[FPSTR(S_MQTT)][FPSTR(S_PASSWORD)].as<String>();
-
-      if (value.length() < sizeof(dst.mqtt.password) && !value.equals(dst.mqtt.password)) {
-        strcpy(dst.mqtt.password, value.c_str());
+    if (item.value().is<JsonObjectConst>()) {
+      if (depth < 2 && jsonToSettingsFields(item.value().as<JsonObjectConst>(), dst, safe, depth + 1, first, last)) {
         changed = true;
       }
-    }
-
-    if (!src[FPSTR(S_MQTT)][FPSTR(S_PREFIX)].isNull()) {
-      String value = src[FPSTR(S_MQTT)][FPSTR(S_PREFIX)].as<String>();
 
-      if (value.length() < sizeof(dst.mqtt.prefix) && !value.equals(dst.mqtt.prefix)) {
-        strcpy(dst.mqtt.prefix, value.c_str());
-        changed = true;
-      }
+      continue;
     }
 
-    if (!src[FPSTR(S_MQTT)][FPSTR(S_INTERVAL)].isNull()) {
-      unsigned short value = src[FPSTR(S_MQTT)][FPSTR(S_INTERVAL)].as<unsigned short>();
-
-      if (value >= 3 && value <= 60 && value != dst.mqtt.interval) {
-        dst.mqtt.interval = value;
-        changed = true;
-      }
-    }
+    SettingsField field;
+    getSettingsField(first, field);
 
-    if (src[FPSTR(S_MQTT)][FPSTR(S_HOME_ASSISTANT_DISCOVERY)].is<bool>()) {
-      bool value = src[FPSTR(S_MQTT)][FPSTR(S_HOME_ASSISTANT_DISCOVERY)].as<bool>();
+    if (getSettingsFieldDepth(field) != depth + 1 || field.flags & SETTINGS_FIELD_MANUAL) {
+      continue;
 
-      if (value != dst.mqtt.homeAssistantDiscovery) {
-        dst.mqtt.homeAssistantDiscovery = value;
-        changed = true;
-      }
+    } else if (safe && !(field.flags & SETTINGS_FIELD_SAFE)) {
+      continue;
     }
 
-
-    // emergency
-    if (!src[FPSTR(S_EMERGENCY)][FPSTR(S_TRESHOLD_TIME)].isNull()) {
-      unsigned short value = src[FPSTR(S_EMERGENCY)][FPSTR(S_TRESHOLD_TIME)].as<unsigned short>();
-
-      if (value >= 60 && value <= 1800 && value != dst.emergency.tresholdTime) {
-        dst.emergency.tresholdTime = value;
-        changed = true;
+    if (jsonToSettingsField(item.value(), field, dst)) {
+      if (field.onChange != nullptr) {
+        field.onChange(dst);
       }
-    }
-  }
-
 
-  // equitherm
-  if (src[FPSTR(S_EQUITHERM)][FPSTR(S_ENABLED)].is<bool>()) {
-    bool value = src[FPSTR(S_EQUITHERM)][FPSTR(S_ENABLED)].as<bool>();
-
-    if (!dst.opentherm.options.nativeOTC) {
-      if (value != dst.equitherm.enabled) {
-        dst.equitherm.enabled = value;
-        changed = true;
-      }
-
-    } else if (dst.equitherm.enabled) {
-      dst.equitherm.enabled = false;
-      changed = true;
-    }
-  }
-
-  if (!src[FPSTR(S_EQUITHERM)][FPSTR(S_SLOPE)].isNull()) {
-    float value = src[FPSTR(S_EQUITHERM)][FPSTR(S_SLOPE)].as<float>();
-
-    if (value > 0.0f && value <= 10.0f && fabsf(value - dst.equitherm.slope) > 0.0001f) {
-      dst.equitherm.slope = roundf(value, 3);
       changed = true;
     }
   }
 
-  if (!src[FPSTR(S_EQUITHERM)][FPSTR(S_EXPONENT)].isNull()) {
-    float value = src[FPSTR(S_EQUITHERM)][FPSTR(S_EXPONENT)].as<float>();
-
-    if (value > 0.0f && value <= 2.0f && fabsf(value - dst.equitherm.exponent) > 0.0001f) {
-      dst.equitherm.exponent = roundf(value, 3);
-      changed = true;
-    }
-  }
+  return changed;
+}
 
-  if (!src[FPSTR(S_EQUITHERM)][FPSTR(S_SHIFT)].isNull()) {
-    float value = src[FPSTR(S_EQUITHERM)][FPSTR(S_SHIFT)].as<float>();
+// with `filter`, only the changed fields are written
+void settingsToJson(const Settings& src, JsonVariant dst, bool safe = false, const SettingsChanges* filter = nullptr) {
+  JsonObject root = dst.is<JsonObject>() ? dst.as<JsonObject>() : dst.to<JsonObject>();
+  const char* parentKeys[2] = {nullptr, nullptr};
+  JsonObject parents[2];
+  SettingsField field;
 
-    if (value >= -15.0f && value <= 15.0f && fabsf(value - dst.equitherm.shift) > 0.0001f) {
-      dst.equitherm.shift = roundf(value, 2);
-      changed = true;
-    }
-  }
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    getSettingsField(i, field);
 
-  if (!src[FPSTR(S_EQUITHERM)][FPSTR(S_TARGET_DIFF_FACTOR)].isNull()) {
-    float value = src[FPSTR(S_EQUITHERM)][FPSTR(S_TARGET_DIFF_FACTOR)].as<float>();
+    if (safe && !(field.flags & SETTINGS_FIELD_SAFE)) {
+      continue;
 
-    if (value >= 0.0f && value <= 10.0f && fabsf(value - dst.equitherm.targetDiffFactor) > 0.0001f) {
-      dst.equitherm.targetDiffFactor = roundf(value, 3);
-      changed = true;
+    } else if (filter != nullptr && !filter->hasField(i)) {
+      continue;
     }
-  }
 
+    // parent objects are created once, when the group starts
+    const uint8_t depth = getSettingsFieldDepth(field);
+    JsonObject parent = root;
+    for (uint8_t level = 0; level < depth - 1; level++) {
+      if (parentKeys[level] != field.path[level]) {
+        parentKeys[level] = field.path[level];
+        parents[level] = parent[FPSTR(field.path[level])].to<JsonObject>();
 
-  // pid
-  if (src[FPSTR(S_PID)][FPSTR(S_ENABLED)].is<bool>()) {
-    bool value = src[FPSTR(S_PID)][FPSTR(S_ENABLED)].as<bool>();
-
-    if (!dst.opentherm.options.nativeOTC) {
-      if (value != dst.pid.enabled) {
-        dst.pid.enabled = value;
-        changed = true;
+        if (level == 0) {
+          parentKeys[1] = nullptr;
+        }
       }
 
-    } else if (dst.pid.enabled) {
-      dst.pid.enabled = false;
-      changed = true;
+      parent = parents[level];
     }
-  }
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_P_FACTOR)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_P_FACTOR)].as<float>();
+    auto item = parent[FPSTR(field.path[depth - 1])];
+    const uint8_t* ptr = getSettingsFieldPtr(src, field);
 
-    if (value > 0 && value <= 1000 && fabsf(value - dst.pid.p_factor) > 0.0001f) {
-      dst.pid.p_factor = roundf(value, 3);
-      changed = true;
-    }
-  }
+    switch (field.type) {
+      case SettingsFieldType::BOOL:
+        item = *reinterpret_cast<const bool*>(ptr);
+        break;
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_I_FACTOR)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_I_FACTOR)].as<float>();
+      case SettingsFieldType::STRING:
+        item = reinterpret_cast<const char*>(ptr);
+        break;
 
-    if (value >= 0 && value <= 100 && fabsf(value - dst.pid.i_factor) > 0.0001f) {
-      dst.pid.i_factor = roundf(value, 4);
-      changed = true;
-    }
-  }
+      case SettingsFieldType::FLOAT:
+        item = roundf(*reinterpret_cast<const float*>(ptr), field.size);
+        break;
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_D_FACTOR)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_D_FACTOR)].as<float>();
+      case SettingsFieldType::INT16:
+        item = *reinterpret_cast<const short*>(ptr);
+        break;
 
-    if (value >= 0 && value <= 100000 && fabsf(value - dst.pid.d_factor) > 0.0001f) {
-      dst.pid.d_factor = roundf(value, 1);
-      changed = true;
-    }
-  }
+      case SettingsFieldType::UINT16:
+        item = *reinterpret_cast<const unsigned short*>(ptr) / field.scale;
+        break;
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_DT)].isNull()) {
-    unsigned short value = src[FPSTR(S_PID)][FPSTR(S_DT)].as<unsigned short>();
+      case SettingsFieldType::UINT32:
+        item = *reinterpret_cast<const unsigned int*>(ptr) / field.scale;
+        break;
 
-    if (value >= 30 && value <= 1800 && value != dst.pid.dt) {
-      dst.pid.dt = value;
-      changed = true;
+      default:
+        item = *ptr;
     }
   }
+}
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_MIN_TEMP)].isNull()) {
-    short value = src[FPSTR(S_PID)][FPSTR(S_MIN_TEMP)].as<short>();
-
-    if (isValidTemp(value, dst.system.unitSystem, dst.equitherm.enabled ? -99.9f : 0.0f) && value != dst.pid.minTemp) {
-      dst.pid.minTemp = value;
-      changed = true;
-    }
-  }
+inline void safeSettingsToJson(const Settings& src, JsonVariant dst) {
+  settingsToJson(src, dst, true);
+}
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_MAX_TEMP)].isNull()) {
-    short value = src[FPSTR(S_PID)][FPSTR(S_MAX_TEMP)].as<short>();
+// with `changes`, the fields that were actually changed are collected
+bool jsonToSettings(const JsonVariantConst src, Settings& dst, bool safe = false, SettingsChanges* changes = nullptr) {
+  bool changed = false;
+  Settings* prev = changes != nullptr ? new Settings(dst) : nullptr;
 
-    if (isValidTemp(value, dst.system.unitSystem) && value != dst.pid.maxTemp) {
-      dst.pid.maxTemp = value;
-      changed = true;
-    }
-  }
+  // the unit system goes first, temps are validated in the new one
+  if (!safe && !src[FPSTR(S_SYSTEM)][FPSTR(S_UNIT_SYSTEM)].isNull()) {
+    uint8_t value = src[FPSTR(S_SYSTEM)][FPSTR(S_UNIT_SYSTEM)].as<unsigned char>();
+    UnitSystem prevUnitSystem = dst.system.unitSystem;
 
-  if (dst.pid.maxTemp < dst.pid.minTemp) {
-    dst.pid.maxTemp = dst.pid.minTemp;
-    changed = true;
-  }
+    switch (value) {
+      case static_cast<uint8_t>(UnitSystem::METRIC):
+        if (dst.system.unitSystem != UnitSystem::METRIC) {
+          dst.system.unitSystem = UnitSystem::METRIC;
+          changed = true;
+        }
+        break;
 
-  if (src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_ENABLED)].is<bool>()) {
-    bool value = src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_ENABLED)].as<bool>();
+      case static_cast<uint8_t>(UnitSystem::IMPERIAL):
+        if (dst.system.unitSystem != UnitSystem::IMPERIAL) {
+          dst.system.unitSystem = UnitSystem::IMPERIAL;
+          changed = true;
+        }
+        break;
 
-    if (value != dst.pid.deadband.enabled) {
-      dst.pid.deadband.enabled = value;
-      changed = true;
+      default:
+        break;
     }
-  }
-
-  if (!src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_P_MULTIPLIER)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_P_MULTIPLIER)].as<float>();
 
-    if (value >= 0 && value <= 1 && fabsf(value - dst.pid.deadband.p_multiplier) > 0.0001f) {
-      dst.pid.deadband.p_multiplier = roundf(value, 3);
-      changed = true;
+    // convert temps
+    if (dst.system.unitSystem != prevUnitSystem) {
+      convertSettingsTemps(dst, prevUnitSystem, dst.system.unitSystem);
     }
   }
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_I_MULTIPLIER)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_I_MULTIPLIER)].as<float>();
-
-    if (value >= 0 && value <= 1 && fabsf(value - dst.pid.deadband.i_multiplier) > 0.0001f) {
-      dst.pid.deadband.i_multiplier = roundf(value, 3);
-      changed = true;
-    }
+  // plain fields, validated by the table
+  if (jsonToSettingsFields(src.as<JsonObjectConst>(), dst, safe, 0, 0, settingsFieldsAmount)) {
+    changed = true;
   }
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_D_MULTIPLIER)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_D_MULTIPLIER)].as<float>();
+  if (!safe) {
+    if (!src[FPSTR(S_SYSTEM)][FPSTR(S_SERIAL)][FPSTR(S_BAUDRATE)].isNull()) {
+      unsigned int value = src[FPSTR(S_SYSTEM)][FPSTR(S_SERIAL)][FPSTR(S_BAUDRATE)].as<unsigned int>();
 
-    if (value >= 0 && value <= 1 && fabsf(value - dst.pid.deadband.d_multiplier) > 0.0001f) {
-      dst.pid.deadband.d_multiplier = roundf(value, 3);
-      changed = true;
+      if (value == 9600 || value == 19200 || value == 38400 || value == 57600 || value == 74880 || value == 115200) {
+        if (value != dst.system.serial.baudrate) {
+          dst.system.serial.baudrate = value;
+          changed = true;
+        }
+      }
     }
-  }
-
-  if (!src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_THRESHOLD_HIGH)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_THRESHOLD_HIGH)].as<float>();
 
-    if (value >= 0.0f && value <= 5.0f && fabsf(value - dst.pid.deadband.thresholdHigh) > 0.0001f) {
-      dst.pid.deadband.thresholdHigh = roundf(value, 2);
+    if (dst.portal.auth && (!strlen(dst.portal.login) || !strlen(dst.portal.password))) {
+      dst.portal.auth = false;
       changed = true;
     }
   }
 
-  if (!src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_THRESHOLD_LOW)].isNull()) {
-    float value = src[FPSTR(S_PID)][FPSTR(S_DEADBAND)][FPSTR(S_THRESHOLD_LOW)].as<float>();
-
-    if (value >= 0.0f && value <= 5.0f && fabsf(value - dst.pid.deadband.thresholdLow) > 0.0001f) {
-      dst.pid.deadband.thresholdLow = roundf(value, 2);
-      changed = true;
-    }
-  }
 
+  // regulators, depend on native OTC
+  if (src[FPSTR(S_EQUITHERM)][FPSTR(S_ENABLED)].is<bool>()) {
+    bool value = src[FPSTR(S_EQUITHERM)][FPSTR(S_ENABLED)].as<bool>();
 
-  // heating
-  if (src[FPSTR(S_HEATING)][FPSTR(S_ENABLED)].is<bool>()) {
-    bool value = src[FPSTR(S_HEATING)][FPSTR(S_ENABLED)].as<bool>();
+    if (!dst.opentherm.options.nativeOTC) {
+      if (value != dst.equitherm.enabled) {
+        dst.equitherm.enabled = value;
+        changed = true;
+      }
 
-    if (value != dst.heating.enabled) {
-      dst.heating.enabled = value;
+    } else if (dst.equitherm.enabled) {
+      dst.equitherm.enabled = false;
       changed = true;
     }
   }
 
-  if (src[FPSTR(S_HEATING)][FPSTR(S_TURBO)].is<bool>()) {
-    bool value = src[FPSTR(S_HEATING)][FPSTR(S_TURBO)].as<bool>();
-
-    if (value != dst.heating.turbo) {
-      dst.heating.turbo = value;
-      changed = true;
-    }
-  }
+  if (src[FPSTR(S_PID)][FPSTR(S_ENABLED)].is<bool>()) {
+    bool value = src[FPSTR(S_PID)][FPSTR(S_ENABLED)].as<bool>();
 
-  if (src[FPSTR(S_HEATING)][FPSTR(S_HYSTERESIS)][FPSTR(S_ENABLED)].is<bool>()) {
-    bool value = src[FPSTR(S_HEATING)][FPSTR(S_HYSTERESIS)][FPSTR(S_ENABLED)].as<bool>();
+    if (!dst.opentherm.options.nativeOTC) {
+      if (value != dst.pid.enabled) {
+        dst.pid.enabled = value;
+        changed = true;
+      }
 
-    if (value != dst.heating.hysteresis.enabled) {
-      dst.heating.hysteresis.enabled = value;
+    } else if (dst.pid.enabled) {
+      dst.pid.enabled = false;
       changed = true;
     }
   }
 
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_HYSTERESIS)][FPSTR(S_VALUE)].isNull()) {
-    float value = src[FPSTR(S_HEATING)][FPSTR(S_HYSTERESIS)][FPSTR(S_VALUE)].as<float>();
+  if (!src[FPSTR(S_PID)][FPSTR(S_MIN_TEMP)].isNull()) {
+    short value = src[FPSTR(S_PID)][FPSTR(S_MIN_TEMP)].as<short>();
 
-    if (value >= 0.0f && value <= 15.0f && fabsf(value - dst.heating.hysteresis.value) > 0.0001f) {
-      dst.heating.hysteresis.value = roundf(value, 2);
+    if (isValidTemp(value, dst.system.unitSystem, dst.equitherm.enabled ? -99.9f : 0.0f) && value != dst.pid.minTemp) {
+      dst.pid.minTemp = value;
       changed = true;
     }
   }
 
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_HYSTERESIS)][FPSTR(S_ACTION)].isNull()) {
-    uint8_t value = src[FPSTR(S_HEATING)][FPSTR(S_HYSTERESIS)][FPSTR(S_ACTION)].as<uint8_t>();
-
-    switch (value) {
-      case static_cast<uint8_t>(HysteresisAction::DISABLE_HEATING):
-      case static_cast<uint8_t>(HysteresisAction::SET_ZERO_TARGET):
-        if (static_cast<uint8_t>(dst.heating.hysteresis.action) != value) {
-         dst.heating.hysteresis.action = static_cast<HysteresisAction>(value);
-          changed = true;
-        }
-        break;
-
-      default:
-        break;
-    }
+  if (dst.pid.maxTemp < dst.pid.minTemp) {
+    dst.pid.maxTemp = dst.pid.minTemp;
+    changed = true;
   }
 
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_TURBO_FACTOR)].isNull()) {
-    float value = src[FPSTR(S_HEATING)][FPSTR(S_TURBO_FACTOR)].as<float>();
-
-    if (value >= 1.5f && value <= 10.0f && fabsf(value - dst.heating.turboFactor) > 0.0001f) {
-      dst.heating.turboFactor = roundf(value, 3);
-      changed = true;
-    }
-  }
 
+  // heating, limits depend on the boiler
   if (!src[FPSTR(S_HEATING)][FPSTR(S_MIN_TEMP)].isNull()) {
     unsigned char value = src[FPSTR(S_HEATING)][FPSTR(S_MIN_TEMP)].as<unsigned char>();
 
@@ -1393,73 +925,18 @@ bool jsonToSettings(const JsonVariantConst src, Settings& dst, bool safe = false
     changed = true;
   }
 
-
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_MAX_MODULATION)].isNull()) {
-    unsigned char value = src[FPSTR(S_HEATING)][FPSTR(S_MAX_MODULATION)].as<unsigned char>();
-
-    if (value > 0 && value <= 100 && value != dst.heating.maxModulation) {
-      dst.heating.maxModulation = value;
-      changed = true;
-    }
-  }
-
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_HIGH_TEMP)].isNull()) {
-    unsigned char value = src[FPSTR(S_HEATING)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_HIGH_TEMP)].as<unsigned char>();
-
-    if (isValidTemp(value, dst.system.unitSystem, 0.0f, 100.0f) && value != dst.heating.overheatProtection.highTemp) {
-      dst.heating.overheatProtection.highTemp = value;
-      changed = true;
-    }
-  }
-
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_LOW_TEMP)].isNull()) {
-    unsigned char value = src[FPSTR(S_HEATING)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_LOW_TEMP)].as<unsigned char>();
-
-    if (isValidTemp(value, dst.system.unitSystem, 0.0f, 99.0f) && value != dst.heating.overheatProtection.lowTemp) {
-      dst.heating.overheatProtection.lowTemp = value;
-      changed = true;
-    }
-  }
-
   if (dst.heating.overheatProtection.highTemp < dst.heating.overheatProtection.lowTemp) {
     dst.heating.overheatProtection.highTemp = dst.heating.overheatProtection.lowTemp;
     changed = true;
   }
 
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_FREEZE_PROTECTION)][FPSTR(S_HIGH_TEMP)].isNull()) {
-    unsigned short value = src[FPSTR(S_HEATING)][FPSTR(S_FREEZE_PROTECTION)][FPSTR(S_HIGH_TEMP)].as<uint8_t>();
-
-    if (isValidTemp(value, dst.system.unitSystem, 1, 50) && value != dst.heating.freezeProtection.highTemp) {
-      dst.heating.freezeProtection.highTemp = value;
-      changed = true;
-    }
-  }
-
-  if (!src[FPSTR(S_HEATING)][FPSTR(S_FREEZE_PROTECTION)][FPSTR(S_LOW_TEMP)].isNull()) {
-    unsigned short value = src[FPSTR(S_HEATING)][FPSTR(S_FREEZE_PROTECTION)][FPSTR(S_LOW_TEMP)].as<uint8_t>();
-
-    if (isValidTemp(value, dst.system.unitSystem, 1, 30) && value != dst.heating.freezeProtection.lowTemp) {
-      dst.heating.freezeProtection.lowTemp = value;
-      changed = true;
-    }
-  }
-
   if (dst.heating.freezeProtection.highTemp < dst.heating.freezeProtection.lowTemp) {
     dst.heating.freezeProtection.highTemp = dst.heating.freezeProtection.lowTemp;
     changed = true;
   }
 
 
-  // dhw
-  if (src[FPSTR(S_DHW)][FPSTR(S_ENABLED)].is<bool>()) {
-    bool value = src[FPSTR(S_DHW)][FPSTR(S_ENABLED)].as<bool>();
-
-    if (value != dst.dhw.enabled) {
-      dst.dhw.enabled = value;
-      changed = true;
-    }
-  }
-
+  // dhw, limits depend on the boiler
   if (!src[FPSTR(S_DHW)][FPSTR(S_MIN_TEMP)].isNull()) {
     unsigned char value = src[FPSTR(S_DHW)][FPSTR(S_MIN_TEMP)].as<unsigned char>();
 
@@ -1483,237 +960,11 @@ bool jsonToSettings(const JsonVariantConst src, Settings& dst, bool safe = false
     changed = true;
   }
 
-  if (!src[FPSTR(S_DHW)][FPSTR(S_MAX_MODULATION)].isNull()) {
-    unsigned char value = src[FPSTR(S_DHW)][FPSTR(S_MAX_MODULATION)].as<unsigned char>();
-
-    if (value > 0 && value <= 100 && value != dst.dhw.maxModulation) {
-      dst.dhw.maxModulation = value;
-      changed = true;
-    }
-  }
-
-  if (!src[FPSTR(S_DHW)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_HIGH_TEMP)].isNull()) {
-    unsigned char value = src[FPSTR(S_DHW)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_HIGH_TEMP)].as<unsigned char>();
-
-    if (isValidTemp(value, dst.system.unitSystem, 0.0f, 100.0f) && value != dst.dhw.overheatProtection.highTemp) {
-      dst.dhw.overheatProtection.highTemp = value;
-      changed = true;
-    }
-  }
-
-  if (!src[FPSTR(S_DHW)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_LOW_TEMP)].isNull()) {
-    unsigned char value = src[FPSTR(S_DHW)][FPSTR(S_OVERHEAT_PROTECTION)][FPSTR(S_LOW_TEMP)].as<unsigned char>();
-
-    if (isValidTemp(value, dst.system.unitSystem, 0.0f, 99.0f) && value != dst.dhw.overheatProtection.lowTemp) {
-      dst.dhw.overheatProtection.lowTemp = value;
-      changed = true;
-    }
-  }
-
   if (dst.dhw.overheatProtection.highTemp < dst.dhw.overheatProtection.lowTemp) {
     dst.dhw.overheatProtection.highTemp = dst.dhw.overheatProtection.lowTemp;
     changed = true;
   }
 
-
-  if (!safe) {
-    // external pump
-    if (src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_USE)].is<bool>()) {
-      bool value = src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_USE)].as<bool>();
-
-      if (value != dst.externalPump.use) {
-        dst.externalPump.use = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_GPIO)].isNull()) {
-      if (src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_GPIO)].is<JsonString>() && src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_GPIO)].as<JsonString>().size() == 0) {
-        if (dst.externalPump.gpio != GPIO_IS_NOT_CONFIGURED) {
-          dst.externalPump.gpio = GPIO_IS_NOT_CONFIGURED;
-          changed = true;
-        }
-
-      } else {
-        unsigned char value = src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_GPIO)].as<unsigned char>();
-
-        if (GPIO_IS_VALID(value) && value != dst.externalPump.gpio) {
-          dst.externalPump.gpio = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_INVERT_STATE)].is<bool>()) {
-      bool value = src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_INVERT_STATE)].as<bool>();
-
-      if (value != dst.externalPump.invertState) {
-        dst.externalPump.invertState = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_POST_CIRCULATION_TIME)].isNull()) {
-      unsigned short value = src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_POST_CIRCULATION_TIME)].as<unsigned short>();
-
-      if (value >= 0 && value <= 120) {
-        value = value * 60;
-
-        if (value != dst.externalPump.postCirculationTime) {
-          dst.externalPump.postCirculationTime = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (!src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_ANTI_STUCK_INTERVAL)].isNull()) {
-      unsigned int value = src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_ANTI_STUCK_INTERVAL)].as<unsigned int>();
-
-      if (value >= 0 && value <= 366) {
-        value = value * 86400;
-
-        if (value != dst.externalPump.antiStuckInterval) {
-          dst.externalPump.antiStuckInterval = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (!src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_ANTI_STUCK_TIME)].isNull()) {
-      unsigned short value = src[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_ANTI_STUCK_TIME)].as<unsigned short>();
-
-      if (value >= 0 && value <= 20) {
-        value = value * 60;
-
-        if (value != dst.externalPump.antiStuckTime) {
-          dst.externalPump.antiStuckTime = value;
-          changed = true;
-        }
-      }
-    }
-
-
-    // cascade control
-    if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_ENABLED)].is<bool>()) {
-      bool value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_ENABLED)].as<bool>();
-
-      if (value != dst.cascadeControl.input.enabled) {
-        dst.cascadeControl.input.enabled = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_GPIO)].isNull()) {
-      if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_GPIO)].is<JsonString>() && src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_GPIO)].as<JsonString>().size() == 0) {
-        if (dst.cascadeControl.input.gpio != GPIO_IS_NOT_CONFIGURED) {
-          dst.cascadeControl.input.gpio = GPIO_IS_NOT_CONFIGURED;
-          changed = true;
-        }
-
-      } else {
-        unsigned char value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_GPIO)].as<unsigned char>();
-
-        if (GPIO_IS_VALID(value) && value != dst.cascadeControl.input.gpio) {
-          dst.cascadeControl.input.gpio = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_INVERT_STATE)].is<bool>()) {
-      bool value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_INVERT_STATE)].as<bool>();
-
-      if (value != dst.cascadeControl.input.invertState) {
-        dst.cascadeControl.input.invertState = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_THRESHOLD_TIME)].isNull()) {
-      unsigned short value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_INPUT)][FPSTR(S_THRESHOLD_TIME)].as<unsigned short>();
-
-      if (value >= 5 && value <= 600) {
-        if (value != dst.cascadeControl.input.thresholdTime) {
-          dst.cascadeControl.input.thresholdTime = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ENABLED)].is<bool>()) {
-      bool value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ENABLED)].as<bool>();
-
-      if (value != dst.cascadeControl.output.enabled) {
-        dst.cascadeControl.output.enabled = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_GPIO)].isNull()) {
-      if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_GPIO)].is<JsonString>() && src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_GPIO)].as<JsonString>().size() == 0) {
-        if (dst.cascadeControl.output.gpio != GPIO_IS_NOT_CONFIGURED) {
-          dst.cascadeControl.output.gpio = GPIO_IS_NOT_CONFIGURED;
-          changed = true;
-        }
-
-      } else {
-        unsigned char value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_GPIO)].as<unsigned char>();
-
-        if (GPIO_IS_VALID(value) && value != dst.cascadeControl.output.gpio) {
-          dst.cascadeControl.output.gpio = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_INVERT_STATE)].is<bool>()) {
-      bool value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_INVERT_STATE)].as<bool>();
-
-      if (value != dst.cascadeControl.output.invertState) {
-        dst.cascadeControl.output.invertState = value;
-        changed = true;
-      }
-    }
-
-    if (!src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_THRESHOLD_TIME)].isNull()) {
-      unsigned short value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_THRESHOLD_TIME)].as<unsigned short>();
-
-      if (value >= 5 && value <= 600) {
-        if (value != dst.cascadeControl.output.thresholdTime) {
-          dst.cascadeControl.output.thresholdTime = value;
-          changed = true;
-        }
-      }
-    }
-
-    if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ON_FAULT)].is<bool>()) {
-      bool value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ON_FAULT)].as<bool>();
-
-      if (value != dst.cascadeControl.output.onFault) {
-        dst.cascadeControl.output.onFault = value;
-        changed = true;
-      }
-    }
-
-    if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ON_LOSS_CONNECTION)].is<bool>()) {
-      bool value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ON_LOSS_CONNECTION)].as<bool>();
-
-      if (value != dst.cascadeControl.output.onLossConnection) {
-        dst.cascadeControl.output.onLossConnection = value;
-        changed = true;
-      }
-    }
-
-    if (src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ON_ENABLED_HEATING)].is<bool>()) {
-      bool value = src[FPSTR(S_CASCADE_CONTROL)][FPSTR(S_OUTPUT)][FPSTR(S_ON_ENABLED_HEATING)].as<bool>();
-
-      if (value != dst.cascadeControl.output.onEnabledHeating) {
-        dst.cascadeControl.output.onEnabledHeating = value;
-        changed = true;
-      }
-    }
-  }
-
   // force check emergency target
   {
     float value = !src[FPSTR(S_EMERGENCY)][FPSTR(S_TARGET)].isNull() ? src[FPSTR(S_EMERGENCY)][FPSTR(S_TARGET)].as<float>() : dst.emergency.target;
@@ -1794,11 +1045,19 @@ bool jsonToSettings(const JsonVariantConst src, Settings& dst, bool safe = false
     }
   }
 
+  if (prev != nullptr) {
+    if (changed) {
+      diffSettings(*prev, dst, *changes);
+    }
+
+    delete prev;
+  }
+
   return changed;
 }
 
-inline bool safeJsonToSettings(const JsonVariantConst src, Settings& dst) {
-  return jsonToSettings(src, dst, true);
+inline bool safeJsonToSettings(const JsonVariantConst src, Settings& dst, SettingsChanges* changes = nullptr) {
+  return jsonToSettings(src, dst, true, changes);
 }
 
 void sensorSettingsToJson(const uint8_t sensorId, const Sensors::Settings& src, JsonVariant dst) {
@@ -2079,6 +1338,80 @@ bool jsonToSensorSettings(const uint8_t sensorId, const JsonVariantConst src, Se
   return changed;
 }
 
+void scheduleSettingsToJson(const ScheduleSettings& src, JsonVariant dst) {
+  auto blocks = dst[FPSTR(S_BLOCKS)].to<JsonArray>();
+  for (const auto& block : src.blocks) {
+    auto item = blocks.add<JsonObject>();
+    item[FPSTR(S_ENABLED)] = block.enabled;
+    item[FPSTR(S_DAYS)] = block.days;
+    item[FPSTR(S_START)] = block.start;
+    item[FPSTR(S_TARGET)] = roundf(convertTemp(block.target, UnitSystem::METRIC, settings.system.unitSystem), 2);
+  }
+
+  auto heatUp = dst[FPSTR(S_HEAT_UP)].to<JsonObject>();
+  heatUp[FPSTR(S_BASE)] = roundf(src.heatUp.base, 3);
+  heatUp[FPSTR(S_LOSS)] = roundf(src.heatUp.loss, 4);
+  heatUp[FPSTR(S_SAMPLES)] = src.heatUp.samples;
+}
+
+/**
+ * The blocks array replaces the schedule, blocks past its end are cleared.
+ * The heat-up model is learned, it is never set from json.
+ */
+bool jsonToScheduleSettings(const JsonVariantConst src, ScheduleSettings& dst, const UnitSystem unitSystem = settings.system.unitSystem) {
+  if (!src[FPSTR(S_BLOCKS)].is<JsonArrayConst>()) {
+    return false;
+  }
+
+  auto blocks = src[FPSTR(S_BLOCKS)].as<JsonArrayConst>();
+  if (blocks.size() > SCHEDULE_MAX_BLOCKS) {
+    return false;
+  }
+
+  bool changed = false;
+  for (uint8_t i = 0; i < SCHEDULE_MAX_BLOCKS; i++) {
+    auto& block = dst.blocks[i];
+    ScheduleSettings::Block value;
+
+    if (i < blocks.size()) {
+      const JsonVariantConst item = blocks[i];
+      value = block;
+
+      if (item[FPSTR(S_ENABLED)].is<bool>()) {
+        value.enabled = item[FPSTR(S_ENABLED)].as<bool>();
+      }
+
+      if (!item[FPSTR(S_DAYS)].isNull()) {
+        value.days = item[FPSTR(S_DAYS)].as<uint8_t>() & 0x7F;
+      }
+
+      if (!item[FPSTR(S_START)].isNull()) {
+        const uint16_t start = item[FPSTR(S_START)].as<uint16_t>();
+
+        if (start < 1440) {
+          value.start = start;
+        }
+      }
+
+      if (!item[FPSTR(S_TARGET)].isNull()) {
+        const float target = item[FPSTR(S_TARGET)].as<float>();
+
+        if (isValidTemp(target, unitSystem, THERMOSTAT_INDOOR_MIN_TEMP, THERMOSTAT_INDOOR_MAX_TEMP)) {
+          value.target = roundf(convertTemp(target, unitSystem, UnitSystem::METRIC), 2);
+        }
+      }
+    }
+
+    if (value.enabled != block.enabled || value.days != block.days || value.start != block.start
+      || fabsf(value.target - block.target) > 0.001f) {
+      block = value;
+      changed = true;
+    }
+  }
+
+  return changed;
+}
+
 void sensorResultToJson(const uint8_t sensorId, JsonVariant dst) {
   if (!Sensors::isValidSensorId(sensorId)) {
     return;
@@ -2195,6 +1528,7 @@ void varsToJson(const Variables& src, JsonVariant dst) {
   master[FPSTR(S_NETWORK)][FPSTR(S_CONNECTED)] = src.network.connected;
   master[FPSTR(S_NETWORK)][FPSTR(S_RSSI)] = src.network.rssi;
   master[FPSTR(S_MQTT)][FPSTR(S_CONNECTED)] = src.mqtt.connected;
+  master[FPSTR(S_MQTT)][FPSTR(S_DISCOVERY)] = src.mqtt.discoveryProgress;
   master[FPSTR(S_EMERGENCY)][FPSTR(S_STATE)] = src.emergency.state;
   master[FPSTR(S_EXTERNAL_PUMP)][FPSTR(S_STATE)] = src.externalPump.state;
 
@@ -2202,6 +1536,38 @@ void varsToJson(const Variables& src, JsonVariant dst) {
   mCascadeControl[FPSTR(S_INPUT)] = src.cascadeControl.input;
   mCascadeControl[FPSTR(S_OUTPUT)] = src.cascadeControl.output;
 
+  auto mPidAutotune = master[FPSTR(S_PID_AUTOTUNE)].to<JsonObject>();
+  mPidAutotune[FPSTR(S_STATE)] = src.pidAutotune.state;
+  mPidAutotune[FPSTR(S_PROGRESS)] = src.pidAutotune.progress;
+  mPidAutotune[FPSTR(S_CYCLES)] = src.pidAutotune.cycles;
+  mPidAutotune[FPSTR(S_ULTIMATE_GAIN)] = roundf(src.pidAutotune.ultimateGain, 3);
+  mPidAutotune[FPSTR(S_ULTIMATE_PERIOD)] = roundf(src.pidAutotune.ultimatePeriod, 0);
+  mPidAutotune[FPSTR(S_P_FACTOR)] = roundf(src.pidAutotune.p_factor, 3);
+  mPidAutotune[FPSTR(S_I_FACTOR)] = roundf(src.pidAutotune.i_factor, 4);
+  mPidAutotune[FPSTR(S_D_FACTOR)] = roundf(src.pidAutotune.d_factor, 1);
+
+  auto mEquithermLearning = master[FPSTR(S_EQUITHERM_LEARNING)].to<JsonObject>();
+  mEquithermLearning[FPSTR(S_SAMPLES)] = src.equithermLearning.samples;
+  mEquithermLearning[FPSTR(S_SLOPE)] = roundf(src.equithermLearning.slope, 3);
+  mEquithermLearning[FPSTR(S_SHIFT)] = roundf(src.equithermLearning.shift, 2);
+
+  auto mAntiCycling = master[FPSTR(S_ANTI_CYCLING)].to<JsonObject>();
+  mAntiCycling[FPSTR(S_LOCKOUT)] = src.antiCycling.lockout;
+  mAntiCycling[FPSTR(S_CYCLES)] = src.antiCycling.cycles;
+  mAntiCycling[FPSTR(S_LAST_ON_TIME)] = src.antiCycling.lastOnTime;
+  mAntiCycling[FPSTR(S_MIN_ON_TIME)] = src.antiCycling.minOnTime;
+  mAntiCycling[FPSTR(S_MODULATION)] = src.antiCycling.modulation;
+
+  auto mSchedule = master[FPSTR(S_SCHEDULE)].to<JsonObject>();
+  mSchedule[FPSTR(S_ACTIVE)] = src.schedule.active;
+  mSchedule[FPSTR(S_PREHEAT)] = src.schedule.preheat;
+  mSchedule[FPSTR(S_BLOCK)] = src.schedule.block;
+  mSchedule[FPSTR(S_TARGET)] = roundf(src.schedule.target, 2);
+  mSchedule[FPSTR(S_NEXT_TIME)] = src.schedule.nextTime;
+  mSchedule[FPSTR(S_NEXT_TARGET)] = roundf(src.schedule.nextTarget, 2);
+  mSchedule[FPSTR(S_PREHEAT_TIME)] = src.schedule.preheatTime;
+  mSchedule[FPSTR(S_HEAT_UP_RATE)] = roundf(src.schedule.heatUpRate, 2);
+
   master[FPSTR(S_UPTIME)] = millis() / 1000;
 }
 
@@ -2221,5 +1587,21 @@ bool jsonToVars(const JsonVariantConst src, Variables& dst) {
     dst.actions.resetDiagnostic = true;
   }
 
+  if (src[FPSTR(S_ACTIONS)][FPSTR(S_START_PID_AUTOTUNE)].is<bool>() && src[FPSTR(S_ACTIONS)][FPSTR(S_START_PID_AUTOTUNE)].as<bool>()) {
+    dst.actions.startPidAutotune = true;
+  }
+
+  if (src[FPSTR(S_ACTIONS)][FPSTR(S_STOP_PID_AUTOTUNE)].is<bool>() && src[FPSTR(S_ACTIONS)][FPSTR(S_STOP_PID_AUTOTUNE)].as<bool>()) {
+    dst.actions.stopPidAutotune = true;
+  }
+
+  if (src[FPSTR(S_ACTIONS)][FPSTR(S_APPLY_PID_AUTOTUNE)].is<bool>() && src[FPSTR(S_ACTIONS)][FPSTR(S_APPLY_PID_AUTOTUNE)].as<bool>()) {
+    dst.actions.applyPidAutotune = true;
+  }
+
+  if (src[FPSTR(S_ACTIONS)][FPSTR(S_APPLY_EQUITHERM_LEARNING)].is<bool>() && src[FPSTR(S_ACTIONS)][FPSTR(S_APPLY_EQUITHERM_LEARNING)].as<bool>()) {
+    dst.actions.applyEquithermLearning = true;
+  }
+
   return changed;
 }
\ No newline at end of file
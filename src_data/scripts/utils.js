@@ -310,80 +310,28 @@ const setupRestoreBackupForm = (formSelector) => {
       return;
     }
 
-    let reader = new FileReader();
-    reader.readAsText(files[0]);
-    reader.onload = async (event) => {
-      try {
-        const data = JSON.parse(event.target.result);
-        console.log("Backup: ", data);
-
-        if (data.settings != undefined) {
-          let response = await fetch(url, {
-            method: "POST",
-            cache: "no-cache",
-            credentials: "include",
-            headers: {
-              "Content-Type": "application/json"
-            },
-            body: JSON.stringify({"settings": data.settings})
-          });
-
-          if (!response.ok) {
-            onFailed();
-            return;
-          }
-        }
-
-        if (data.sensors != undefined) {
-          for (const sensorId in data.sensors) {
-            const payload = {
-              "sensors": {}
-            };
-            payload["sensors"][sensorId] = data.sensors[sensorId];
-
-            const response = await fetch(url, {
-              method: "POST",
-              cache: "no-cache",
-              credentials: "include",
-              headers: {
-                "Content-Type": "application/json"
-              },
-              body: JSON.stringify(payload)
-            });
-
-            if (!response.ok) {
-              onFailed();
-              return;
-            }
-          }
-        }
-
-        if (data.network != undefined) {
-          let response = await fetch(url, {
-            method: "POST",
-            cache: "no-cache",
-            credentials: "include",
-            headers: {
-              "Content-Type": "application/json"
-            },
-            body: JSON.stringify({"network": data.network})
-          });
-
-          if (!response.ok) {
-            onFailed();
-            return;
-          }
-        }
-
-        onSuccess();
+    // the file is sent as is, the device parses and applies it section by section
+    try {
+      const response = await fetch(url, {
+        method: "POST",
+        cache: "no-cache",
+        credentials: "include",
+        headers: {
+          "Content-Type": "application/json"
+        },
+        body: files[0]
+      });
 
-      } catch (err) {
+      if (!response.ok) {
         onFailed();
+        return;
       }
-    };
-    reader.onerror = () => {
-      console.log(reader.error);
-    };
+
+      onSuccess();
+
+    } catch (err) {
+      onFailed();
+    }
   });
 }
 
@@ -415,6 +363,8 @@ const setupUpgradeForm = (formSelector) => {
         return "Error on write";
       case 7:
         return "Error on finish";
+      case 8:
+        return "Verification failed";
       default:
         return "Unknown";
     }
@@ -862,6 +812,21 @@ function form2json(data, noCastItems = []) {
   return JSON.stringify(object);
 }
 
+function mergeDeep(target, source) {
+  for (const key in source) {
+    const value = source[key];
+
+    if (value instanceof Object && !Array.isArray(value) && target[key] instanceof Object) {
+      mergeDeep(target[key], value);
+
+    } else {
+      target[key] = value;
+    }
+  }
+
+  return target;
+}
+
 function dec2hex(i) {
   let hex = parseInt(i).toString(16);
   if (hex.length % 2 != 0) {
@@ -0,0 +1,93 @@
+// BufferedWebServer: socket writes and throughput of an /api/settings response,
+// against the previous writer that measured the document and flushed every 32 bytes.
+#define ARDUINO_ARCH_ESP8266
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WebServer.h>
+#include <BufferedWebServer.h>
+#include <chrono>
+#include "fixtures.h"
+
+// the writer before user-033: measure for Content-Length, then serialize into a 32 b buffer
+class LegacyBufferedWebServer {
+public:
+  LegacyBufferedWebServer(WebServer* webServer, size_t bufferSize = 32) : webServer(webServer), bufferSize(bufferSize) {
+    this->buffer = (uint8_t*) malloc(bufferSize);
+  }
+
+  ~LegacyBufferedWebServer() {
+    free(this->buffer);
+  }
+
+  void send(int code, const char* contentType, const JsonVariantConst content, bool = false, bool = false) {
+    this->webServer->chunkedResponseModeStart(code, contentType);
+    this->webServer->setContentLength(measureJson(content));
+    serializeJson(content, *this);
+    this->flush();
+    this->webServer->chunkedResponseFinalize();
+  }
+
+  size_t write(uint8_t c) {
+    this->buffer[this->bufferPos++] = c;
+
+    if (this->bufferPos >= this->bufferSize) {
+      this->flush();
+    }
+
+    return 1;
+  }
+
+  void flush() {
+    if (this->bufferPos == 0) {
+      return;
+    }
+
+    this->webServer->sendContent((const char*) this->buffer, this->bufferPos);
+    this->bufferPos = 0;
+  }
+
+protected:
+  WebServer* webServer;
+  uint8_t* buffer;
+  size_t bufferSize;
+  size_t bufferPos = 0;
+};
+
+template <class W>
+void run(const char* name, WebServer& server, W& writer, const JsonVariantConst doc, bool gzip) {
+  const unsigned long responses = 5000;
+  server.acceptEncoding = gzip ? "gzip, deflate" : "";
+  server.resetStats();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < responses; i++) {
+    writer.send(200, "application/json", doc, false, gzip);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf(
+    "%-24s %5zu bytes on wire  %5.1f writes/response  %7.1f MB/s of json\n",
+    name, server.bytes / responses, (double) server.chunks / responses,
+    measureJson(doc) * responses / elapsed.count() / 1e6
+  );
+}
+
+int main() {
+  const JsonVariantConst doc(SETTINGS_JSON);
+  WebServer server;
+
+  printf("/api/settings, %zu bytes of json\n", measureJson(doc));
+
+  {
+    LegacyBufferedWebServer writer(&server);
+    run("before (32 b buffer)", server, writer, doc, false);
+  }
+
+  {
+    BufferedWebServer writer(&server);
+    run("after (mss chunks)", server, writer, doc, false);
+    run("after, gzip", server, writer, doc, true);
+  }
+
+  return 0;
+}
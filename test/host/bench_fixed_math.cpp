@@ -0,0 +1,72 @@
+// Equitherm curve: FixedMath::mulPowRatio() against powf(), per call.
+// The host has an FPU, the numbers only compare the two paths on the same machine,
+// on the ESP8266 and ESP32-C3 powf() is emulated in software.
+#include <Arduino.h>
+#include <FixedMath.h>
+#include <chrono>
+#include <vector>
+
+struct Input {
+  float range;
+  float delta;
+  float maxDelta;
+  float exponent;
+};
+
+// the inputs of RegulatorTask::getEquithermCurveTemp() over the usual settings
+static std::vector<Input> makeInputs() {
+  std::vector<Input> result;
+
+  for (float maxTemp : {50.0f, 60.0f, 80.0f}) {
+    for (float slope : {0.7f, 1.0f, 1.5f, 2.5f}) {
+      for (float exponent : {1.0f, 1.3f, 1.6f, 2.0f}) {
+        for (float outdoorTemp = -25.0f; outdoorTemp <= 20.0f; outdoorTemp += 0.5f) {
+          const float range = maxTemp - 21.5f;
+          result.push_back({range, fabsf(21.5f - outdoorTemp), range / slope, exponent});
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+template <class F>
+static double run(const char* name, const std::vector<Input>& inputs, F callback) {
+  const unsigned long rounds = 2000;
+  volatile float sink = 0.0f;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < rounds; i++) {
+    for (const Input& input : inputs) {
+      sink = sink + callback(input);
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  const double result = elapsed.count() * 1e9 / (rounds * inputs.size());
+
+  printf("%-28s %6.1f ns/call\n", name, result);
+  return result;
+}
+
+int main() {
+  const std::vector<Input> inputs = makeInputs();
+  printf("equitherm curve, %zu inputs\n", inputs.size());
+
+  const double floatTime = run("powf", inputs, [](const Input& input) {
+    return input.range * powf(input.delta / input.maxDelta, 1.0f / input.exponent);
+  });
+
+  // as in the regulator: the conversions and the exponent division are part of the call
+  const double fixedTime = run("FixedMath::mulPowRatio", inputs, [](const Input& input) {
+    return FixedMath::toFloat(FixedMath::mulPowRatio(
+      FixedMath::fromFloat(input.range),
+      FixedMath::fromFloat(input.delta),
+      FixedMath::fromFloat(input.maxDelta),
+      FixedMath::div(FixedMath::ONE, FixedMath::fromFloat(input.exponent))
+    ));
+  });
+
+  printf("fixed / float: %.2f\n", fixedTime / floatTime);
+  return 0;
+}
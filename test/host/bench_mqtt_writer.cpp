@@ -0,0 +1,92 @@
+// MqttWriter: socket calls and throughput per published message,
+// against the previous writer that flushed every buffered chunk.
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <MqttWriter.h>
+#include <chrono>
+#include "fixtures.h"
+
+// the writer before user-028: 256 byte buffer, write + flush per chunk
+class LegacyMqttWriter {
+public:
+  LegacyMqttWriter(MqttClient* client, size_t bufferSize = 256) : client(client), bufferSize(bufferSize) {
+    this->buffer = (uint8_t*) malloc(bufferSize);
+  }
+
+  ~LegacyMqttWriter() {
+    free(this->buffer);
+  }
+
+  bool publish(const char* topic, const JsonVariantConst doc, bool retained = false) {
+    this->bufferPos = 0;
+    this->client->beginMessage(topic, measureJson(doc), retained);
+    serializeJson(doc, *this);
+    this->flush();
+
+    return this->client->endMessage();
+  }
+
+  size_t write(uint8_t c) {
+    this->buffer[this->bufferPos++] = c;
+
+    if (this->bufferPos >= this->bufferSize) {
+      this->flush();
+    }
+
+    return 1;
+  }
+
+  void flush() {
+    if (this->bufferPos == 0) {
+      return;
+    }
+
+    this->client->write(this->buffer, this->bufferPos);
+    this->client->flush();
+    this->bufferPos = 0;
+  }
+
+protected:
+  MqttClient* client;
+  uint8_t* buffer;
+  size_t bufferSize;
+  size_t bufferPos = 0;
+};
+
+template <class W>
+void run(const char* name, MqttClient& client, W& writer, const JsonVariantConst doc) {
+  const unsigned long messages = 20000;
+  client.resetStats();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < messages; i++) {
+    writer.publish("opentherm/state", doc);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf(
+    "%-22s %5zu bytes  %6.1f writes/msg  %5.1f flushes/msg  %9.0f msg/s\n",
+    name, client.bytes / client.messages,
+    (double) client.writes / client.messages, (double) client.flushes / client.messages,
+    messages / elapsed.count()
+  );
+}
+
+int main() {
+  const JsonVariantConst doc(STATE_JSON);
+  MqttClient client;
+
+  printf("state document, %zu bytes, TCP_MSS %d\n", measureJson(doc), TCP_MSS);
+
+  {
+    LegacyMqttWriter writer(&client);
+    run("before (256 b buffer)", client, writer, doc);
+  }
+
+  {
+    MqttWriter writer(&client);
+    run("after (mss buffer)", client, writer, doc);
+  }
+
+  return 0;
+}
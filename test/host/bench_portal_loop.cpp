@@ -0,0 +1,97 @@
+// PortalTask request draining: a discrete event model of the task loop,
+// the core WebServer itself can not be built for the host.
+//
+// Every handleClient() serves at most one queued request, after the portal pass
+// the other tasks hold the cpu before the portal runs again (cooperative scheduler).
+// Clients load a dashboard: a chain of requests, each sent one rtt after the previous response.
+#include <Arduino.h>
+#include <cstdio>
+#include <deque>
+#include <vector>
+#include "../../src/defines.h"
+
+struct Model {
+  double serviceTime = 8.0;  // ms per request in the handlers
+  double otherTasks = 25.0;  // ms the other tasks take between portal passes
+  double rtt = 5.0;          // ms
+  unsigned int requestsPerPage = 10;
+};
+
+struct Result {
+  double requestsPerSecond;
+  double pageLoadTime;
+};
+
+Result simulate(const Model& model, unsigned int clients, unsigned int maxRequestsPerLoop) {
+  struct Client {
+    unsigned int done = 0;
+    double readyAt = 0.0;
+    double finishedAt = 0.0;
+  };
+
+  std::vector<Client> list(clients);
+  std::deque<unsigned int> queue;
+  double now = 0.0;
+  unsigned int finished = 0;
+  unsigned int served = 0;
+
+  while (finished < clients) {
+    // requests that arrived by now, in arrival order
+    for (unsigned int i = 0; i < clients; i++) {
+      Client& client = list[i];
+
+      if (client.done < model.requestsPerPage && client.readyAt >= 0.0 && client.readyAt <= now) {
+        queue.push_back(i);
+        client.readyAt = -1.0;
+      }
+    }
+
+    // portal pass
+    for (unsigned int n = 0; n < maxRequestsPerLoop && !queue.empty(); n++) {
+      Client& client = list[queue.front()];
+      queue.pop_front();
+
+      now += model.serviceTime;
+      served++;
+
+      if (++client.done == model.requestsPerPage) {
+        client.finishedAt = now;
+        finished++;
+
+      } else {
+        client.readyAt = now + model.rtt;
+      }
+    }
+
+    // the rest of the scheduler round
+    now += model.otherTasks;
+  }
+
+  double pageLoadTime = 0.0;
+  for (const Client& client : list) {
+    pageLoadTime += client.finishedAt;
+  }
+
+  return {served / now * 1000.0, pageLoadTime / clients};
+}
+
+int main() {
+  const Model model;
+  printf(
+    "service %.0f ms, other tasks %.0f ms per round, rtt %.0f ms, %u requests per page\n",
+    model.serviceTime, model.otherTasks, model.rtt, model.requestsPerPage
+  );
+
+  for (unsigned int clients : {1u, 2u, 4u}) {
+    const Result before = simulate(model, clients, 1);
+    const Result after = simulate(model, clients, PORTAL_MAX_REQUESTS_PER_LOOP);
+
+    printf(
+      "%u clients: 1 request per pass %5.1f req/s, page %5.0f ms | %u per pass %5.1f req/s, page %5.0f ms\n",
+      clients, before.requestsPerSecond, before.pageLoadTime,
+      (unsigned int) PORTAL_MAX_REQUESTS_PER_LOOP, after.requestsPerSecond, after.pageLoadTime
+    );
+  }
+
+  return 0;
+}
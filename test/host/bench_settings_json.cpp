@@ -0,0 +1,372 @@
+// Settings json: the table-driven jsonToSettings()/settingsToJson() of user-041 against the
+// hand-written ones they replaced, on /api/settings. ArduinoJson is not built on the host,
+// so both run on a document with its object model: members in a linked list, lookup by key
+// is a linear scan. Key comparisons are counted, they dominate on the target.
+#include <Arduino.h>
+#include <TinyLogger.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "fixtures.h"
+
+#define DEFAULT_LOG_LEVEL 5
+#include "../../src/defines.h"
+#include "../../src/strings.h"
+
+// only what Settings.h needs from Sensors.h, the sensors are not part of Settings
+class Sensors {
+public:
+  enum class Type : uint8_t {
+    OT_OUTDOOR_TEMP, OT_HEATING_TEMP, OT_HEATING_RETURN_TEMP, OT_DHW_TEMP, OT_DHW_FLOW_RATE,
+    OT_EXHAUST_TEMP, OT_PRESSURE, OT_MODULATION_LEVEL, OT_CURRENT_POWER, DALLAS_TEMP, HEATING_SETPOINT_TEMP
+  };
+
+  enum class Purpose : uint8_t {
+    OUTDOOR_TEMP, INDOOR_TEMP, HEATING_TEMP, HEATING_RETURN_TEMP, DHW_TEMP, DHW_FLOW_RATE,
+    EXHAUST_TEMP, MODULATION_LEVEL, POWER, PRESSURE, TEMPERATURE
+  };
+
+  typedef struct {
+    bool enabled;
+    char name[33];
+    Purpose purpose;
+    Type type;
+    uint8_t gpio;
+  } Settings;
+};
+
+#include "../../src/Settings.h"
+#include "../../src/SettingsSchema.h"
+
+static unsigned long keyCompares = 0;
+
+struct Node {
+  std::string key;
+  std::string value;
+  bool object = false;
+  Node* child = nullptr;
+  Node* next = nullptr;
+};
+
+// nodes of one document, released at once as with a JsonDocument
+class Document {
+public:
+  ~Document() {
+    this->clear();
+  }
+
+  Node* create() {
+    this->nodes.push_back(new Node());
+    return this->nodes.back();
+  }
+
+  void clear() {
+    for (Node* node : this->nodes) {
+      delete node;
+    }
+    this->nodes.clear();
+  }
+
+protected:
+  std::vector<Node*> nodes;
+};
+
+static Node* find(const Node* object, const char* key) {
+  if (object == nullptr || !object->object) {
+    return nullptr;
+  }
+
+  for (Node* member = object->child; member != nullptr; member = member->next) {
+    keyCompares++;
+    if (strcmp(member->key.c_str(), key) == 0) {
+      return member;
+    }
+  }
+
+  return nullptr;
+}
+
+// obj[key] of a JsonObject: lookup, then append
+static Node* findOrAdd(Document& doc, Node* object, const char* key) {
+  Node* last = nullptr;
+  for (Node* member = object->child; member != nullptr; member = member->next) {
+    keyCompares++;
+    if (strcmp(member->key.c_str(), key) == 0) {
+      return member;
+    }
+
+    last = member;
+  }
+
+  Node* member = doc.create();
+  member->key = key;
+  (last != nullptr ? last->next : object->child) = member;
+
+  return member;
+}
+
+// just enough for the fixture: objects, strings without escapes, scalars
+static Node* parse(Document& doc, const char*& json) {
+  Node* node = doc.create();
+
+  if (*json != '{') {
+    const char* start = json;
+    if (*json == '"') {
+      start = ++json;
+      while (*json != '"') {
+        json++;
+      }
+      node->value.assign(start, json++ - start);
+
+    } else {
+      while (*json != ',' && *json != '}') {
+        json++;
+      }
+      node->value.assign(start, json - start);
+    }
+
+    return node;
+  }
+
+  node->object = true;
+  Node* last = nullptr;
+  json++;
+
+  while (*json != '}') {
+    const char* key = ++json;
+    while (*json != '"') {
+      json++;
+    }
+    const size_t keyLength = json - key;
+    json += 2;
+
+    Node* member = parse(doc, json);
+    member->key.assign(key, keyLength);
+    (last != nullptr ? last->next : node->child) = member;
+    last = member;
+
+    if (*json == ',') {
+      json++;
+    }
+  }
+
+  json++;
+  return node;
+}
+
+static float readValue(const Node* node) {
+  return node != nullptr ? strtof(node->value.c_str(), nullptr) : 0.0f;
+}
+
+static Node* lookup(const Node* root, const SettingsField& field) {
+  Node* node = find(root, field.path[0]);
+  for (uint8_t level = 1; level < getSettingsFieldDepth(field); level++) {
+    node = find(node, field.path[level]);
+  }
+
+  return node;
+}
+
+// before user-041: `if (!src[a][b].isNull()) value = src[a][b].as<T>()`, every access walks from the root
+static unsigned legacyJsonToSettings(const Node* root) {
+  SettingsField field;
+  unsigned found = 0;
+
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    getSettingsField(i, field);
+
+    if (lookup(root, field) != nullptr) {
+      readValue(lookup(root, field));
+      found++;
+    }
+  }
+
+  return found;
+}
+
+// jsonToSettingsFields(): one walk, each member is matched against the descriptors of its parent only
+static unsigned tableJsonToSettingsFields(const Node* object, uint8_t depth, uint8_t begin, uint8_t end) {
+  unsigned found = 0;
+
+  for (const Node* member = object->child; member != nullptr; member = member->next) {
+    uint8_t first = end;
+    uint8_t last = end;
+    for (uint8_t i = begin; i < end; i++) {
+      const char* part = settingsFields[i].path[depth];
+
+      keyCompares++;
+      if (part != nullptr && strcmp_P(member->key.c_str(), part) == 0) {
+        if (first == end) {
+          first = i;
+        }
+
+        last = i + 1;
+
+      } else if (first != end) {
+        break;
+      }
+    }
+
+    if (first == end) {
+      continue;
+    }
+
+    if (member->object) {
+      if (depth < 2) {
+        found += tableJsonToSettingsFields(member, depth + 1, first, last);
+      }
+
+      continue;
+    }
+
+    SettingsField field;
+    getSettingsField(first, field);
+
+    if (getSettingsFieldDepth(field) != depth + 1 || field.flags & SETTINGS_FIELD_MANUAL) {
+      continue;
+    }
+
+    readValue(member);
+    found++;
+  }
+
+  return found;
+}
+
+// the MANUAL fields are still parsed by hand, as before
+static unsigned tableJsonToSettings(const Node* root) {
+  unsigned found = tableJsonToSettingsFields(root, 0, 0, settingsFieldsAmount);
+  SettingsField field;
+
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    getSettingsField(i, field);
+
+    if (field.flags & SETTINGS_FIELD_MANUAL && lookup(root, field) != nullptr) {
+      readValue(lookup(root, field));
+      found++;
+    }
+  }
+
+  return found;
+}
+
+static void writeValue(Node* node, const Settings& src, const SettingsField& field) {
+  const uint8_t* ptr = reinterpret_cast<const uint8_t*>(&src) + field.offset;
+  char buffer[16];
+
+  switch (field.type) {
+    case SettingsFieldType::STRING:
+      node->value = reinterpret_cast<const char*>(ptr);
+      break;
+
+    case SettingsFieldType::FLOAT:
+      snprintf(buffer, sizeof(buffer), "%.*f", field.size, *reinterpret_cast<const float*>(ptr));
+      node->value = buffer;
+      break;
+
+    default:
+      snprintf(buffer, sizeof(buffer), "%u", *ptr);
+      node->value = buffer;
+  }
+}
+
+// before user-041: each object is created once in a local (`auto system = dst[S_SYSTEM].to<JsonObject>()`),
+// fields are assigned to it, the compiler knows every field
+static void legacySettingsToJson(Document& doc, Node* root, const Settings& src) {
+  const char* parentKeys[2] = {nullptr, nullptr};
+  Node* parents[2] = {nullptr, nullptr};
+
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    const SettingsField& field = settingsFields[i];
+    const uint8_t depth = getSettingsFieldDepth(field);
+
+    Node* parent = root;
+    for (uint8_t level = 0; level < depth - 1; level++) {
+      if (parentKeys[level] != field.path[level]) {
+        parentKeys[level] = field.path[level];
+        parents[level] = findOrAdd(doc, parent, field.path[level]);
+        parents[level]->object = true;
+
+        if (level == 0) {
+          parentKeys[1] = nullptr;
+        }
+      }
+
+      parent = parents[level];
+    }
+
+    writeValue(findOrAdd(doc, parent, field.path[depth - 1]), src, field);
+  }
+}
+
+// settingsToJson(): the same objects, the descriptors are copied from flash
+static void tableSettingsToJson(Document& doc, Node* root, const Settings& src) {
+  const char* parentKeys[2] = {nullptr, nullptr};
+  Node* parents[2] = {nullptr, nullptr};
+  SettingsField field;
+
+  for (uint8_t i = 0; i < settingsFieldsAmount; i++) {
+    getSettingsField(i, field);
+    const uint8_t depth = getSettingsFieldDepth(field);
+
+    Node* parent = root;
+    for (uint8_t level = 0; level < depth - 1; level++) {
+      if (parentKeys[level] != field.path[level]) {
+        parentKeys[level] = field.path[level];
+        parents[level] = findOrAdd(doc, parent, field.path[level]);
+        parents[level]->object = true;
+
+        if (level == 0) {
+          parentKeys[1] = nullptr;
+        }
+      }
+
+      parent = parents[level];
+    }
+
+    writeValue(findOrAdd(doc, parent, field.path[depth - 1]), src, field);
+  }
+}
+
+template <class F>
+static void run(const char* name, F callback) {
+  const unsigned long iterations = 20000;
+  keyCompares = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  unsigned found = 0;
+  for (unsigned long i = 0; i < iterations; i++) {
+    found = callback();
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf(
+    "%-28s %3u fields  %6lu key compares  %7.2f us\n",
+    name, found, keyCompares / iterations, elapsed.count() * 1e6 / iterations
+  );
+}
+
+int main() {
+  Document input;
+  const char* json = SETTINGS_JSON;
+  const Node* root = parse(input, json);
+
+  printf("/api/settings, %zu bytes of json, %u fields in the table\n", strlen(SETTINGS_JSON), settingsFieldsAmount);
+
+  run("jsonToSettings, legacy", [root]() { return legacyJsonToSettings(root); });
+  run("jsonToSettings, table", [root]() { return tableJsonToSettings(root); });
+
+  Document output;
+  run("settingsToJson, legacy", [&output]() {
+    output.clear();
+    legacySettingsToJson(output, output.create(), settings);
+    return (unsigned) settingsFieldsAmount;
+  });
+  run("settingsToJson, table", [&output]() {
+    output.clear();
+    tableSettingsToJson(output, output.create(), settings);
+    return (unsigned) settingsFieldsAmount;
+  });
+
+  return 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// Compact json of a typical state topic and /api/settings response
+
+// 1530 bytes
+static const char STATE_JSON[] =
+  "{\"slave\":{\"memberId\":0,\"flags\":0,\"type\":0,\"appVersion\":0,\"protocolVersion\":2.2,\"connected\":true,\"fla"
+  "me\":true,\"cooling\":false,\"modulation\":{\"current\":42,\"min\":0,\"max\":100},\"power\":{\"current\":9.8,\"min\":"
+  "3.5,\"max\":24},\"heating\":{\"active\":true,\"setpointTemp\":48,\"minTemp\":20,\"maxTemp\":80,\"currentTemp\":47."
+  "3,\"returnTemp\":38.1},\"dhw\":{\"active\":false,\"targetTemp\":45,\"minTemp\":30,\"maxTemp\":60,\"currentTemp\":4"
+  "4.8},\"fault\":{\"active\":false,\"code\":0},\"diag\":{\"active\":false,\"code\":0}},\"master\":{\"heating\":{\"enabl"
+  "ed\":true,\"blocking\":false,\"indoorTempControl\":true,\"overheat\":false,\"freezing\":false,\"setpointTemp\":"
+  "48,\"targetTemp\":21.5,\"currentTemp\":47.3,\"returnTemp\":38.1,\"indoorTemp\":21.27,\"outdoorTemp\":-3.5,\"min"
+  "Temp\":5,\"maxTemp\":40},\"dhw\":{\"enabled\":true,\"overheat\":false,\"targetTemp\":45,\"currentTemp\":44.8,\"ret"
+  "urnTemp\":0,\"minTemp\":30,\"maxTemp\":60},\"network\":{\"connected\":true,\"rssi\":-61},\"mqtt\":{\"connected\":tr"
+  "ue},\"emergency\":{\"state\":false},\"externalPump\":{\"state\":false},\"cascadeControl\":{\"input\":false,\"outp"
+  "ut\":false},\"pidAutotune\":{\"state\":0,\"progress\":0,\"cycles\":0,\"ultimateGain\":0,\"ultimatePeriod\":0,\"p_f"
+  "actor\":0,\"i_factor\":0,\"d_factor\":0},\"equithermLearning\":{\"samples\":31,\"slope\":0.742,\"shift\":0.35},\"a"
+  "ntiCycling\":{\"lockout\":false,\"cycles\":3,\"modulation\":38,\"lastOnTime\":1260,\"minOnTime\":840},\"schedule"
+  "\":{\"active\":true,\"preheat\":false,\"block\":2,\"target\":21.5,\"nextTime\":1792483200,\"nextTarget\":18,\"preh"
+  "eatTime\":0,\"heatUpRate\":1.84},\"uptime\":1284735,\"freeHeap\":23412,\"maxFreeBlockHeap\":11240,\"resetReaso"
+  "n\":\"Software/System restart\"}}";
+
+// 2318 bytes
+static const char SETTINGS_JSON[] =
+  "{\"system\":{\"logLevel\":5,\"serial\":{\"enabled\":true,\"baudrate\":115200},\"telnet\":{\"enabled\":true,\"port\":"
+  "23},\"ntp\":{\"server\":\"pool.ntp.org\",\"timezone\":\"CET-1CEST,M3.5.0,M10.5.0/3\"},\"unitSystem\":0,\"statusLe"
+  "dGpio\":2},\"portal\":{\"auth\":false,\"login\":\"admin\",\"password\":\"admin\",\"mdns\":true},\"opentherm\":{\"unitS"
+  "ystem\":0,\"inGpio\":4,\"outGpio\":5,\"rxLedGpio\":2,\"memberId\":0,\"flags\":0,\"minPower\":3.5,\"maxPower\":24,\"o"
+  "ptions\":{\"dhwSupport\":false,\"coolingSupport\":false,\"summerWinterMode\":false,\"heatingStateToSummerWin"
+  "terMode\":false,\"ch2AlwaysEnabled\":false,\"heatingToCh2\":false,\"dhwToCh2\":false,\"dhwBlocking\":false,\"d"
+  "hwStateAsDhwBlocking\":false,\"maxTempSyncWithTargetTemp\":false,\"getMinMaxTemp\":false,\"ignoreDiagState"
+  "\":false,\"autoFaultReset\":false,\"autoDiagReset\":false,\"setDateAndTime\":false,\"alwaysSendIndoorTemp\":f"
+  "alse,\"nativeOTC\":false,\"immergasFix\":false}},\"mqtt\":{\"enabled\":true,\"server\":\"192.168.1.10\",\"port\":1"
+  "883,\"user\":\"otgateway\",\"password\":\"secret\",\"prefix\":\"opentherm\",\"interval\":5,\"homeAssistantDiscovery"
+  "\":true},\"emergency\":{\"target\":55,\"tresholdTime\":120},\"heating\":{\"enabled\":true,\"turbo\":false,\"target"
+  "\":21.5,\"turboFactor\":7.5,\"minTemp\":20,\"maxTemp\":80,\"maxModulation\":100,\"hysteresis\":{\"enabled\":true,"
+  "\"value\":0.5,\"action\":0},\"overheatProtection\":{\"highTemp\":95,\"lowTemp\":90},\"freezeProtection\":{\"highT"
+  "emp\":15,\"lowTemp\":10},\"antiCycling\":{\"enabled\":true,\"maxCycles\":6,\"minOnTime\":5,\"minOffTime\":10},\"sc"
+  "hedule\":{\"enabled\":true,\"optimumStart\":true,\"maxPreheatTime\":3}},\"dhw\":{\"enabled\":true,\"target\":45,\""
+  "minTemp\":30,\"maxTemp\":60,\"maxModulation\":100,\"overheatProtection\":{\"highTemp\":95,\"lowTemp\":90}},\"pid"
+  "\":{\"enabled\":true,\"p_factor\":2,\"i_factor\":0.002,\"d_factor\":0,\"dt\":300,\"minTemp\":0,\"maxTemp\":80,\"dead"
+  "band\":{\"enabled\":true,\"p_multiplier\":1,\"i_multiplier\":0.05,\"d_multiplier\":1,\"thresholdHigh\":0.5,\"thr"
+  "esholdLow\":1}},\"equitherm\":{\"enabled\":true,\"slope\":0.7,\"exponent\":1.3,\"shift\":0,\"targetDiffFactor\":2"
+  ",\"learning\":{\"enabled\":true,\"autoApply\":false}},\"externalPump\":{\"use\":false,\"gpio\":255,\"invertState\""
+  ":false,\"postCirculationTime\":600,\"antiStuckInterval\":2592000,\"antiStuckTime\":300},\"cascadeControl\":{"
+  "\"input\":{\"enabled\":false,\"gpio\":255,\"invertState\":false,\"thresholdTime\":60},\"output\":{\"enabled\":fals"
+  "e,\"gpio\":255,\"invertState\":false,\"thresholdTime\":60,\"onFault\":true,\"onLossConnection\":true,\"onEnable"
+  "dHeating\":false}}}";
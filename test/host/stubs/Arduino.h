@@ -0,0 +1,142 @@
+#pragma once
+// Minimal Arduino core for host builds of the header-only libs
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define FPSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*) (addr))
+#define pgm_read_word(addr) (*(const uint16_t*) (addr))
+#define pgm_read_dword(addr) (*(const uint32_t*) (addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define snprintf_P snprintf
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+using std::min;
+using std::max;
+
+template <class T, class L, class H>
+inline T constrain(T value, L low, H high) {
+  return value < low ? (T) low : (value > high ? (T) high : value);
+}
+
+// the clock is driven by the tests
+inline unsigned long& hostMillis() {
+  static unsigned long value = 0;
+  return value;
+}
+
+inline unsigned long millis() {
+  return hostMillis();
+}
+
+inline void delay(unsigned long ms) {
+  hostMillis() += ms;
+}
+
+inline void yield() {}
+inline void optimistic_yield(uint32_t) {}
+
+class String {
+public:
+  String() = default;
+  String(const char* value) : value(value != nullptr ? value : "") {}
+
+  inline const char* c_str() const {
+    return this->value.c_str();
+  }
+
+  inline size_t length() const {
+    return this->value.length();
+  }
+
+  inline int indexOf(const char* needle) const {
+    const size_t pos = this->value.find(needle);
+    return pos == std::string::npos ? -1 : (int) pos;
+  }
+
+  inline bool equals(const char* other) const {
+    return this->value == other;
+  }
+
+  inline char operator[](size_t index) const {
+    return index < this->value.length() ? this->value[index] : 0;
+  }
+
+  inline void clear() {
+    this->value.clear();
+  }
+
+  inline long toInt() const {
+    return strtol(this->value.c_str(), nullptr, 10);
+  }
+
+  String& operator+=(const char* other) {
+    this->value += other;
+    return *this;
+  }
+
+  String& operator+=(const String& other) {
+    this->value += other.value;
+    return *this;
+  }
+
+  String& operator+=(unsigned long number) {
+    this->value += std::to_string(number);
+    return *this;
+  }
+
+  friend String operator+(const String& left, const char* right) {
+    String result(left);
+    result += right;
+    return result;
+  }
+
+  friend bool operator<(const String& left, const String& right) {
+    return left.value < right.value;
+  }
+
+protected:
+  std::string value;
+};
+
+static const String emptyString;
+
+class Print {
+public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t c) = 0;
+
+  virtual size_t write(const uint8_t* buffer, size_t length) {
+    size_t written = 0;
+    while (length--) {
+      written += this->write(*buffer++);
+    }
+
+    return written;
+  }
+
+  size_t print(const char* value) {
+    return this->write((const uint8_t*) value, strlen(value));
+  }
+
+  size_t print(char value) {
+    return this->write((uint8_t) value);
+  }
+
+  virtual void flush() {}
+};
@@ -0,0 +1,39 @@
+#pragma once
+// Stand-in for ArduinoJson in the host builds: a "document" is its serialized text.
+// Bytes are handed to the writer one by one, the way the json serializer does it.
+#include <Arduino.h>
+
+class JsonVariantConst {
+public:
+  JsonVariantConst(const char* json = "") : json(json) {}
+
+  inline const char* c_str() const {
+    return this->json;
+  }
+
+protected:
+  const char* json;
+};
+
+inline size_t measureJson(const JsonVariantConst& doc) {
+  return strlen(doc.c_str());
+}
+
+inline size_t measureJsonPretty(const JsonVariantConst& doc) {
+  return measureJson(doc);
+}
+
+template <class W>
+size_t serializeJson(const JsonVariantConst& doc, W& writer) {
+  size_t written = 0;
+  for (const char* c = doc.c_str(); *c; c++) {
+    written += writer.write((uint8_t) *c);
+  }
+
+  return written;
+}
+
+template <class W>
+size_t serializeJsonPretty(const JsonVariantConst& doc, W& writer) {
+  return serializeJson(doc, writer);
+}
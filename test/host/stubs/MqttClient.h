@@ -0,0 +1,54 @@
+#pragma once
+// Broker stand-in: counts the socket calls a message costs
+#include <Arduino.h>
+
+class MqttClient {
+public:
+  size_t writes = 0;
+  size_t flushes = 0;
+  size_t bytes = 0;
+  size_t messages = 0;
+  bool isConnected = true;
+
+  void resetStats() {
+    this->writes = 0;
+    this->flushes = 0;
+    this->bytes = 0;
+    this->messages = 0;
+  }
+
+  inline int connected() {
+    return this->isConnected;
+  }
+
+  // the fixed header and the topic go out in one write
+  int beginMessage(const char* topic, unsigned long size, bool retain = false, uint8_t qos = 0, bool dup = false) {
+    (void) size; (void) retain; (void) qos; (void) dup;
+    this->writes++;
+    this->bytes += 5 + strlen(topic);
+
+    return 1;
+  }
+
+  int beginMessage(const char* topic, bool retain = false, uint8_t qos = 0, bool dup = false) {
+    return this->beginMessage(topic, 0ul, retain, qos, dup);
+  }
+
+  int endMessage() {
+    this->messages++;
+
+    return 1;
+  }
+
+  size_t write(const uint8_t* buffer, size_t length) {
+    (void) buffer;
+    this->writes++;
+    this->bytes += length;
+
+    return length;
+  }
+
+  void flush() {
+    this->flushes++;
+  }
+};
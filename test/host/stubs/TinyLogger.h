@@ -0,0 +1,20 @@
+#pragma once
+// Logger of the firmware, the host builds discard the messages
+#include <Arduino.h>
+
+class TinyLogger {
+public:
+  enum Level : uint8_t {
+    SILENT, FATAL, ERROR, WARNING, NOTICE, INFO, TRACE, VERBOSE
+  };
+
+  template <class... Args> void sfatalln(Args...) {}
+  template <class... Args> void serrorln(Args...) {}
+  template <class... Args> void swarningln(Args...) {}
+  template <class... Args> void snoticeln(Args...) {}
+  template <class... Args> void sinfoln(Args...) {}
+  template <class... Args> void straceln(Args...) {}
+  template <class... Args> void sverboseln(Args...) {}
+};
+
+[[maybe_unused]] static TinyLogger Log;
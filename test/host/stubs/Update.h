@@ -0,0 +1,101 @@
+#pragma once
+// Updater of the cores: writes are collected in a RAM buffer of one flash sector,
+// progress() counts only the bytes already written to flash
+#include <Arduino.h>
+#include <vector>
+
+#define U_FLASH 0
+#define U_SPIFFS 100
+#define U_FS U_SPIFFS
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+public:
+  static const size_t SECTOR_SIZE = 4096;
+
+  std::vector<uint8_t> flash;
+  std::vector<uint8_t> buffer;
+  bool running = false;
+  bool error = false;
+  unsigned int begins = 0;
+
+  bool begin(size_t, int = U_FLASH) {
+    this->flash.clear();
+    this->buffer.clear();
+    this->running = true;
+    this->error = false;
+    this->begins++;
+
+    return true;
+  }
+
+  bool setMD5(const char*) {
+    return true;
+  }
+
+  size_t write(const uint8_t* data, size_t length) {
+    if (!this->running) {
+      return 0;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+      this->buffer.push_back(data[i]);
+
+      if (this->buffer.size() == SECTOR_SIZE) {
+        this->flushBuffer();
+      }
+    }
+
+    return length;
+  }
+
+  bool end(bool evenIfRemaining = false) {
+    if (!this->running) {
+      return false;
+    }
+
+    this->running = false;
+    if (!evenIfRemaining) {
+      return false;
+    }
+
+    this->flushBuffer();
+    return !this->error;
+  }
+
+  void abort() {
+    this->running = false;
+  }
+
+  inline size_t progress() const {
+    return this->flash.size();
+  }
+
+  inline bool isRunning() const {
+    return this->running;
+  }
+
+  inline bool hasError() const {
+    return this->error;
+  }
+
+  inline void clearError() {
+    this->error = false;
+  }
+
+  inline const char* errorString() const {
+    return "error";
+  }
+
+  inline const char* getErrorString() const {
+    return "error";
+  }
+
+protected:
+  void flushBuffer() {
+    this->flash.insert(this->flash.end(), this->buffer.begin(), this->buffer.end());
+    this->buffer.clear();
+  }
+};
+
+static UpdateClass Update;
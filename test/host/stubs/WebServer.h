@@ -0,0 +1,133 @@
+#pragma once
+// Response side of the core WebServer, counts what a response costs on the socket
+#include <Arduino.h>
+#include <map>
+
+#ifndef CONTENT_LENGTH_UNKNOWN
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+#endif
+
+class WiFiClient {
+public:
+  inline bool connected() {
+    return true;
+  }
+};
+
+class WebServer {
+public:
+  size_t chunks = 0;
+  size_t bytes = 0;
+  std::string body;
+  bool keepBody = false;
+  String acceptEncoding;
+
+  void resetStats() {
+    this->chunks = 0;
+    this->bytes = 0;
+    this->body.clear();
+  }
+
+  String header(const char* name) {
+    return strcmp(name, "Accept-Encoding") == 0 ? this->acceptEncoding : emptyString;
+  }
+
+  void sendHeader(const char*, const char*, bool = false) {}
+  void setContentLength(size_t) {}
+
+  bool chunkedResponseModeStart(int, const char*) {
+    return true;
+  }
+
+  void chunkedResponseFinalize() {
+    this->chunks++;
+    this->bytes += 5;
+  }
+
+  void send(int, const char*, const String&) {}
+  void send(int, const char*, const char*) {}
+
+  // a chunk is the size line, the data and the trailer in one socket write
+  void sendContent(const char* content, size_t length) {
+    char header[12];
+    this->chunks++;
+    this->bytes += snprintf(header, sizeof(header), "%zx\r\n", length) + length + 2;
+
+    if (this->keepBody) {
+      this->body.append(content, length);
+    }
+  }
+
+  void sendContent(const String& content) {
+    this->sendContent(content.c_str(), content.length());
+  }
+
+  inline WiFiClient& client() {
+    return this->currentClient;
+  }
+
+  // query args of the current request
+  std::map<String, String> args;
+
+  bool hasArg(const String& name) {
+    return this->args.count(name) > 0;
+  }
+
+  String arg(const String& name) {
+    auto item = this->args.find(name);
+    return item != this->args.end() ? item->second : String();
+  }
+
+protected:
+  WiFiClient currentClient;
+};
+
+// request side, as much as the request handlers need
+enum HTTPMethod {
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_POST
+};
+
+enum HTTPUploadStatus {
+  UPLOAD_FILE_START,
+  UPLOAD_FILE_WRITE,
+  UPLOAD_FILE_END,
+  UPLOAD_FILE_ABORTED
+};
+
+struct HTTPUpload {
+  HTTPUploadStatus status;
+  String filename;
+  String name;
+  size_t totalSize = 0;
+  size_t currentSize = 0;
+  uint8_t buf[1436];
+};
+
+class RequestHandler {
+public:
+  virtual ~RequestHandler() = default;
+
+  virtual bool canHandle(WebServer&, HTTPMethod, const String&) {
+    return false;
+  }
+
+  virtual bool canHandle(HTTPMethod, const String&) {
+    return false;
+  }
+
+  virtual bool canUpload(WebServer&, const String&) {
+    return false;
+  }
+
+  virtual bool canUpload(const String&) {
+    return false;
+  }
+
+  virtual bool handle(WebServer&, HTTPMethod, const String&) {
+    return false;
+  }
+
+  virtual void upload(WebServer&, const String&, HTTPUpload&) {}
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+// lwIP default of the ESP32 core, the ESP8266 "higher bandwidth" variant uses 1460
+#ifndef TCP_MSS
+#define TCP_MSS 1436
+#endif
@@ -0,0 +1,179 @@
+// EquithermLearner on a simulated house: auto-apply must converge to a curve holding the target
+#include <Arduino.h>
+#include <EquithermLearner.h>
+#include <cassert>
+
+// TinyLogger is not built on the host
+#define DEFAULT_LOG_LEVEL 5
+#include "../../src/defines.h"
+
+struct Curve {
+  float slope;
+  float exponent;
+  float shift;
+  float targetDiffFactor;
+};
+
+// the float path of RegulatorTask::getEquithermCurveTemp()
+static float getCurveTemp(const Curve& curve, float target, float maxTemp, float outdoorTemp) {
+  const float range = maxTemp - target;
+  const float maxDelta = range / curve.slope;
+  if (range <= 0.0f || maxDelta <= 0.0f) {
+    return 0.0f;
+  }
+
+  const float delta = target - outdoorTemp;
+  const float result = range * powf(fabsf(delta) / maxDelta, 1.0f / curve.exponent);
+
+  return delta >= 0 ? result : -result;
+}
+
+/**
+ * Single zone house: heat capacity, losses to the outdoor air, radiators with the usual
+ * exponent 1.3 (200 W/K of losses, emitters sized for 41 K at 54 K of mean excess temp)
+ * and constant internal gains. The boiler flow follows the setpoint with a 10 minute lag.
+ */
+struct House {
+  static constexpr double losses = 200.0;
+  static constexpr double emitterExponent = 1.3;
+  static constexpr double capacity = 1.2e7;
+  const double emitter = losses * 41.0 / pow(54.0, emitterExponent);
+
+  double gains;
+  double indoorTemp = 21.0;
+  double flowTemp = 40.0;
+
+  House(double gains) : gains(gains) {}
+
+  void step(double setpointTemp, double outdoorTemp, double dt) {
+    this->flowTemp += (setpointTemp - this->flowTemp) * dt / 600.0;
+
+    const double output = this->flowTemp > this->indoorTemp
+      ? this->emitter * pow(this->flowTemp - this->indoorTemp, emitterExponent)
+      : 0.0;
+    this->indoorTemp += (output + this->gains - losses * (this->indoorTemp - outdoorTemp)) * dt / capacity;
+  }
+
+  // slope of the curve with the house exponent holding the target without gains
+  double getIdealSlope(float target, float maxTemp) const {
+    return pow(pow(losses / this->emitter, 1.0 / emitterExponent) / pow(maxTemp - target, 1.0 - 1.0 / emitterExponent), emitterExponent);
+  }
+};
+
+struct Result {
+  float firstWeekError;
+  float lastWeekError;
+  Curve curve;
+};
+
+static Result simulate(bool learning, const Curve& start, double gains, unsigned int days) {
+  Curve curve = start;
+  const float target = 21.0f;
+  const float minTemp = 20.0f;
+  const float maxTemp = 80.0f;
+  const unsigned int dt = 10;
+
+  House house(gains);
+  EquithermLearner learner;
+  learner.setWindow(EQUITHERM_LEARNING_WINDOW);
+  learner.reset(curve.slope, curve.shift, curve.exponent);
+
+  double firstWeekError = 0.0, lastWeekError = 0.0;
+  unsigned long firstWeekSamples = 0, lastWeekSamples = 0;
+
+  for (unsigned long time = 0; time < days * 86400ul; time += dt) {
+    hostMillis() = 1 + time * 1000ul;
+
+    // daily swing and a five day weather front
+    const double outdoorTemp = 4.0 * sin(2.0 * PI * time / 86400.0 - 2.0) + 8.0 * sin(2.0 * PI * time / (5.0 * 86400.0));
+    // sensor resolution
+    const float indoorTemp = roundf(static_cast<float>(house.indoorTemp) * 10.0f) / 10.0f;
+
+    float setpointTemp = target + curve.shift + getCurveTemp(curve, target, maxTemp, outdoorTemp)
+      + constrain(target - indoorTemp, -3.0f, 3.0f) * curve.targetDiffFactor;
+    setpointTemp = roundf(constrain(setpointTemp, minTemp, maxTemp));
+    house.step(setpointTemp, outdoorTemp, dt);
+
+    const double error = target - house.indoorTemp;
+    if (time < 7 * 86400ul) {
+      firstWeekError += error * error;
+      firstWeekSamples++;
+
+    } else if (time >= (days - 7) * 86400ul) {
+      lastWeekError += error * error;
+      lastWeekSamples++;
+    }
+
+    if (!learning) {
+      continue;
+    }
+
+    // as RegulatorTask::equithermLearning() with auto apply
+    if (setpointTemp <= minTemp || setpointTemp >= maxTemp) {
+      learner.invalidate();
+
+    } else if (learner.sample(target, maxTemp, outdoorTemp, setpointTemp, indoorTemp) && learner.getSamples() >= EQUITHERM_LEARNING_MIN_SAMPLES) {
+      const float slope = constrain(learner.getSlope(), EQUITHERM_LEARNING_MIN_SLOPE, EQUITHERM_LEARNING_MAX_SLOPE);
+      const float shift = constrain(learner.getShift(), -(EQUITHERM_LEARNING_MAX_SHIFT), EQUITHERM_LEARNING_MAX_SHIFT);
+
+      curve.slope += constrain(slope - curve.slope, -(EQUITHERM_LEARNING_SLOPE_STEP), EQUITHERM_LEARNING_SLOPE_STEP);
+      curve.shift += constrain(shift - curve.shift, -(EQUITHERM_LEARNING_SHIFT_STEP), EQUITHERM_LEARNING_SHIFT_STEP);
+    }
+  }
+
+  Result result;
+  result.firstWeekError = sqrt(firstWeekError / firstWeekSamples);
+  result.lastWeekError = sqrt(lastWeekError / lastWeekSamples);
+  result.curve = curve;
+
+  printf(
+    "%-8s start slope %.2f shift %5.1f, gains %3.0f W: rms error first week %.3f, last week %.3f, slope %.3f shift %5.2f\n",
+    learning ? "learning" : "fixed", start.slope, start.shift, gains,
+    result.firstWeekError, result.lastWeekError, result.curve.slope, result.curve.shift
+  );
+
+  return result;
+}
+
+int main() {
+  const unsigned int days = 40;
+  const House house(0.0);
+  const float idealSlope = house.getIdealSlope(21.0f, 80.0f);
+  printf("ideal slope without gains %.3f\n", idealSlope);
+
+  // a steep curve with a high shift
+  {
+    const Curve start{1.2f, 1.3f, 3.0f, 2.0f};
+    const Result fixed = simulate(false, start, 0.0, days);
+    const Result learned = simulate(true, start, 0.0, days);
+
+    assert(learned.lastWeekError < 0.1f);
+    assert(learned.lastWeekError < fixed.lastWeekError / 3.0f);
+    assert(fabsf(learned.curve.slope - idealSlope) < 0.1f * idealSlope);
+    assert(fabsf(learned.curve.shift) < 1.0f);
+  }
+
+  // a flat curve in a house with internal gains: the shift takes the gains
+  {
+    const Curve start{0.4f, 1.3f, -3.0f, 2.0f};
+    const Result fixed = simulate(false, start, 400.0, days);
+    const Result learned = simulate(true, start, 400.0, days);
+
+    assert(learned.lastWeekError < 0.1f);
+    assert(learned.lastWeekError < fixed.lastWeekError / 3.0f);
+    assert(fabsf(learned.curve.slope - idealSlope) < 0.1f * idealSlope);
+    assert(learned.curve.shift < 0.0f);
+  }
+
+  // a curve that is already close must stay close
+  {
+    const Curve start{idealSlope, 1.3f, 0.0f, 2.0f};
+    const Result learned = simulate(true, start, 0.0, days);
+
+    assert(learned.firstWeekError < 0.1f && learned.lastWeekError < 0.1f);
+    assert(fabsf(learned.curve.slope - idealSlope) < 0.1f * idealSlope);
+  }
+
+  printf("equitherm learner: ok\n");
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Q16.16 equitherm curve must match the float one within 0.05 °C, down to |delta| -> 0
+#include <Arduino.h>
+#include <FixedMath.h>
+#include <cassert>
+
+// both paths of RegulatorTask::getEquithermCurveTemp()
+static float getFloatCurveTemp(float maxTemp, float slope, float exponent, float target, float outdoorTemp) {
+  const float range = maxTemp - target;
+  const float maxDelta = range / slope;
+  if (range <= 0.0f || maxDelta <= 0.0f) {
+    return 0.0f;
+  }
+
+  const float delta = target - outdoorTemp;
+  const float result = range * powf(fabsf(delta) / maxDelta, 1.0f / exponent);
+
+  return delta >= 0 ? result : -result;
+}
+
+static float getFixedCurveTemp(float maxTemp, float slope, float exponent, float target, float outdoorTemp) {
+  const FixedMath::q16_t range = FixedMath::fromFloat(maxTemp - target);
+  const FixedMath::q16_t maxDelta = FixedMath::div(range, FixedMath::fromFloat(slope));
+  if (range <= 0 || maxDelta <= 0) {
+    return 0.0f;
+  }
+
+  const FixedMath::q16_t delta = FixedMath::fromFloat(target - outdoorTemp);
+  const FixedMath::q16_t result = FixedMath::mulPowRatio(
+    range,
+    delta >= 0 ? delta : -delta,
+    maxDelta,
+    FixedMath::div(FixedMath::ONE, FixedMath::fromFloat(exponent))
+  );
+
+  return FixedMath::toFloat(delta >= 0 ? result : -result);
+}
+
+int main() {
+  const float maxTemps[] = {50.0f, 60.0f, 80.0f, 90.0f};
+  const float slopes[] = {0.3f, 0.7f, 1.0f, 1.5f, 2.5f, 4.0f};
+  const float exponents[] = {0.8f, 1.0f, 1.3f, 1.6f, 1.9f, 2.0f};
+  const float targets[] = {16.0f, 20.0f, 22.5f, 28.0f};
+  const float deltas[] = {
+    0.0f, 0.0001f, 0.0005f, 0.001f, 0.002f, 0.005f, 0.01f, 0.02f, 0.05f, 0.1f, 0.2f, 0.5f,
+    1.0f, 2.0f, 3.7f, 5.0f, 10.0f, 15.0f, 20.0f, 25.0f, 30.0f, 40.0f, 50.0f, 60.0f
+  };
+
+  float maxError = 0.0f;
+  float maxSmallDeltaError = 0.0f;
+  unsigned long cases = 0;
+
+  for (float maxTemp : maxTemps) {
+    for (float slope : slopes) {
+      for (float exponent : exponents) {
+        for (float target : targets) {
+          for (float delta : deltas) {
+            for (float sign : {1.0f, -1.0f}) {
+              const float outdoorTemp = target - sign * delta;
+              const float expected = getFloatCurveTemp(maxTemp, slope, exponent, target, outdoorTemp);
+
+              // the regulator limits the result to the heating range anyway
+              if (fabsf(expected) > 100.0f) {
+                continue;
+              }
+
+              const float error = fabsf(getFixedCurveTemp(maxTemp, slope, exponent, target, outdoorTemp) - expected);
+              if (error >= 0.05f) {
+                printf(
+                  "max %.0f slope %.1f exponent %.1f target %.1f outdoor %.4f: %.4f != %.4f\n",
+                  maxTemp, slope, exponent, target, outdoorTemp,
+                  getFixedCurveTemp(maxTemp, slope, exponent, target, outdoorTemp), expected
+                );
+              }
+              assert(error < 0.05f);
+
+              maxError = max(maxError, error);
+              if (delta <= 0.05f) {
+                maxSmallDeltaError = max(maxSmallDeltaError, error);
+              }
+              cases++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // no curve at all
+  assert(getFixedCurveTemp(20.0f, 1.0f, 1.0f, 20.0f, 0.0f) == 0.0f);
+  assert(getFixedCurveTemp(90.0f, 1.0f, 1.0f, 20.0f, 20.0f) == 0.0f);
+
+  printf("equitherm curve: %lu cases, max error %.4f, at |delta| <= 0.05: %.4f\n", cases, maxError, maxSmallDeltaError);
+  printf("fixed math: ok\n");
+  return 0;
+}
@@ -0,0 +1,96 @@
+// GzipWriter output must inflate back to the input with zlib
+#include <Arduino.h>
+#include <GzipWriter.h>
+#include <zlib.h>
+#include <cassert>
+#include <string>
+#include <vector>
+#include "fixtures.h"
+
+struct Sink {
+  std::vector<uint8_t> data;
+
+  size_t write(uint8_t c) {
+    this->data.push_back(c);
+    return 1;
+  }
+};
+
+static std::vector<uint8_t> compress(const std::string& input) {
+  Sink sink;
+  GzipWriter<Sink> writer(&sink);
+  assert(writer.isValid());
+
+  writer.begin();
+  // uneven pieces, blocks must not depend on the write sizes
+  for (size_t pos = 0; pos < input.size(); pos += 7) {
+    const size_t length = min((size_t) 7, input.size() - pos);
+    writer.write((const uint8_t*) input.data() + pos, length);
+  }
+  writer.end();
+
+  return sink.data;
+}
+
+static std::string inflate(const std::vector<uint8_t>& input) {
+  z_stream stream = {};
+  // 16 + MAX_WBITS: gzip wrapper
+  assert(inflateInit2(&stream, 16 + MAX_WBITS) == Z_OK);
+
+  std::string result;
+  char buffer[1024];
+  stream.next_in = (Bytef*) input.data();
+  stream.avail_in = input.size();
+
+  int status;
+  do {
+    stream.next_out = (Bytef*) buffer;
+    stream.avail_out = sizeof(buffer);
+    status = ::inflate(&stream, Z_NO_FLUSH);
+    assert(status == Z_OK || status == Z_STREAM_END);
+    result.append(buffer, sizeof(buffer) - stream.avail_out);
+  } while (status != Z_STREAM_END);
+
+  // the trailer (crc and size) has been verified by zlib, nothing may follow it
+  assert(stream.avail_in == 0);
+  inflateEnd(&stream);
+
+  return result;
+}
+
+static void check(const char* name, const std::string& input) {
+  const std::vector<uint8_t> compressed = compress(input);
+  assert(inflate(compressed) == input);
+
+  printf("%-28s %6zu -> %6zu bytes (%.0f%%)\n", name, input.size(), compressed.size(), input.empty() ? 100.0 : 100.0 * compressed.size() / input.size());
+}
+
+int main() {
+  check("empty", "");
+  check("one byte", "x");
+  check("state json", STATE_JSON);
+  check("settings json", SETTINGS_JSON);
+
+  // matches across block boundaries and up to the window distance
+  std::string sensors = "[";
+  for (int i = 0; i < 60; i++) {
+    char item[160];
+    snprintf(item, sizeof(item), "%s{\"id\":%d,\"name\":\"Sensor %d\",\"purpose\":%d,\"connected\":true,\"signalQuality\":%d,\"value\":%.2f}", i ? "," : "", i, i, i % 5, 40 + i, 20.0 + i * 0.37);
+    sensors += item;
+  }
+  sensors += "]";
+  check("sensors list json", sensors);
+
+  check("long run", std::string(10000, 'a'));
+
+  std::string noise;
+  uint32_t seed = 1;
+  for (int i = 0; i < 5000; i++) {
+    seed = seed * 1103515245u + 12345u;
+    noise += (char) (seed >> 16);
+  }
+  check("incompressible", noise);
+
+  printf("ok\n");
+  return 0;
+}
@@ -0,0 +1,202 @@
+// Every historical Settings layout must migrate to the current one without losing a field
+#include <Arduino.h>
+#include <cassert>
+#include <vector>
+
+// TinyLogger is not built on the host
+#define DEFAULT_LOG_LEVEL 5
+#include "../../src/defines.h"
+
+// only what Settings.h needs from Sensors.h, the sensors are not part of Settings
+class Sensors {
+public:
+  enum class Type : uint8_t {
+    OT_OUTDOOR_TEMP, OT_HEATING_TEMP, OT_HEATING_RETURN_TEMP, OT_DHW_TEMP, OT_DHW_FLOW_RATE,
+    OT_EXHAUST_TEMP, OT_PRESSURE, OT_MODULATION_LEVEL, OT_CURRENT_POWER, DALLAS_TEMP, HEATING_SETPOINT_TEMP
+  };
+
+  enum class Purpose : uint8_t {
+    OUTDOOR_TEMP, INDOOR_TEMP, HEATING_TEMP, HEATING_RETURN_TEMP, DHW_TEMP, DHW_FLOW_RATE,
+    EXHAUST_TEMP, MODULATION_LEVEL, POWER, PRESSURE, TEMPERATURE
+  };
+
+  typedef struct {
+    bool enabled;
+    char name[33];
+    Purpose purpose;
+    Type type;
+    uint8_t gpio;
+  } Settings;
+};
+
+#include "../../src/Settings.h"
+#define SETTINGS_OFFSET(member) static_cast<uint16_t>(offsetof(Settings, member))
+#include "../../src/SettingsMigrations.h"
+
+struct Region {
+  uint16_t offset;
+  uint16_t length;
+};
+
+// fields added after v1, in the current layout, newest first
+static const Region addedFields[] = {
+  {SETTINGS_OFFSET(heating.schedule), 4},
+  {SETTINGS_OFFSET(heating.antiCycling), 4},
+  {SETTINGS_OFFSET(equitherm.learning), 4}
+};
+static const uint8_t addedFieldsAmount = sizeof(addedFields) / sizeof(*addedFields);
+
+// offset of an added field in the layout it was added to: without the fields added after it
+static uint16_t getInsertOffset(uint8_t index) {
+  uint16_t offset = addedFields[index].offset;
+  for (uint8_t i = 0; i < index; i++) {
+    if (addedFields[i].offset < addedFields[index].offset) {
+      offset -= addedFields[i].length;
+    }
+  }
+
+  return offset;
+}
+
+// settings as a user would have them: every byte differs from the defaults,
+// except the fields added later, which can only hold the defaults after a migration
+static std::vector<uint8_t> makeUserSettings() {
+  const uint8_t* defaults = reinterpret_cast<const uint8_t*>(&settings);
+  std::vector<uint8_t> result(defaults, defaults + sizeof(Settings));
+
+  for (size_t i = 0; i < SETTINGS_OFFSET(validationValue); i++) {
+    result[i] = static_cast<uint8_t>(defaults[i] ^ (0x5A + i * 31));
+  }
+
+  for (uint8_t i = 0; i < addedFieldsAmount; i++) {
+    memcpy(result.data() + addedFields[i].offset, defaults + addedFields[i].offset, addedFields[i].length);
+  }
+
+  return result;
+}
+
+// the layout of `version`: the current one without the fields added after it
+static std::vector<uint8_t> makeLayout(const std::vector<uint8_t>& current, uint16_t version) {
+  const uint8_t removed = version < 1 ? addedFieldsAmount : SETTINGS_VERSION - version;
+
+  std::vector<uint8_t> result;
+  for (size_t i = 0; i < current.size(); i++) {
+    bool skip = false;
+    for (uint8_t j = 0; j < removed; j++) {
+      skip |= i >= addedFields[j].offset && i < addedFields[j].offset + addedFields[j].length;
+    }
+
+    if (!skip) {
+      result.push_back(current[i]);
+    }
+  }
+
+  return result;
+}
+
+static void testLayout(const std::vector<uint8_t>& current, uint16_t version) {
+  const std::vector<uint8_t> layout = makeLayout(current, version);
+
+  uint8_t buffer[sizeof(Settings)];
+  uint16_t size = layout.size();
+  memcpy(buffer, layout.data(), size);
+
+  assert(migrateSettings(version, buffer, size, sizeof(buffer)));
+  assert(size == sizeof(Settings));
+  assert(memcmp(buffer, current.data(), size) == 0);
+
+  const Settings& migrated = *reinterpret_cast<const Settings*>(buffer);
+  const Settings& expected = *reinterpret_cast<const Settings*>(current.data());
+  assert(memcmp(migrated.system.ntp.server, expected.system.ntp.server, sizeof(expected.system.ntp.server)) == 0);
+  assert(memcmp(&migrated.heating.target, &expected.heating.target, sizeof(expected.heating.target)) == 0);
+  assert(memcmp(&migrated.equitherm, &expected.equitherm, sizeof(expected.equitherm)) == 0);
+  assert(memcmp(&migrated.cascadeControl, &expected.cascadeControl, sizeof(expected.cascadeControl)) == 0);
+  assert(memcmp(&migrated.heating.schedule, &settings.heating.schedule, sizeof(settings.heating.schedule)) == 0);
+  assert(strncmp(migrated.validationValue, SETTINGS_VALID_VALUE, sizeof(migrated.validationValue)) == 0);
+
+  printf("v%u: %zu -> %u bytes\n", version, layout.size(), size);
+}
+
+// v0 of ScheduleSettings had the blocks first, with any SCHEDULE_MAX_BLOCKS
+static void testScheduleLayout(uint8_t blocksAmount) {
+  ScheduleSettings expected;
+  expected.heatUp.base = 1.25f;
+  expected.heatUp.loss = 0.045f;
+  expected.heatUp.samples = 17;
+  for (uint8_t i = 0; i < SCHEDULE_MAX_BLOCKS; i++) {
+    expected.blocks[i] = {i % 2 == 0, static_cast<uint8_t>(i + 1), static_cast<uint16_t>(i * 60), 18.0f + i};
+  }
+
+  const uint16_t blocksSize = blocksAmount * sizeof(ScheduleSettings::Block);
+  uint8_t buffer[sizeof(ScheduleSettings) + 16 * sizeof(ScheduleSettings::Block)] = {};
+  uint16_t size = blocksSize + sizeof(expected.heatUp);
+  memcpy(buffer, expected.blocks, min<size_t>(blocksSize, sizeof(expected.blocks)));
+  memcpy(buffer + blocksSize, &expected.heatUp, sizeof(expected.heatUp));
+
+  assert(migrateScheduleSettings(0, buffer, size, sizeof(buffer)));
+  assert(size == blocksSize + sizeof(expected.heatUp));
+
+  // as JournalData: the blocks beyond the loaded ones keep their defaults
+  ScheduleSettings migrated;
+  memcpy(&migrated, buffer, min<size_t>(size, sizeof(migrated)));
+  assert(memcmp(&migrated.heatUp, &expected.heatUp, sizeof(expected.heatUp)) == 0);
+  for (uint8_t i = 0; i < SCHEDULE_MAX_BLOCKS; i++) {
+    const ScheduleSettings::Block& block = i < blocksAmount ? expected.blocks[i] : ScheduleSettings::Block();
+    assert(migrated.blocks[i].enabled == block.enabled && migrated.blocks[i].days == block.days);
+    assert(migrated.blocks[i].start == block.start && migrated.blocks[i].target == block.target);
+  }
+
+  printf("schedule v0, %u blocks: %u bytes\n", blocksAmount, size);
+}
+
+int main() {
+  const std::vector<uint8_t> current = makeUserSettings();
+
+  // the frozen offsets of SettingsMigrations.h must match the layouts rebuilt from the current struct
+  const std::vector<uint8_t> v1 = makeLayout(current, 1);
+  assert(v1.size() == 552);
+  assert(strncmp(reinterpret_cast<const char*>(v1.data() + 544), SETTINGS_VALID_VALUE, sizeof(Settings::validationValue)) == 0);
+  assert(getInsertOffset(2) == 512);
+  assert(getInsertOffset(1) == 428);
+  assert(getInsertOffset(0) == 432);
+
+  for (uint16_t version = 0; version <= SETTINGS_VERSION; version++) {
+    testLayout(current, version);
+  }
+
+  // FileData has no version, a file of another size is not a v0 layout
+  {
+    std::vector<uint8_t> layout = makeLayout(current, 0);
+    uint8_t buffer[sizeof(Settings)];
+    uint16_t size = layout.size() - 4;
+    memcpy(buffer, layout.data(), size);
+    assert(!migrateSettings(0, buffer, size, sizeof(buffer)));
+  }
+
+  // no room for the new fields
+  {
+    std::vector<uint8_t> layout = makeLayout(current, 1);
+    uint8_t buffer[sizeof(Settings)];
+    uint16_t size = layout.size();
+    memcpy(buffer, layout.data(), size);
+    assert(!migrateSettings(1, buffer, size, size + 4));
+  }
+
+  // the frozen sizes of migrateScheduleSettingsFrom0()
+  static_assert(sizeof(ScheduleSettings::Block) == 8, "schedule block layout");
+  static_assert(sizeof(ScheduleSettings::heatUp) == 12, "schedule heatUp layout");
+  static_assert(offsetof(ScheduleSettings, blocks) == 12, "schedule blocks must follow heatUp");
+
+  testScheduleLayout(SCHEDULE_MAX_BLOCKS);
+  testScheduleLayout(SCHEDULE_MAX_BLOCKS / 2);
+  testScheduleLayout(SCHEDULE_MAX_BLOCKS + 4);
+
+  {
+    uint8_t buffer[sizeof(ScheduleSettings)] = {};
+    uint16_t size = sizeof(ScheduleSettings::heatUp) + 3;
+    assert(!migrateScheduleSettings(0, buffer, size, sizeof(buffer)));
+  }
+
+  printf("settings migrations: ok\n");
+  return 0;
+}
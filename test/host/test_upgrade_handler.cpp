@@ -0,0 +1,120 @@
+// UpgradeHandler: an upload aborted in the middle of a flash sector must resume into an intact image
+#define ARDUINO_ARCH_ESP32
+#include <Arduino.h>
+#include <WebServer.h>
+#include <Update.h>
+#include <TinyLogger.h>
+#include <cassert>
+#include <vector>
+
+const char L_PORTAL_OTA[] PROGMEM = "PORTAL.OTA";
+#include <UpgradeHandler.h>
+
+static String toHex(const uint8_t* data, size_t length) {
+  String result;
+  char hex[3];
+  for (size_t i = 0; i < length; i++) {
+    snprintf(hex, sizeof(hex), "%02x", data[i]);
+    result += hex;
+  }
+
+  return result;
+}
+
+static String sha256(const std::vector<uint8_t>& data) {
+  Sha256 hash;
+  hash.begin();
+  hash.update(data.data(), data.size());
+
+  uint8_t result[Sha256::HASH_SIZE];
+  hash.end(result);
+
+  return toHex(result, sizeof(result));
+}
+
+// one request: start, the chunks of [from, to), then end or abort
+static void sendUpload(UpgradeHandler& handler, WebServer& server, const std::vector<uint8_t>& image, size_t from, size_t to, bool abort) {
+  HTTPUpload upload;
+  upload.name = "firmware";
+  upload.filename = "firmware.bin";
+
+  upload.status = UPLOAD_FILE_START;
+  handler.upload(server, "/api/upgrade", upload);
+
+  for (size_t pos = from; pos < to; pos += upload.currentSize) {
+    upload.status = UPLOAD_FILE_WRITE;
+    upload.currentSize = min(sizeof(upload.buf), to - pos);
+    upload.totalSize += upload.currentSize;
+    memcpy(upload.buf, image.data() + pos, upload.currentSize);
+    handler.upload(server, "/api/upgrade", upload);
+  }
+
+  upload.status = abort ? UPLOAD_FILE_ABORTED : UPLOAD_FILE_END;
+  handler.upload(server, "/api/upgrade", upload);
+}
+
+int main() {
+  {
+    // "abc", FIPS 180-2
+    const std::vector<uint8_t> abc = {'a', 'b', 'c'};
+    assert(sha256(abc).equals("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+  }
+
+  std::vector<uint8_t> image(20000);
+  uint32_t seed = 1;
+  for (auto& value : image) {
+    seed = seed * 1103515245 + 12345;
+    value = seed >> 16;
+  }
+
+  UpgradeHandler::UpgradeResult lastResult{};
+  UpgradeHandler handler("/api/upgrade");
+  handler.setAfterUpgradeCallback([&lastResult](const UpgradeHandler::UpgradeResult& fwResult, const UpgradeHandler::UpgradeResult&) {
+    lastResult = fwResult;
+  });
+
+  WebServer server;
+  server.args[String("firmware_sha256")] = sha256(image);
+
+  // 5 chunks: one sector is on flash, the rest is still buffered by Update
+  const size_t abortedAt = 5 * sizeof(HTTPUpload::buf);
+  sendUpload(handler, server, image, 0, abortedAt, true);
+  assert(Update.isRunning());
+  assert(Update.progress() == UpdateClass::SECTOR_SIZE);
+  assert(handler.getProgress().running);
+  assert(handler.getProgress().written == abortedAt);
+  printf("aborted at %zu bytes, %zu on flash\n", abortedAt, Update.progress());
+
+  server.args[String("firmware_offset")] = String(std::to_string(abortedAt).c_str());
+  sendUpload(handler, server, image, abortedAt, image.size(), false);
+  handler.handle(server, HTTP_POST, "/api/upgrade");
+
+  assert(lastResult.status == UpgradeHandler::UpgradeStatus::SUCCESS);
+  assert(lastResult.written == image.size());
+  assert(Update.begins == 1);
+  assert(Update.flash == image);
+  printf("resumed from %zu bytes: %zu bytes, sha256 verified\n", abortedAt, Update.flash.size());
+
+  // an offset that does not match the accepted bytes closes the session
+  server.args.erase(String("firmware_offset"));
+  sendUpload(handler, server, image, 0, abortedAt, true);
+  server.args[String("firmware_offset")] = String(std::to_string(Update.progress()).c_str());
+  sendUpload(handler, server, image, Update.progress(), image.size(), false);
+  handler.handle(server, HTTP_POST, "/api/upgrade");
+
+  assert(lastResult.status == UpgradeHandler::UpgradeStatus::ERROR_ON_START);
+  assert(!Update.isRunning());
+  assert(!handler.getProgress().running && handler.getProgress().written == 0);
+
+  // an aborted session is closed once the resume timeout has passed
+  server.args.erase(String("firmware_offset"));
+  sendUpload(handler, server, image, 0, abortedAt, true);
+  hostMillis() += 1000;
+  assert(!handler.expireAborted(60000));
+  hostMillis() += 60000;
+  assert(handler.expireAborted(60000));
+  assert(!Update.isRunning());
+
+  printf("upgrade handler: ok\n");
+  return 0;
+}